@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include <mpi.h>
+
+#include "mpicxx/mpicxx.h"
+
+auto comm = mpi::communicator::get_default();
+
+// Prevents the compiler from optimizing away a value computed in a benchmark loop
+template<typename T>
+inline void do_not_optimize(T const& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Average time per call in nanoseconds, taking the slowest rank
+template<typename F>
+double time_per_call(std::size_t iterations, F&& f) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    const auto start = std::chrono::steady_clock::now();
+    for(std::size_t i=0; i<iterations; ++i) {
+        f();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    double local = std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(iterations);
+    double global;
+    MPI_Allreduce(&local, &global, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return global;
+}
+
+// Runs both versions alternately and keeps the best time of each, to filter out noise
+template<typename Raw, typename Wrapped>
+void compare(std::string_view name, std::size_t iterations, Raw&& raw, Wrapped&& wrapped) {
+    constexpr int repetitions = 5;
+    double raw_time = std::numeric_limits<double>::max();
+    double wrapped_time = std::numeric_limits<double>::max();
+
+    for(int i=0; i<repetitions; ++i) {
+        raw_time = std::min(raw_time, time_per_call(iterations, raw));
+        wrapped_time = std::min(wrapped_time, time_per_call(iterations, wrapped));
+    }
+
+    if(comm.rank() == 0) {
+        std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << raw_time
+                  << std::setw(12) << wrapped_time
+                  << std::setw(12) << wrapped_time - raw_time << "\n";
+    }
+}
+
+int main() {
+    if(comm.rank() == 0) {
+        std::cout << "Time per call in nanoseconds with " << comm.size() << " ranks\n"
+                  << std::left << std::setw(20) << "operation" << std::right
+                  << std::setw(12) << "raw MPI" << std::setw(12) << "wrapper" << std::setw(12) << "overhead" << "\n";
+    }
+
+    compare("rank", 1'000'000,
+        []() { int r; MPI_Comm_rank(MPI_COMM_WORLD, &r); do_not_optimize(r); },
+        []() { do_not_optimize(comm.rank()); });
+
+    compare("size", 1'000'000,
+        []() { int s; MPI_Comm_size(MPI_COMM_WORLD, &s); do_not_optimize(s); },
+        []() { do_not_optimize(comm.size()); });
+
+    compare("barrier", 10'000,
+        []() { MPI_Barrier(MPI_COMM_WORLD); },
+        []() { comm.barrier(); });
+
+    int value = 0;
+    compare("broadcast int", 10'000,
+        [&]() { MPI_Bcast(&value, 1, MPI_INT, 0, MPI_COMM_WORLD); },
+        [&]() { comm.broadcast(0, value); });
+
+    std::vector<double> data(1024, 1.0);
+    compare("broadcast vector", 10'000,
+        [&]() { MPI_Bcast(data.data(), static_cast<int>(data.size()), MPI_DOUBLE, 0, MPI_COMM_WORLD); },
+        [&]() { comm.broadcast(0, data); });
+
+    double sum = 0;
+    compare("allreduce double", 10'000,
+        [&]() { double x = 1.0; MPI_Allreduce(&x, &sum, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD); },
+        [&]() { comm.allreduce(1.0, sum, std::plus<double>{}); });
+
+    compare("allreduce in place", 10'000,
+        [&]() { MPI_Allreduce(MPI_IN_PLACE, data.data(), static_cast<int>(data.size()), MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD); },
+        [&]() { comm.allreduce(data, mpi::max<double>{}); });
+
+    if(comm.size() < 2) {
+        return 0;
+    }
+
+    // Ping-pong between the first and last rank
+    const int last = comm.size() - 1;
+    auto raw_pingpong = [&]() {
+        if(comm.rank() == 0) {
+            MPI_Send(&value, 1, MPI_INT, last, 0, MPI_COMM_WORLD);
+            MPI_Recv(&value, 1, MPI_INT, last, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        } else if(comm.rank() == last) {
+            MPI_Recv(&value, 1, MPI_INT, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+            MPI_Send(&value, 1, MPI_INT, 0, 0, MPI_COMM_WORLD);
+        }
+    };
+    auto wrapped_pingpong = [&]() {
+        mpi::status status;
+        if(comm.rank() == 0) {
+            comm.send(last, 0, value);
+            comm.recv(last, 0, value, status);
+        } else if(comm.rank() == last) {
+            comm.recv(0, 0, value, status);
+            comm.send(0, 0, value);
+        }
+    };
+    compare("ping-pong int", 10'000, raw_pingpong, wrapped_pingpong);
+
+    // Same exchange with requests that are set up once, to compare against the line above
+    const bool in_pingpong = comm.rank() == 0 || comm.rank() == last;
+    const int peer = comm.rank() == 0 ? last : 0;
+    MPI_Request raw_send, raw_recv;
+    mpi::persistent_request wrapped_send, wrapped_recv;
+    if(in_pingpong) {
+        MPI_Send_init(&value, 1, MPI_INT, peer, 1, MPI_COMM_WORLD, &raw_send);
+        MPI_Recv_init(&value, 1, MPI_INT, peer, 1, MPI_COMM_WORLD, &raw_recv);
+        wrapped_send = comm.send_init(peer, 1, value);
+        wrapped_recv = comm.recv_init(peer, 1, value);
+    }
+
+    auto raw_persistent = [&]() {
+        if(comm.rank() == 0) {
+            MPI_Start(&raw_send);
+            MPI_Wait(&raw_send, MPI_STATUS_IGNORE);
+            MPI_Start(&raw_recv);
+            MPI_Wait(&raw_recv, MPI_STATUS_IGNORE);
+        } else if(comm.rank() == last) {
+            MPI_Start(&raw_recv);
+            MPI_Wait(&raw_recv, MPI_STATUS_IGNORE);
+            MPI_Start(&raw_send);
+            MPI_Wait(&raw_send, MPI_STATUS_IGNORE);
+        }
+    };
+    auto wrapped_persistent = [&]() {
+        if(comm.rank() == 0) {
+            wrapped_send.start();
+            wrapped_send.wait();
+            wrapped_recv.start();
+            wrapped_recv.wait();
+        } else if(comm.rank() == last) {
+            wrapped_recv.start();
+            wrapped_recv.wait();
+            wrapped_send.start();
+            wrapped_send.wait();
+        }
+    };
+    compare("persistent ping-pong", 10'000, raw_persistent, wrapped_persistent);
+
+    if(in_pingpong) {
+        MPI_Request_free(&raw_send);
+        MPI_Request_free(&raw_recv);
+    }
+}
@@ -3,6 +3,9 @@
 # Settings
 export MPI_ENABLED=${MPI_ENABLED:-"false"}
 export BUILD_TYPE=${BUILD_TYPE:-Release}
+export MPI_THREADING=${MPI_THREADING:-single}
+export MPI_PROFILE=${MPI_PROFILE:-false}
+export MPI_TRACE=${MPI_TRACE:-false}
 
 # Chosing compiler
 if [ ${MPI_ENABLED} = "true" ]; then
@@ -19,6 +22,9 @@ cmake                                   \
     -DPROJECT_ROOT=`pwd`                \
     -B"build/${BUILD_TYPE}"             \
     -DMPI_ENABLED=$MPI_ENABLED          \
+    -DMPI_THREADING=$MPI_THREADING      \
+    -DMPI_PROFILE=$MPI_PROFILE          \
+    -DMPI_TRACE=$MPI_TRACE              \
     -DCC=${CC}                          \
     -DCXX=${CXX}
 
@@ -29,6 +29,14 @@ std::size_t distributed_canvas::local_col(std::size_t g_col) const noexcept {
     return g_col - colsbegin;
 }
 
+mpi::id_type distributed_canvas::owner(std::size_t g_row) const noexcept {
+    return static_cast<mpi::id_type>(g_row / local_height());
+}
+
+std::size_t distributed_canvas::flat_index(std::size_t g_row, std::size_t g_col) const noexcept {
+    return (g_row % local_height()) * local_width() + local_col(g_col);
+}
+
 std::size_t distributed_canvas::global_width() const noexcept {
     return width_;
 }
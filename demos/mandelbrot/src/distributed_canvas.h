@@ -25,6 +25,12 @@ public:
     // Converts a global column index into its local index
     std::size_t local_col(std::size_t g_col) const noexcept;
 
+    // Rank in charge of a global row
+    mpi::id_type owner(std::size_t g_row) const noexcept;
+
+    // Position of a pixel in the flat view of the rank in charge of it
+    std::size_t flat_index(std::size_t g_row, std::size_t g_col) const noexcept;
+
     // Returs the width of the whole canvas
     std::size_t global_width() const noexcept;
 
@@ -85,6 +85,7 @@ void netbpm_writer::ppm_body_impl(std::string(*colorizer)(colormap const&, unsig
 
     // Stringifying
     std::string data = [this, colorizer, &cmap]() {
+        const mpi::trace_region region("colorize");
         std::stringstream data;
         auto view = canvas.flat_view();
         std::transform(view.begin(), view.end(), std::ostream_iterator<std::string>(data),
@@ -95,34 +96,33 @@ void netbpm_writer::ppm_body_impl(std::string(*colorizer)(colormap const&, unsig
     }();
     logline(config, true, "Rank ", comm.rank(), " is done computing");
    
-    // Some memory accounting
-    constexpr mpi::size_type root = 0;
-    std::size_t buffer_size = data.size();
-    std::vector<std::size_t> all_sizes(static_cast<std::size_t>(comm.size()), 0u);
-    comm.gather(root, buffer_size, all_sizes);
+    // Gathering all data at rank 0, which writes its own rows while the others' are still arriving
+    constexpr mpi::id_type root = 0;
+    std::string own_rows;
+    if(comm.rank() == root) {
+        own_rows.swap(data);
+    }
+    std::string image;
+    auto arrival = comm.igatherv(root, data, image);
 
-    // Sending data to rank 0
     if(comm.rank() != root) {
-        comm.send(root, comm.rank(), data);
+        arrival.wait();
         return;
     }
 
-    // Recieving data at rank 0
     auto file = file_handle();
-    file << data;
-    logline(config, true, "Rank 0: data written");
-    for (auto rank: std::ranges::iota_view<int, int>{1, comm.size()})
     {
-        mpi::status s;
-        data.clear();
-        data.resize(all_sizes[static_cast<std::size_t>(rank)]);
-        comm.recv(rank, rank, data, s);
-        file << data;
-        logline(config, true, "Rank ", rank, ": data recieved and written");
+        const mpi::trace_region region("write");
+        file << own_rows;
+    }
+    arrival.wait();
+    {
+        const mpi::trace_region region("write");
+        file << image;
     }
+    logline(config, true, "Rank 0: data recieved and written");
 }
 
-
 ini_reader::ini_reader(std::filesystem::path path) : path{path}
 {
 }
@@ -26,7 +26,10 @@ int main(int argc, char** argv) {
     distributed_canvas canvas(config.img_width, config.img_height, comm);
     logline(config, true, "Rank ", comm.rank(), " is in charge of rows ", canvas.rows().front(), " until ", canvas.rows().back());
     
-    update_image(config, canvas);
+    {
+        const mpi::trace_region region("compute");
+        update_image(config, canvas);
+    }
     comm.barrier();
     netbpm_writer{canvas, config}.write();
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include <algorithm>
 #include <numeric>
+#include <ranges>
 #include <execution>
 #include <utility>
+#include <vector>
 
 #include "maths.h"
 
@@ -69,36 +71,70 @@ auto subsampling(settings const& config) {
 }
 
 
+// Copies a range of indices, as std::ranges::iota_view::iterator is not a forward iterator
+std::vector<std::size_t> to_vector(std::ranges::iota_view<std::size_t, std::size_t> range) {
+    std::vector<std::size_t> indices(range.size());
+    std::ranges::copy(range, indices.begin());
+    return indices;
+}
+
 void update_image(settings const& config, distributed_canvas& canvas) {
-    // This wouldn't be necessary if std::ranges::iota_view::iterator was a forward iterator :(
-    auto rows = std::vector<std::size_t>(canvas.rows().begin(), canvas.rows().end());
-    auto cols = std::vector<std::size_t>(canvas.cols().begin(), canvas.cols().end());
+    auto comm = canvas.communicator();
+    const auto cols = to_vector(canvas.cols());
 
     std::complex<double> top_left;
     top_left.real(config.center.real() - config.span.real() / 2.0);
     top_left.imag(config.center.imag() + config.span.imag() / 2.0);
 
     const auto [abcissae, weights] = subsampling(config);
-    
-    std::for_each(std::execution::par_unseq, rows.begin(), rows.end(), 
-      [&](std::size_t row) {
-
-        const double progress = static_cast<double>(row) / static_cast<double>(canvas.global_height());
-        const double imag = top_left.imag() - progress * config.span.imag();
-
-        std::for_each(std::execution::unseq, cols.begin(), cols.end(),
-          [&] (std::size_t col) {
-            const double progress = static_cast<double>(col) / static_cast<double>(canvas.global_width());
-            const double real = top_left.real() + progress * config.span.real();
-            
-            std::complex<double> c {real, imag};
-            const double value =
-            std::transform_reduce(std::execution::unseq, abcissae.begin(), abcissae.end(), weights.begin(), double{0},
-                std::plus<double>{},
-                [&](std::complex<double> const& sample, double weight) -> double {
-                    return weight * mandelbrot_escape_time(c + sample, config.max_iter);
-                });
-            canvas.get(row, col) = static_cast<unsigned>(value);
+
+    // Rows inside the set take far longer than the rest, so instead of computing its own block of the canvas,
+    // each rank claims rows until there are none left, and writes them into the rank in charge of them.
+    constexpr std::size_t chunks_per_rank = 16;
+    const auto ranks = static_cast<std::size_t>(comm.size());
+    const std::size_t total_rows = canvas.local_height() * ranks;
+    const std::size_t chunk = std::max(std::size_t{1}, total_rows / (ranks * chunks_per_rank));
+
+    mpi::window<unsigned> pixels(comm, canvas.flat_view());
+    mpi::distributed_work_queue queue(comm, total_rows, chunk, mpi::claim_order::local_first);
+    auto epoch = pixels.lock_all();
+
+    for(auto claimed = queue.claim(); !claimed.empty(); claimed = queue.claim()) {
+        const auto rows = to_vector(claimed);
+
+        // Pooled lines are reused from one chunk to the next, and are not zeroed as every pixel is overwritten
+        std::vector<mpi::buffer<unsigned>> buffer(rows.size());
+        for(auto& line: buffer) {
+            line.resize(canvas.local_width());
+        }
+
+        std::for_each(std::execution::par_unseq, rows.begin(), rows.end(),
+          [&](std::size_t row) {
+
+            const double progress = static_cast<double>(row) / static_cast<double>(canvas.global_height());
+            const double imag = top_left.imag() - progress * config.span.imag();
+            auto& line = buffer[row - rows.front()];
+
+            std::for_each(std::execution::unseq, cols.begin(), cols.end(),
+              [&] (std::size_t col) {
+                const double progress = static_cast<double>(col) / static_cast<double>(canvas.global_width());
+                const double real = top_left.real() + progress * config.span.real();
+
+                std::complex<double> c {real, imag};
+                const double value =
+                std::transform_reduce(std::execution::unseq, abcissae.begin(), abcissae.end(), weights.begin(), double{0},
+                    std::plus<double>{},
+                    [&](std::complex<double> const& sample, double weight) -> double {
+                        return weight * mandelbrot_escape_time(c + sample, config.max_iter);
+                    });
+                line[canvas.local_col(col)] = static_cast<unsigned>(value);
+            });
         });
-    });
+
+        for(std::size_t i=0; i < rows.size(); ++i) {
+            pixels.put(buffer[i], canvas.owner(rows[i]), static_cast<mpi::size_type>(canvas.flat_index(rows[i], 0)));
+        }
+        // The buffer must outlive the transfers
+        pixels.flush_all();
+    }
 }
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "defines.h"
+#include "allocator.h"
+#include "communicator.h"
+#include "environment.h"
+#include "request.h"
+#include "types.h"
+
+namespace mpi {
+
+// Records that an aggregator packs byte by byte
+template<typename T>
+concept PackableType = MappedType<T> && std::is_trivially_copyable_v<T>;
+
+// Coalesces many small records into one message per destination. Records are appended to a slab for their
+// destination, which is sent once it is full, once it is older than the timeout, or when flushed. On the receiving
+// side, each record is handed to the handler registered for its tag.
+//
+// Records travel on a duplicate of the communicator, so they never match other messages. Construction and finish
+// are collective.
+template<Os OS, bool MpiEnabled>
+class basic_aggregator {
+  public:
+    using communicator = basic_communicator<OS, MpiEnabled>;
+    using request = basic_request<OS, MpiEnabled>;
+    using status = basic_status<OS, MpiEnabled>;
+    using environment = basic_environment<OS, MpiEnabled>;
+    using id_type = typename communicator::id_type;
+    using tag_type = typename communicator::tag_type;
+    using clock = std::chrono::steady_clock;
+    using slab = std::vector<unsigned char, basic_allocator<OS, MpiEnabled, unsigned char>>;
+
+    static constexpr std::size_t default_slab_size = 8 * 1024;
+
+    basic_aggregator(communicator const& comm, std::size_t slab_size = default_slab_size,
+                     clock::duration timeout = std::chrono::milliseconds(1))
+        : comm(comm.dup())
+        , slab_size(slab_size)
+        , timeout(timeout)
+        , slabs(static_cast<std::size_t>(this->comm.size()))
+        , first_record(slabs.size())
+        , sent(slabs.size(), 0)
+        , recieved(slabs.size(), 0)
+    {
+        for(auto& s: slabs) {
+            s.reserve(slab_size);
+        }
+    }
+
+    basic_aggregator(basic_aggregator const&) = delete;
+    basic_aggregator& operator=(basic_aggregator const&) = delete;
+
+    // Registers the handler for the records sent with this tag, called as handler(source, record)
+    template<PackableType T, std::invocable<id_type, T const&> F>
+    void on(tag_type tag, F handler) {
+        handlers[tag] = {sizeof(T), [handler = std::move(handler)](id_type source, unsigned char const* bytes) mutable {
+            T record;
+            std::memcpy(&record, bytes, sizeof(T));
+            handler(source, static_cast<T const&>(record));
+        }};
+    }
+
+    // Appends the record to the slab of the destination. The slab is sent first if the record does not fit.
+    template<PackableType T>
+    void send(id_type destination, tag_type tag, T const& record) {
+        constexpr std::size_t bytes = sizeof(tag_type) + sizeof(T);
+        assert(bytes <= slab_size);
+        assert(destination >= 0 && destination < comm.size());
+
+        const auto d = static_cast<std::size_t>(destination);
+        if(slabs[d].size() + bytes > slab_size) {
+            flush(destination);
+        }
+
+        auto& s = slabs[d];
+        if(s.empty()) {
+            first_record[d] = clock::now();
+        }
+        const auto offset = s.size();
+        s.resize(offset + bytes);
+        std::memcpy(s.data() + offset, &tag, sizeof(tag_type));
+        std::memcpy(s.data() + offset + sizeof(tag_type), &record, sizeof(T));
+    }
+
+    // Sends the slab of the destination, even if it is not full. Records for this same rank are handled right away.
+    void flush(id_type destination) {
+        const auto d = static_cast<std::size_t>(destination);
+        if(slabs[d].empty()) {
+            return;
+        }
+
+        // Handlers may send more records, so the slab is replaced before they run
+        slab full = std::exchange(slabs[d], take_slab());
+        if(destination == comm.rank()) {
+            unpack(destination, full);
+            recycle(std::move(full));
+            return;
+        }
+
+        in_flight.push_back(comm.isend(destination, slab_tag, full));
+        in_flight_slabs.push_back(std::move(full));
+        ++sent[d];
+        ++messages;
+    }
+
+    // Sends every slab that holds records
+    void flush() {
+        for(id_type destination = 0; destination < comm.size(); ++destination) {
+            flush(destination);
+        }
+    }
+
+    // Handles the slabs that have arrived, and sends those that have waited longer than the timeout.
+    // Must be called regularly, as nothing progresses in between.
+    void poll() {
+        while(auto arrived = comm.template iprobe<unsigned char>(communicator::any_source, slab_tag)) {
+            recieve(arrived->source);
+        }
+
+        const auto now = clock::now();
+        for(id_type destination = 0; destination < comm.size(); ++destination) {
+            const auto d = static_cast<std::size_t>(destination);
+            if(!slabs[d].empty() && now - first_record[d] >= timeout) {
+                flush(destination);
+            }
+        }
+
+        reclaim_sent();
+    }
+
+    // Flushes every slab, and handles every record sent to this rank before returning, including those that the
+    // handlers send in turn. Collective.
+    void finish() {
+        while(true) {
+            flush();
+
+            // Every rank learns how many slabs are on their way to it
+            const std::vector<unsigned long long> announced = sent;
+            std::vector<unsigned long long> expected;
+            comm.alltoall(announced, expected);
+            for(id_type source = 0; source < comm.size(); ++source) {
+                const auto s = static_cast<std::size_t>(source);
+                while(recieved[s] < expected[s]) {
+                    recieve(source);
+                }
+            }
+
+            // Handlers may have filled and sent slabs meanwhile, which are announced in the next round
+            for(std::size_t r=0; r < sent.size(); ++r) {
+                sent[r] -= announced[r];
+                recieved[r] -= expected[r];
+            }
+
+            int more = std::any_of(slabs.begin(), slabs.end(), [](slab const& s) { return !s.empty(); })
+                    || std::any_of(sent.begin(), sent.end(), [](unsigned long long n) { return n > 0; });
+            int any_more;
+            comm.allreduce(more, any_more, std::plus<int>{});
+            if(any_more == 0) {
+                break;
+            }
+        }
+
+        request::wait_all(in_flight);
+        reclaim_sent();
+    }
+
+    // Number of messages sent since construction, where each message carries a whole slab
+    [[nodiscard]]
+    std::size_t messages_sent() const noexcept {
+        return messages;
+    }
+
+  private:
+    static constexpr tag_type slab_tag = 0;
+
+    struct handler {
+        std::size_t size;
+        std::function<void(id_type, unsigned char const*)> unpack;
+    };
+
+    communicator comm;
+    std::size_t slab_size;
+    clock::duration timeout;
+
+    std::vector<slab> slabs;
+    std::vector<clock::time_point> first_record;
+    std::unordered_map<tag_type, handler> handlers;
+
+    // Sent slabs are kept alive until their request completes, and then reused. The slabs are declared first, so
+    // that the requests wait for the sends to complete before the slabs are freed.
+    std::vector<slab> in_flight_slabs;
+    std::vector<request> in_flight;
+    std::vector<slab> spare;
+
+    // Slabs sent to and recieved from each rank that the last finish has not accounted for
+    std::vector<unsigned long long> sent;
+    std::vector<unsigned long long> recieved;
+    slab incoming;
+    std::size_t messages = 0;
+
+    [[nodiscard]]
+    slab take_slab() {
+        if(spare.empty()) {
+            slab s;
+            s.reserve(slab_size);
+            return s;
+        }
+        slab s = std::move(spare.back());
+        spare.pop_back();
+        return s;
+    }
+
+    void recycle(slab s) {
+        s.clear();
+        spare.push_back(std::move(s));
+    }
+
+    void recieve(id_type source) {
+        status s;
+        comm.recv(source, slab_tag, incoming, s);
+        ++recieved[static_cast<std::size_t>(source)];
+
+        // Handlers may poll in turn, which would overwrite the buffer
+        slab message = std::exchange(incoming, {});
+        unpack(source, message);
+        incoming = std::move(message);
+    }
+
+    void unpack(id_type source, slab const& message) {
+        std::size_t offset = 0;
+        while(offset < message.size()) {
+            tag_type tag;
+            std::memcpy(&tag, message.data() + offset, sizeof(tag_type));
+            offset += sizeof(tag_type);
+
+            const auto h = handlers.find(tag);
+            if(h == handlers.end()) {
+                throw std::runtime_error("No handler registered for records with tag " + std::to_string(tag));
+            }
+            assert(offset + h->second.size <= message.size());
+            h->second.unpack(source, message.data() + offset);
+            offset += h->second.size;
+        }
+    }
+
+    // Recycles the slabs of the sends that completed
+    void reclaim_sent() {
+        if(in_flight.empty()) {
+            return;
+        }
+        // Requests that completed earlier are already inactive, so the result is not needed
+        static_cast<void>(request::test_some(in_flight));
+
+        erase_completed(in_flight, in_flight_slabs, [this](slab& s) { recycle(std::move(s)); });
+    }
+};
+
+}
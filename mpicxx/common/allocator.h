@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "defines.h"
+#include "environment.h"
+
+namespace mpi {
+
+// Process-wide pool of memory for communication buffers. Blocks are rounded up to a power of two, and freed blocks
+// are kept in one list per size class, so that repeated exchanges of similar sizes neither allocate nor page-fault.
+// Cached blocks are released right before finalization.
+// With MPI, blocks come from MPI_Alloc_mem, so they may only be allocated and freed on threads that are allowed to
+// call MPI (see basic_environment::thread_may_call). Under threading::single or funneled, an mpi::buffer must not be
+// resized or destroyed on a worker thread. The other backends use malloc and have no such restriction.
+template<Os OS, bool MpiEnabled>
+class basic_memory_pool {
+  public:
+    using environment = basic_environment<OS, MpiEnabled>;
+
+    // Smallest and largest pooled blocks. Larger requests bypass the pool.
+    static constexpr std::size_t min_block = 64;
+    static constexpr std::size_t max_block = std::size_t{1} << 30;
+
+    [[nodiscard]]
+    static void* allocate(std::size_t bytes) {
+        environment::initialize();
+        assert(!MpiEnabled || environment::thread_may_call());
+        auto& self = singleton();
+        if(bytes > max_block) {
+            const auto lock = self.lock_for_mpi();
+            return allocate_impl(bytes);
+        }
+
+        const std::size_t c = size_class(bytes);
+        std::unique_lock lock(self.mutex);
+        if(!std::exchange(self.registered, true)) {
+            environment::at_finalize(release);
+        }
+        if(auto& blocks = self.free_blocks[c]; !blocks.empty()) {
+            void* p = blocks.back();
+            blocks.pop_back();
+            return p;
+        }
+        if(!serializes_mpi()) {
+            lock.unlock();
+        }
+        return allocate_impl(block_size(c));
+    }
+
+    // bytes must be the size that was requested from allocate
+    static void deallocate(void* p, std::size_t bytes) noexcept {
+        // Finalization already released the pool. Memory from MPI_Alloc_mem cannot be returned anymore, but malloc can.
+        if(environment::stage() != environment::stages::running) {
+            if constexpr(!MpiEnabled) {
+                deallocate_impl(p);
+            }
+            return;
+        }
+        assert(!MpiEnabled || environment::thread_may_call());
+        auto& self = singleton();
+        if(bytes > max_block) {
+            const auto lock = self.lock_for_mpi();
+            deallocate_impl(p);
+            return;
+        }
+
+        std::lock_guard lock(self.mutex);
+        try {
+            self.free_blocks[size_class(bytes)].push_back(p);
+        } catch(std::bad_alloc const&) {
+            deallocate_impl(p);
+        }
+    }
+
+    // Returns every cached block to the system
+    static void release() noexcept {
+        auto& self = singleton();
+        std::lock_guard lock(self.mutex);
+        for(auto& blocks: self.free_blocks) {
+            for(void* p: blocks) {
+                deallocate_impl(p);
+            }
+            blocks.clear();
+        }
+    }
+
+  private:
+    static constexpr std::size_t classes = std::bit_width(max_block / min_block);
+
+    std::mutex mutex;
+    bool registered = false;
+    std::array<std::vector<void*>, classes> free_blocks;
+
+    // Never destroyed, as finalization may run during static destruction and still needs the pool
+    [[nodiscard]]
+    static basic_memory_pool& singleton() {
+        static basic_memory_pool* singleton_ = new basic_memory_pool;
+        return *singleton_;
+    }
+
+    [[nodiscard]]
+    static constexpr std::size_t size_class(std::size_t bytes) noexcept {
+        return static_cast<std::size_t>(std::bit_width((std::max(bytes, min_block) - 1) / min_block));
+    }
+
+    [[nodiscard]]
+    static constexpr std::size_t block_size(std::size_t c) noexcept {
+        return min_block << c;
+    }
+
+    // Below threading::multiple, MPI calls from different threads must not overlap, so MPI_Alloc_mem and
+    // MPI_Free_mem are only called with the mutex held
+    [[nodiscard]]
+    static bool serializes_mpi() noexcept {
+        return MpiEnabled && environment::provided_threading() < threading::multiple;
+    }
+
+    [[nodiscard]]
+    std::unique_lock<std::mutex> lock_for_mpi() {
+        if(serializes_mpi()) {
+            return std::unique_lock(mutex);
+        }
+        return std::unique_lock(mutex, std::defer_lock);
+    }
+
+    // Implemented by template specializations
+    static void* allocate_impl(std::size_t bytes);
+    static void deallocate_impl(void* p) noexcept;
+};
+
+// Allocator for communication buffers, backed by basic_memory_pool. Elements are default-initialized instead of
+// value-initialized, so that resizing a vector of arithmetic types does not zero memory that a receive overwrites.
+template<Os OS, bool MpiEnabled, typename T>
+class basic_allocator {
+  public:
+    using value_type = T;
+    using pool = basic_memory_pool<OS, MpiEnabled>;
+
+    template<typename U>
+    struct rebind {
+        using other = basic_allocator<OS, MpiEnabled, U>;
+    };
+
+    basic_allocator() noexcept = default;
+
+    template<typename U>
+    basic_allocator(basic_allocator<OS, MpiEnabled, U> const&) noexcept { }
+
+    [[nodiscard]]
+    T* allocate(std::size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+        if(n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(pool::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        pool::deallocate(p, n * sizeof(T));
+    }
+
+    template<typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new(static_cast<void*>(p)) U;
+    }
+
+    template<typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        std::construct_at(p, std::forward<Args>(args)...);
+    }
+
+    // Stateless, so any two allocators can free each other's memory
+    friend bool operator==(basic_allocator const&, basic_allocator const&) noexcept {
+        return true;
+    }
+};
+
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "defines.h"
+
+namespace mpi {
+
+// Communicator whose ranks are arranged in an N-dimensional grid
+template<Os OS, bool MpiEnabled>
+class basic_cartesian_communicator;
+
+// Exchanges the ghost layers of a block of an N-dimensional array with the neighbours of a cartesian communicator
+template<Os OS, bool MpiEnabled, typename T>
+class basic_halo_exchange;
+
+// Geometry of a block of an N-dimensional array surrounded by ghost layers, stored in row-major order.
+// Sides are identified by offsets with entries in {-1, 0, 1}, so that corners and edges are sides as well.
+class halo_layout {
+  public:
+    // Part of the block, as the first index and the number of elements in each dimension
+    struct region {
+        std::vector<int> starts;
+        std::vector<int> sizes;
+    };
+
+    halo_layout(std::span<const int> interior, int ghost)
+        : interior(interior.begin(), interior.end())
+        , ghost(ghost)
+    {
+        assert(ghost >= 0);
+        for(int n: interior) {
+            assert(n >= ghost);
+            extents.push_back(n + 2 * ghost);
+        }
+    }
+
+    [[nodiscard]]
+    int ndims() const noexcept {
+        return static_cast<int>(interior.size());
+    }
+
+    // Extents of the block including ghost layers
+    [[nodiscard]]
+    std::span<const int> sizes() const noexcept {
+        return extents;
+    }
+
+    // Number of elements of the block including ghost layers
+    [[nodiscard]]
+    std::size_t size() const noexcept {
+        return std::accumulate(extents.begin(), extents.end(), std::size_t{1},
+            [](std::size_t acc, int n) { return acc * static_cast<std::size_t>(n); });
+    }
+
+    // Every side of an N-dimensional block: 3^N - 1 offsets, in lexicographic order
+    [[nodiscard]]
+    std::vector<std::vector<int>> sides() const {
+        std::vector<std::vector<int>> result;
+        std::vector<int> offset(interior.size(), -1);
+        while(true) {
+            if(std::any_of(offset.begin(), offset.end(), [](int o) { return o != 0; })) {
+                result.push_back(offset);
+            }
+            // Increments the offset as a base-3 number
+            std::size_t d = offset.size();
+            while(d > 0 && offset[d-1] == 1) {
+                offset[d-1] = -1;
+                --d;
+            }
+            if(d == 0) {
+                return result;
+            }
+            ++offset[d-1];
+        }
+    }
+
+    // Interior elements next to the given side, which the neighbour on that side needs
+    [[nodiscard]]
+    region boundary(std::span<const int> side) const {
+        region r;
+        for(std::size_t d=0; d < interior.size(); ++d) {
+            r.starts.push_back(side[d] == 1 ? interior[d] : ghost);
+            r.sizes.push_back(side[d] == 0 ? interior[d] : ghost);
+        }
+        return r;
+    }
+
+    // Ghost elements on the given side, which are filled by the neighbour on that side
+    [[nodiscard]]
+    region halo(std::span<const int> side) const {
+        region r;
+        for(std::size_t d=0; d < interior.size(); ++d) {
+            r.starts.push_back(side[d] == -1 ? 0 : side[d] == 1 ? interior[d] + ghost : ghost);
+            r.sizes.push_back(side[d] == 0 ? interior[d] : ghost);
+        }
+        return r;
+    }
+
+    // Positions of the elements of a region in the flattened block, in row-major order
+    [[nodiscard]]
+    std::vector<std::size_t> flat_indices(region const& r) const {
+        std::vector<std::size_t> indices;
+        if(std::any_of(r.sizes.begin(), r.sizes.end(), [](int n) { return n == 0; })) {
+            return indices;
+        }
+        std::vector<int> index(r.starts);
+        while(true) {
+            std::size_t flat = 0;
+            for(std::size_t d=0; d < index.size(); ++d) {
+                flat = flat * static_cast<std::size_t>(extents[d]) + static_cast<std::size_t>(index[d]);
+            }
+            indices.push_back(flat);
+
+            std::size_t d = index.size();
+            while(d > 0 && index[d-1] == r.starts[d-1] + r.sizes[d-1] - 1) {
+                index[d-1] = r.starts[d-1];
+                --d;
+            }
+            if(d == 0) {
+                return indices;
+            }
+            ++index[d-1];
+        }
+    }
+
+  private:
+    std::vector<int> interior;
+    std::vector<int> extents;
+    int ghost;
+};
+
+}
@@ -3,8 +3,10 @@
 
 namespace mpi {
 
+// Platform of the implementation. Threads is not an operating system, but the backend that runs every rank as a
+// thread of this process on any platform (see run_threads).
 enum class Os {
-    Windows, Linux
+    Windows, Linux, Threads
 };
 
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
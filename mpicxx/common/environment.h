@@ -1,13 +1,36 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
+#include <mutex>
 #include <string>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "defines.h"
 
+// Thread support level requested when MPI is initialized implicitly.
+// Define it as single, funneled, serialized or multiple.
+#ifndef MPICXX_THREADING
+    #define MPICXX_THREADING single
+#endif
 
 namespace mpi {
 
+// Thread support levels, in increasing order of thread safety:
+//  - single:     Only one thread exists.
+//  - funneled:   Only the thread that initialized the environment calls MPI.
+//  - serialized: Any thread calls MPI, but never two at the same time.
+//  - multiple:   Any thread calls MPI at any time.
+enum class threading {
+    single, funneled, serialized, multiple
+};
+
+constexpr threading default_threading() noexcept {
+    return threading::MPICXX_THREADING;
+}
+
 // RAII class to initialize and finalize MPI
 template<Os OS, bool MpiEnabled>
 struct basic_environment {
@@ -22,20 +45,64 @@ struct basic_environment {
         uninitialized, running, finished
     };
 
-    static void initialize() {
+    // The requested thread support level is ignored if the environment is already initialized.
+    // Concurrent calls are fine: the first one initializes under a lock, and the others wait for it to finish.
+    static void initialize(threading required = default_threading()) {
+        if(stage() == stages::running) {
+            return;
+        }
+        auto& self = singleton();
+        const std::lock_guard lock(self.stage_mutex_);
         if(stage() == stages::uninitialized) {
-            initialize_impl();
+            self.provided_ = initialize_impl(required);
+            self.main_thread_ = std::this_thread::get_id();
         }
         advance_stage(stages::running);
     }
 
+    // Thread support level granted by the implementation, which may be lower than the requested one
+    [[nodiscard]]
+    static threading provided_threading() noexcept { return singleton().provided_; }
+
+    // Whether the provided thread support level lets the calling thread call MPI. Below threading::serialized, only
+    // the thread that initialized the environment may. Calls from different threads must still be serialized.
+    [[nodiscard]]
+    static bool thread_may_call() noexcept {
+        return provided_threading() >= threading::serialized || std::this_thread::get_id() == singleton().main_thread_;
+    }
+
     static void finalize() {
-        if(stage() == stages::running) {    
+        auto& self = singleton();
+        if(stage() == stages::running) {
+            // Callbacks run without the lock, as they may register more callbacks
+            while(true) {
+                std::function<void()> callback;
+                {
+                    const std::lock_guard lock(self.finalize_mutex_);
+                    if(self.finalize_callbacks_.empty()) {
+                        break;
+                    }
+                    callback = std::move(self.finalize_callbacks_.back());
+                    self.finalize_callbacks_.pop_back();
+                }
+                callback();
+            }
+        }
+        const std::lock_guard lock(self.stage_mutex_);
+        if(stage() == stages::running) {
             finalize_impl();
         }
         advance_stage(stages::finished);
     }
 
+    // Registers a callback to be run right before finalization, in reverse order of registration.
+    // Used to release resources that must not outlive the environment. Any thread may register callbacks.
+    static void at_finalize(std::function<void()> callback) {
+        auto& self = singleton();
+        const std::lock_guard lock(self.finalize_mutex_);
+        self.finalize_callbacks_.push_back(std::move(callback));
+    }
+
     static std::string stage_string(stages stage) {
         switch (stage) {
         case stages::uninitialized: return "uninitialized";
@@ -45,7 +112,8 @@ struct basic_environment {
         return "undetermined";
     }
 
-#ifdef DNDEBUG
+    // Checks are compiled out in release builds, so that wrapped calls cost the same as raw MPI
+#ifdef NDEBUG
     static constexpr void assert_running() noexcept { }
 #else
     static void assert_running() {
@@ -57,14 +125,15 @@ struct basic_environment {
 #endif
     
     [[nodiscard]]
-    static stages stage() noexcept { return singleton().stage_; }
+    static stages stage() noexcept { return singleton().stage_.load(std::memory_order_acquire); }
 
 private:
     static void advance_stage(stages next_stage) {
         if(next_stage < stage()) {
             throw std::runtime_error("Attempted to regress MPI environment stage from " + stage_string(stage()) + " to " + stage_string(next_stage) + "\n");
         }
-        singleton().stage_ = next_stage;
+        // Publishes provided_ and main_thread_ to the threads that see the new stage
+        singleton().stage_.store(next_stage, std::memory_order_release);
     }
 
     [[nodiscard]]
@@ -73,10 +142,15 @@ private:
         return singleton_;
     }
 
-    stages stage_ = stages::uninitialized;
+    std::atomic<stages> stage_ = stages::uninitialized;
+    threading provided_ = threading::single;
+    std::thread::id main_thread_;
+    std::mutex stage_mutex_;
+    std::mutex finalize_mutex_;
+    std::vector<std::function<void()>> finalize_callbacks_;
 
     // Implemented by template specializations
-    static void initialize_impl();
+    static threading initialize_impl(threading required);
     static void finalize_impl();
 };
 
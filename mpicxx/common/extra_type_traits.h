@@ -2,6 +2,7 @@
 
 #include <array>
 #include <cassert>
+#include <ranges>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -28,6 +29,7 @@ struct container_traits {
 template<typename T, std::size_t S>
 struct container_traits<std::array<T, S>> {
     static constexpr bool contiguous = true;
+    static constexpr bool resizable = false;
     using data = T;
     [[nodiscard]] static constexpr auto size(std::array<T, S> const&)      noexcept ->  std::size_t  { return S; }
     [[nodiscard]] static constexpr auto front(std::array<T, S> & c)        noexcept ->  T&           { assert(size(c) > 0); return c.front(); }
@@ -40,6 +42,7 @@ struct container_traits<std::array<T, S>> {
 template<typename T, std::size_t S>
 struct container_traits<T[S]> {
     static constexpr bool contiguous = true;
+    static constexpr bool resizable = false;
     using data = T;
     [[nodiscard]] static constexpr auto size(const T[S])      noexcept -> std::size_t { return S; }
     [[nodiscard]] static constexpr auto front(T c[S])         noexcept -> T&          { assert(size(c) > 0); return c[0]; }
@@ -49,21 +52,24 @@ struct container_traits<T[S]> {
     static constexpr void try_resize(const T[S], [[maybe_unused]] std::size_t sz) noexcept  { assert(sz <= S); }
 };
 
-template<typename T>
-struct container_traits<std::vector<T>> {
+// Any allocator, so that buffers from mpi::allocator are supported as well
+template<typename T, typename A>
+struct container_traits<std::vector<T, A>> {
     static constexpr bool contiguous = true;
+    static constexpr bool resizable = true;
     using data = T;
-    [[nodiscard]] static constexpr auto size(std::vector<T> const& c)    noexcept -> std::size_t { return c.size(); }
-    [[nodiscard]] static constexpr auto front(std::vector<T> & c)        noexcept -> T&          { assert(size(c) > 0); return c.front(); }
-    [[nodiscard]] static constexpr auto front(std::vector<T> const& c)   noexcept -> T const&    { assert(size(c) > 0); return c.front(); }
-    [[nodiscard]] static constexpr auto pointer(std::vector<T> & c)      noexcept -> T*          { return c.data(); }
-    [[nodiscard]] static constexpr auto pointer(std::vector<T> const& c) noexcept -> T const*    { return c.data(); }
-    static constexpr void try_resize(std::vector<T> & c, std::size_t sz)           { c.resize(sz); }
+    [[nodiscard]] static constexpr auto size(std::vector<T, A> const& c)    noexcept -> std::size_t { return c.size(); }
+    [[nodiscard]] static constexpr auto front(std::vector<T, A> & c)        noexcept -> T&          { assert(size(c) > 0); return c.front(); }
+    [[nodiscard]] static constexpr auto front(std::vector<T, A> const& c)   noexcept -> T const&    { assert(size(c) > 0); return c.front(); }
+    [[nodiscard]] static constexpr auto pointer(std::vector<T, A> & c)      noexcept -> T*          { return c.data(); }
+    [[nodiscard]] static constexpr auto pointer(std::vector<T, A> const& c) noexcept -> T const*    { return c.data(); }
+    static constexpr void try_resize(std::vector<T, A> & c, std::size_t sz)           { c.resize(sz); }
 };
 
 template<typename T>
 struct container_traits<std::basic_string<T>> {
     static constexpr bool contiguous = true;
+    static constexpr bool resizable = true;
     using data = T;
     [[nodiscard]] static constexpr auto size(std::basic_string<T> const& c)    noexcept -> std::size_t   { return c.size(); }
     [[nodiscard]] static constexpr auto front(std::basic_string<T> & c)        noexcept -> T&            { assert(size(c) > 0); return c.front(); }
@@ -73,8 +79,23 @@ struct container_traits<std::basic_string<T>> {
     static constexpr void try_resize(std::basic_string<T> & c, std::size_t sz)             { c.resize(sz); }
 };
 
-template<>
-struct container_traits<std::vector<bool>> {
+// Any other contiguous range, such as std::span of either extent or a const container, is used in place.
+// Its size is fixed, so it must be large enough to hold any message it recieves.
+template<typename R>
+    requires std::ranges::contiguous_range<R> && std::ranges::sized_range<R>
+struct container_traits<R> {
+    static constexpr bool contiguous = true;
+    static constexpr bool resizable = false;
+    using data = std::ranges::range_value_t<R>;
+    [[nodiscard]] static constexpr auto size(R const& c)     noexcept -> std::size_t { return static_cast<std::size_t>(std::ranges::size(c)); }
+    // Templates, as R may be const itself
+    template<typename C> [[nodiscard]] static constexpr auto front(C& c)   noexcept -> decltype(auto) { assert(size(c) > 0); return *std::ranges::data(c); }
+    template<typename C> [[nodiscard]] static constexpr auto pointer(C& c) noexcept -> decltype(auto) { return std::ranges::data(c); }
+    static constexpr void try_resize(R const& c, [[maybe_unused]] std::size_t sz) noexcept { assert(sz <= size(c)); }
+};
+
+template<typename A>
+struct container_traits<std::vector<bool, A>> {
     static constexpr bool contiguous = false;
     using data = bool;
 };
@@ -84,4 +105,8 @@ struct container_traits<std::vector<bool>> {
 template<typename C>
 concept ContiguousContainer = container_traits<C>::contiguous;
 
+// Contiguous container whose size can be set by try_resize, so that it can hold a message of unknown size.
+template<typename C>
+concept ResizableContainer = ContiguousContainer<C> && container_traits<C>::resizable;
+
 }
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <memory>
+#include <utility>
+
+namespace mpi {
+
+// Lock-free queue with many producers and a single consumer. Nodes are linked through their `next` member, so that
+// pushing does not allocate. The queue owns the nodes from the moment they are pushed until they are drained.
+template<typename Node>
+class mpsc_queue {
+  public:
+    mpsc_queue() noexcept = default;
+
+    mpsc_queue(mpsc_queue const&) = delete;
+    mpsc_queue& operator=(mpsc_queue const&) = delete;
+
+    ~mpsc_queue() noexcept {
+        drain([](std::unique_ptr<Node>) { });
+    }
+
+    // Safe to call from any number of threads at once
+    void push(std::unique_ptr<Node> node) noexcept {
+        Node* n = node.release();
+        n->next = head.load(std::memory_order_relaxed);
+        while(!head.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Hands every node pushed so far to f, in the order they were pushed. Only one thread may drain.
+    template<std::invocable<std::unique_ptr<Node>> F>
+    void drain(F&& f) {
+        // Nodes are pushed at the front, so the list is reversed before handing them out
+        Node* fifo = nullptr;
+        Node* n = head.exchange(nullptr, std::memory_order_acquire);
+        while(n != nullptr) {
+            Node* next = n->next;
+            n->next = fifo;
+            fifo = n;
+            n = next;
+        }
+        while(fifo != nullptr) {
+            n = std::exchange(fifo, fifo->next);
+            n->next = nullptr;
+            f(std::unique_ptr<Node>(n));
+        }
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept {
+        return head.load(std::memory_order_acquire) == nullptr;
+    }
+
+  private:
+    std::atomic<Node*> head = nullptr;
+};
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <complex>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+
+#include "extra_type_traits.h"
+
+namespace mpi {
+
+// Binary functor returning the smallest of its arguments, analogous to std::plus
+template<typename T = void>
+struct min {
+    [[nodiscard]] constexpr T operator()(T const& lhs, T const& rhs) const { return rhs < lhs ? rhs : lhs; }
+};
+
+template<>
+struct min<void> {
+    template<typename T>
+    [[nodiscard]] constexpr T operator()(T const& lhs, T const& rhs) const { return rhs < lhs ? rhs : lhs; }
+};
+
+// Binary functor returning the largest of its arguments, analogous to std::plus
+template<typename T = void>
+struct max {
+    [[nodiscard]] constexpr T operator()(T const& lhs, T const& rhs) const { return lhs < rhs ? rhs : lhs; }
+};
+
+template<>
+struct max<void> {
+    template<typename T>
+    [[nodiscard]] constexpr T operator()(T const& lhs, T const& rhs) const { return lhs < rhs ? rhs : lhs; }
+};
+
+// Wrapper to flag a user-defined operation as non-commutative.
+// Operations are otherwise assumed to be commutative.
+template<typename Op>
+struct non_commutative : Op {
+};
+
+template<typename Op>
+non_commutative(Op) -> non_commutative<Op>;
+
+template<typename Op>
+struct is_commutative : std::true_type {};
+
+template<typename Op>
+struct is_commutative<non_commutative<Op>> : std::false_type {};
+
+// Operations must be stateless, so that they can be recreated inside the reduction callback
+template<typename Op, typename T>
+concept ReduceOperation = std::default_initializable<Op> && std::is_invocable_r_v<T, Op const&, T const&, T const&>;
+
+// Operations with a predefined equivalent in MPI
+enum class builtin_operation {
+    none, sum, prod, min, max, logical_and, logical_or, bit_and, bit_or, bit_xor
+};
+
+// Types MPI accepts for each class of predefined operations.
+// Note that char, wchar_t and bool are not part of the arithmetic categories, and complex numbers cannot be compared.
+template<typename T>
+concept BuiltinIntegral = AnyOf<T,
+    short, unsigned short, int, unsigned int, long, unsigned long, long long, unsigned long long,
+    signed char, unsigned char>;
+
+template<typename T>
+concept BuiltinArithmetic = BuiltinIntegral<T> || AnyOf<T, float, double, long double>;
+
+template<typename T>
+concept BuiltinComplex = AnyOf<T, std::complex<float>, std::complex<double>, std::complex<long double>>;
+
+template<typename T>
+concept BuiltinLogical = BuiltinIntegral<T> || std::is_same_v<T, bool>;
+
+// Returns the predefined operation equivalent to Op acting on T, or builtin_operation::none if there is none
+template<typename Op, typename T>
+[[nodiscard]] constexpr builtin_operation get_builtin_operation() noexcept {
+    if constexpr      ((BuiltinArithmetic<T> || BuiltinComplex<T>) && AnyOf<Op, std::plus<T>, std::plus<>>)             return builtin_operation::sum;
+    else if constexpr ((BuiltinArithmetic<T> || BuiltinComplex<T>) && AnyOf<Op, std::multiplies<T>, std::multiplies<>>) return builtin_operation::prod;
+    else if constexpr (BuiltinArithmetic<T> && AnyOf<Op, mpi::min<T>, mpi::min<>>)                 return builtin_operation::min;
+    else if constexpr (BuiltinArithmetic<T> && AnyOf<Op, mpi::max<T>, mpi::max<>>)                 return builtin_operation::max;
+    else if constexpr (BuiltinLogical<T>    && AnyOf<Op, std::logical_and<T>, std::logical_and<>>) return builtin_operation::logical_and;
+    else if constexpr (BuiltinLogical<T>    && AnyOf<Op, std::logical_or<T>, std::logical_or<>>)   return builtin_operation::logical_or;
+    else if constexpr (BuiltinIntegral<T>   && AnyOf<Op, std::bit_and<T>, std::bit_and<>>)         return builtin_operation::bit_and;
+    else if constexpr (BuiltinIntegral<T>   && AnyOf<Op, std::bit_or<T>, std::bit_or<>>)           return builtin_operation::bit_or;
+    else if constexpr (BuiltinIntegral<T>   && AnyOf<Op, std::bit_xor<T>, std::bit_xor<>>)         return builtin_operation::bit_xor;
+    else return builtin_operation::none;
+}
+
+// One-sided accumulates only accept predefined operations
+template<typename Op, typename T>
+concept BuiltinOperation = get_builtin_operation<Op, T>() != builtin_operation::none;
+
+}
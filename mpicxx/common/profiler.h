@@ -0,0 +1,389 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "defines.h"
+#include "communicator.h"
+#include "environment.h"
+#include "extra_type_traits.h"
+#include "strided_view.h"
+#include "tracer.h"
+#include "types.h"
+
+// Define as true to record every call of the communicators. When false, the instrumentation compiles to nothing.
+#ifndef MPICXX_PROFILE
+    #define MPICXX_PROFILE false
+#endif
+
+namespace mpi {
+
+// Operations of the communicator that the profiler tells apart
+enum class profiled_operation {
+    send, recv, probe, isend, irecv,
+    barrier, ibarrier, broadcast, ibroadcast,
+    gather, igather, scatter, allgather, alltoall,
+    gatherv, igatherv, allgatherv, scatterv, alltoallv,
+    reduce, allreduce, iallreduce, scan, exscan,
+    wait, put, get, accumulate, fetch_op, compare_swap, fence, flush, epoch_close,
+    count
+};
+
+constexpr std::size_t profiled_operation_count = static_cast<std::size_t>(profiled_operation::count);
+
+constexpr std::string_view operation_name(profiled_operation op) noexcept {
+    constexpr std::array<std::string_view, profiled_operation_count> names {
+        "send", "recv", "probe", "isend", "irecv",
+        "barrier", "ibarrier", "broadcast", "ibroadcast",
+        "gather", "igather", "scatter", "allgather", "alltoall",
+        "gatherv", "igatherv", "allgatherv", "scatterv", "alltoallv",
+        "reduce", "allreduce", "iallreduce", "scan", "exscan",
+        "wait", "put", "get", "accumulate", "fetch_op", "compare_swap", "fence", "flush", "epoch_close",
+    };
+    return names[static_cast<std::size_t>(op)];
+}
+
+// Bytes of data a rank contributes to a call
+template<typename T>
+[[nodiscard]]
+constexpr std::size_t payload_bytes(T const& data) noexcept {
+    if constexpr(ContiguousContainer<T>) {
+        return container_traits<T>::size(data) * sizeof(typename container_traits<T>::data);
+    } else {
+        return sizeof(T);
+    }
+}
+
+template<typename T>
+[[nodiscard]]
+constexpr std::size_t payload_bytes(strided_view<T> const& data) noexcept {
+    return data.size() * sizeof(T);
+}
+
+// Calls, bytes and time spent in one operation. Nonblocking operations only account for the time to post them.
+struct operation_stats {
+    // Bucket i counts the calls that took [2^(i-1), 2^i) nanoseconds. The last one also counts every longer call.
+    static constexpr std::size_t buckets = 36;
+
+    unsigned long long calls = 0;
+    unsigned long long bytes = 0;
+    unsigned long long nanoseconds = 0;
+    std::array<unsigned long long, buckets> histogram{};
+
+    [[nodiscard]]
+    static constexpr std::size_t bucket(std::chrono::nanoseconds elapsed) noexcept {
+        const auto ns = static_cast<unsigned long long>(std::max(elapsed.count(), std::chrono::nanoseconds::rep{0}));
+        return std::min(static_cast<std::size_t>(std::bit_width(ns)), buckets - 1);
+    }
+
+    void add(std::size_t b, std::chrono::nanoseconds elapsed) noexcept {
+        calls += 1;
+        bytes += b;
+        nanoseconds += static_cast<unsigned long long>(std::max(elapsed.count(), std::chrono::nanoseconds::rep{0}));
+        histogram[bucket(elapsed)] += 1;
+    }
+};
+
+// Point-to-point traffic with one peer, in either direction
+struct peer_stats {
+    unsigned long long calls = 0;
+    unsigned long long bytes = 0;
+};
+
+// Collects the calls of every communicator of this process. Peers are identified by their world rank, whatever the
+// communicator that was used, so that traffic over split and cartesian communicators lands in the right row.
+//
+// With MPICXX_PROFILE, every call of a communicator is recorded, and a report is written when the environment is
+// finalized, to the file named by the MPICXX_PROFILE_FILE environment variable (mpicxx_profile.txt by default).
+template<Os OS, bool MpiEnabled>
+class basic_profiler {
+  public:
+    using communicator = basic_communicator<OS, MpiEnabled>;
+    using environment = basic_environment<OS, MpiEnabled>;
+    using id_type = typename typedefs<OS, MpiEnabled>::id_type;
+    using tracer = basic_tracer<OS, MpiEnabled>;
+    using clock = std::chrono::steady_clock;
+
+    static constexpr bool enabled = MPICXX_PROFILE;
+    static constexpr id_type no_peer = -1;
+
+    static void record(profiled_operation op, id_type peer, std::size_t bytes, std::chrono::nanoseconds elapsed) {
+        auto& self = singleton();
+        std::lock_guard lock(self.mutex);
+        self.operations[static_cast<std::size_t>(op)].add(bytes, elapsed);
+        if(peer >= 0) {
+            const auto p = static_cast<std::size_t>(peer);
+            if(p >= self.peers.size()) {
+                self.peers.resize(p + 1);
+            }
+            self.peers[p].calls += 1;
+            self.peers[p].bytes += bytes;
+        }
+    }
+
+    [[nodiscard]]
+    static operation_stats stats(profiled_operation op) {
+        auto& self = singleton();
+        std::lock_guard lock(self.mutex);
+        return self.operations[static_cast<std::size_t>(op)];
+    }
+
+    [[nodiscard]]
+    static peer_stats peer(id_type p) {
+        auto& self = singleton();
+        std::lock_guard lock(self.mutex);
+        const auto i = static_cast<std::size_t>(p);
+        return i < self.peers.size() ? self.peers[i] : peer_stats{};
+    }
+
+    static void reset() {
+        auto& self = singleton();
+        std::lock_guard lock(self.mutex);
+        self.operations = {};
+        self.peers.clear();
+    }
+
+    // Rank 0 writes the statistics of every rank, and their summary across ranks. Collective.
+    static void write_report(communicator const& comm, std::string const& path) {
+        const auto ranks = static_cast<std::size_t>(comm.size());
+
+        // Taken before gathering, so that the report does not count itself
+        std::vector<unsigned long long> local;
+        std::vector<unsigned long long> local_peers(2 * ranks, 0);
+        {
+            auto& self = singleton();
+            std::lock_guard lock(self.mutex);
+            for(auto const& s: self.operations) {
+                local.insert(local.end(), {s.calls, s.bytes, s.nanoseconds});
+                local.insert(local.end(), s.histogram.begin(), s.histogram.end());
+            }
+            for(std::size_t p=0; p < std::min(ranks, self.peers.size()); ++p) {
+                local_peers[2 * p] = self.peers[p].calls;
+                local_peers[2 * p + 1] = self.peers[p].bytes;
+            }
+        }
+
+        std::vector<unsigned long long> all;
+        std::vector<unsigned long long> all_peers;
+        comm.gather(0, local, all);
+        comm.gather(0, local_peers, all_peers);
+        if(comm.rank() != 0) {
+            return;
+        }
+
+        std::vector<std::array<operation_stats, profiled_operation_count>> per_rank(ranks);
+        auto it = all.begin();
+        for(auto& rank: per_rank) {
+            for(auto& s: rank) {
+                s.calls = *it++;
+                s.bytes = *it++;
+                s.nanoseconds = *it++;
+                std::copy_n(it, s.histogram.size(), s.histogram.begin());
+                it += static_cast<std::ptrdiff_t>(s.histogram.size());
+            }
+        }
+
+        std::ofstream out(path);
+        print_summary(out, per_rank);
+        for(std::size_t r=0; r < ranks; ++r) {
+            out << "\n== Rank " << r << " ==\n";
+            print_operations(out, per_rank[r]);
+            print_peers(out, std::span(all_peers).subspan(2 * ranks * r, 2 * ranks));
+        }
+    }
+
+    // Writes the report when the environment is finalized. Every rank that uses a communicator registers it once.
+    static void report_at_finalize() {
+        if constexpr(enabled) {
+            static const bool registered = [] {
+                environment::at_finalize([] {
+                    const char* path = std::getenv("MPICXX_PROFILE_FILE");
+                    write_report(communicator::get_default(), path ? path : "mpicxx_profile.txt");
+                });
+                return true;
+            }();
+            static_cast<void>(registered);
+        }
+    }
+
+    // Times a call and records it when it goes out of scope, in the statistics when profiling and in the timeline when
+    // tracing. Calls made by another call, such as the size exchange of gatherv, are part of the outermost one and are
+    // not recorded on their own.
+    class timed_scope {
+      public:
+        timed_scope(profiled_operation op, id_type peer = no_peer, std::size_t bytes = 0) noexcept
+            : op(op), peer(peer), bytes(bytes), outermost(depth++ == 0), start(clock::now())
+        {
+        }
+
+        // The peer is a rank of comm, which is translated to its world rank when the call is recorded.
+        // The communicator must outlive the scope.
+        timed_scope(profiled_operation op, communicator const& comm, id_type peer, std::size_t bytes) noexcept
+            : timed_scope(op, peer, bytes)
+        {
+            peer_comm = &comm;
+        }
+
+        timed_scope(timed_scope const&) = delete;
+        timed_scope& operator=(timed_scope const&) = delete;
+
+        ~timed_scope() noexcept {
+            --depth;
+            if(!outermost) {
+                return;
+            }
+            const auto end = clock::now();
+            if constexpr(tracer::enabled) {
+                // Names of operations are string literals
+                tracer::record(operation_name(op).data(), "mpi", start, end);
+            }
+            if constexpr(enabled) {
+                try {
+                    const id_type world_peer = peer_comm ? peer_comm->world_rank(peer) : peer;
+                    record(op, world_peer, bytes, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
+                } catch(...) {
+                    // Statistics are lost rather than letting the call fail
+                }
+            }
+        }
+
+        // For receives whose source or size is only known once the message has arrived
+        void set_peer(id_type p) noexcept { peer = p; }
+        void set_bytes(std::size_t b) noexcept { bytes = b; }
+
+      private:
+        static inline thread_local int depth = 0;
+
+        profiled_operation op;
+        id_type peer;
+        std::size_t bytes;
+        bool outermost;
+        clock::time_point start;
+        communicator const* peer_comm = nullptr;
+    };
+
+    class null_scope {
+      public:
+        constexpr null_scope(profiled_operation, id_type = no_peer, std::size_t = 0) noexcept { }
+        constexpr null_scope(profiled_operation, communicator const&, id_type, std::size_t) noexcept { }
+        constexpr void set_peer(id_type) noexcept { }
+        constexpr void set_bytes(std::size_t) noexcept { }
+    };
+
+    using scope = std::conditional_t<enabled || tracer::enabled, timed_scope, null_scope>;
+
+  private:
+    std::mutex mutex;
+    std::array<operation_stats, profiled_operation_count> operations{};
+    std::vector<peer_stats> peers;
+
+    // Never destroyed, as the report is written by the environment, which may be destroyed after it
+    [[nodiscard]]
+    static basic_profiler& singleton() {
+        static basic_profiler* singleton_ = new basic_profiler;
+        return *singleton_;
+    }
+
+    static double seconds(unsigned long long ns) noexcept {
+        return static_cast<double>(ns) * 1e-9;
+    }
+
+    static void print_operations(std::ostream& out, std::array<operation_stats, profiled_operation_count> const& ops) {
+        out << std::left << std::setw(12) << "operation" << std::right
+            << std::setw(12) << "calls" << std::setw(16) << "bytes" << std::setw(14) << "seconds" << '\n';
+        for(std::size_t i=0; i < ops.size(); ++i) {
+            if(ops[i].calls == 0) {
+                continue;
+            }
+            out << std::left << std::setw(12) << operation_name(static_cast<profiled_operation>(i)) << std::right
+                << std::setw(12) << ops[i].calls << std::setw(16) << ops[i].bytes
+                << std::setw(14) << std::fixed << std::setprecision(6) << seconds(ops[i].nanoseconds) << '\n';
+        }
+    }
+
+    // Peers sorted by the bytes exchanged with them, busiest first
+    static void print_peers(std::ostream& out, std::span<const unsigned long long> peers) {
+        std::vector<std::size_t> order;
+        for(std::size_t p=0; p < peers.size() / 2; ++p) {
+            if(peers[2 * p] != 0) {
+                order.push_back(p);
+            }
+        }
+        if(order.empty()) {
+            return;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return peers[2 * a + 1] > peers[2 * b + 1]; });
+
+        out << "peer" << std::setw(12) << "calls" << std::setw(16) << "bytes" << '\n';
+        for(auto p: order) {
+            out << std::left << std::setw(4) << p << std::right
+                << std::setw(12) << peers[2 * p] << std::setw(16) << peers[2 * p + 1] << '\n';
+        }
+    }
+
+    // Time spent in each operation across ranks. A max well above the mean points to load imbalance.
+    static void print_summary(std::ostream& out, std::vector<std::array<operation_stats, profiled_operation_count>> const& per_rank) {
+        out << "== All " << per_rank.size() << " ranks ==\n";
+        out << std::left << std::setw(12) << "operation" << std::right
+            << std::setw(12) << "calls" << std::setw(16) << "bytes"
+            << std::setw(14) << "min s" << std::setw(14) << "mean s" << std::setw(14) << "max s" << "  slowest\n";
+
+        std::array<operation_stats, profiled_operation_count> total{};
+        for(std::size_t i=0; i < profiled_operation_count; ++i) {
+            unsigned long long min_ns = ~0ull;
+            unsigned long long max_ns = 0;
+            std::size_t slowest = 0;
+            for(std::size_t r=0; r < per_rank.size(); ++r) {
+                auto const& s = per_rank[r][i];
+                total[i].calls += s.calls;
+                total[i].bytes += s.bytes;
+                total[i].nanoseconds += s.nanoseconds;
+                for(std::size_t b=0; b < s.histogram.size(); ++b) {
+                    total[i].histogram[b] += s.histogram[b];
+                }
+                min_ns = std::min(min_ns, s.nanoseconds);
+                if(s.nanoseconds > max_ns) {
+                    max_ns = s.nanoseconds;
+                    slowest = r;
+                }
+            }
+            if(total[i].calls == 0) {
+                continue;
+            }
+            out << std::left << std::setw(12) << operation_name(static_cast<profiled_operation>(i)) << std::right
+                << std::setw(12) << total[i].calls << std::setw(16) << total[i].bytes << std::fixed << std::setprecision(6)
+                << std::setw(14) << seconds(min_ns)
+                << std::setw(14) << seconds(total[i].nanoseconds) / static_cast<double>(per_rank.size())
+                << std::setw(14) << seconds(max_ns) << "  rank " << slowest << '\n';
+        }
+
+        out << "\nLatency histogram, calls per bucket of [2^(i-1), 2^i) ns\n";
+        for(std::size_t i=0; i < profiled_operation_count; ++i) {
+            if(total[i].calls == 0) {
+                continue;
+            }
+            out << std::left << std::setw(12) << operation_name(static_cast<profiled_operation>(i)) << std::right;
+            for(std::size_t b=0; b < operation_stats::buckets; ++b) {
+                if(total[i].histogram[b] != 0) {
+                    out << "  " << b << ':' << total[i].histogram[b];
+                }
+            }
+            out << '\n';
+        }
+    }
+};
+
+}
@@ -0,0 +1,348 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "defines.h"
+#include "communicator.h"
+#include "environment.h"
+#include "extra_type_traits.h"
+#include "mpsc_queue.h"
+#include "request.h"
+#include "types.h"
+
+namespace mpi {
+
+// Data that the engine can send or receive on its own: a single value or a contiguous container
+template<typename T>
+concept Transferable = ValidType<T> || ValidContainer<T>;
+
+// Owns a thread that makes every MPI call for the operations posted to it, so that any number of threads can
+// communicate while MPI sees a single one. Operations are posted through a lock-free queue, and completed with
+// MPI_Testsome over all pending requests. Their results come back through futures or callbacks.
+//
+// The environment must provide threading::serialized or above. Other threads must not call MPI while the engine
+// runs, unless it provides threading::multiple. The engine must be destroyed before the environment is finalized.
+template<Os OS, bool MpiEnabled>
+class basic_progress_engine {
+  public:
+    using communicator = basic_communicator<OS, MpiEnabled>;
+    using request = basic_request<OS, MpiEnabled>;
+    using environment = basic_environment<OS, MpiEnabled>;
+    using id_type = typename communicator::id_type;
+    using tag_type = typename communicator::tag_type;
+
+    // The communicator must outlive the engine
+    explicit basic_progress_engine(communicator const& comm)
+        : comm(comm)
+    {
+        environment::assert_running();
+        if(environment::provided_threading() < threading::serialized) {
+            throw std::runtime_error("The progress engine requires threading::serialized or above");
+        }
+        worker = std::thread([this] { run(); });
+    }
+
+    // The operations refer to the engine
+    basic_progress_engine(basic_progress_engine const&) = delete;
+    basic_progress_engine& operator=(basic_progress_engine const&) = delete;
+
+    // Every posted operation is completed before the thread stops, so a receive that is never matched blocks here
+    ~basic_progress_engine() noexcept {
+        stopping.store(true, std::memory_order_release);
+        wake();
+        worker.join();
+    }
+
+    // Sends the data, which the engine owns until the message has been sent
+    template<Transferable T>
+    [[nodiscard]]
+    std::future<void> send(id_type destination, tag_type tag, T data) {
+        std::promise<void> p;
+        auto f = p.get_future();
+        post(std::make_unique<send_operation<T, fulfil<void>>>(destination, tag, std::move(data), fulfil<void>{std::move(p)}));
+        return f;
+    }
+
+    // Calls on_sent from the engine thread once the message has been sent
+    template<Transferable T, std::invocable F>
+    void send(id_type destination, tag_type tag, T data, F on_sent) {
+        post(std::make_unique<send_operation<T, notify<F>>>(destination, tag, std::move(data), notify<F>{std::move(on_sent), this}));
+    }
+
+    // Receives a message. Resizable containers take the size of the message, as it is probed before being received.
+    template<Transferable T>
+    [[nodiscard]]
+    std::future<T> recv(id_type source, tag_type tag) {
+        std::promise<T> p;
+        auto f = p.get_future();
+        post(std::make_unique<recv_operation<T, fulfil<T>>>(source, tag, fulfil<T>{std::move(p)}));
+        return f;
+    }
+
+    // Calls on_recieved with the message from the engine thread
+    template<Transferable T, std::invocable<T&&> F>
+    void recv(id_type source, tag_type tag, F on_recieved) {
+        post(std::make_unique<recv_operation<T, notify<F>>>(source, tag, notify<F>{std::move(on_recieved), this}));
+    }
+
+    // Blocks until every operation posted so far has completed. Then rethrows the first exception raised by an
+    // operation with a callback, or by the callback itself.
+    void flush() {
+        for(auto n = outstanding.load(std::memory_order_acquire); n != 0; n = outstanding.load(std::memory_order_acquire)) {
+            outstanding.wait(n, std::memory_order_acquire);
+        }
+
+        std::lock_guard lock(error_mutex);
+        if(error) {
+            std::rethrow_exception(std::exchange(error, {}));
+        }
+    }
+
+  private:
+    // Posted communication. The engine starts it, and completes or fails it once its request completes.
+    struct operation {
+        operation* next = nullptr;
+
+        virtual ~operation() = default;
+
+        // Returns nullopt if the operation cannot start yet, and is to be retried on the next iteration
+        [[nodiscard]]
+        virtual std::optional<request> start(communicator const& comm) = 0;
+
+        // Source and tag of a receive, which later receives that may match the same message must not overtake
+        [[nodiscard]]
+        virtual std::optional<std::pair<id_type, tag_type>> receive_envelope() const noexcept {
+            return std::nullopt;
+        }
+
+        virtual void complete() = 0;
+        virtual void fail(std::exception_ptr e) noexcept = 0;
+    };
+
+    template<typename T>
+    struct fulfil {
+        std::promise<T> promise;
+
+        template<typename... Args>
+        void success(Args&&... args) {
+            promise.set_value(std::forward<Args>(args)...);
+        }
+
+        void failure(std::exception_ptr e) noexcept {
+            promise.set_exception(std::move(e));
+        }
+    };
+
+    // Callbacks have nobody to report to, so their errors are kept by the engine until the next flush
+    template<typename F>
+    struct notify {
+        F callback;
+        basic_progress_engine* engine;
+
+        template<typename... Args>
+        void success(Args&&... args) {
+            try {
+                callback(std::forward<Args>(args)...);
+            } catch(...) {
+                engine->record(std::current_exception());
+            }
+        }
+
+        void failure(std::exception_ptr e) noexcept {
+            engine->record(std::move(e));
+        }
+    };
+
+    template<typename T, typename Completion>
+    struct send_operation : operation {
+        id_type destination;
+        tag_type tag;
+        T data;
+        Completion completion;
+
+        send_operation(id_type destination, tag_type tag, T data, Completion completion)
+            : destination(destination), tag(tag), data(std::move(data)), completion(std::move(completion))
+        {
+        }
+
+        std::optional<request> start(communicator const& comm) override {
+            return comm.isend(destination, tag, data);
+        }
+
+        void complete() override {
+            completion.success();
+        }
+
+        void fail(std::exception_ptr e) noexcept override {
+            completion.failure(std::move(e));
+        }
+    };
+
+    template<typename T, typename Completion>
+    struct recv_operation : operation {
+        id_type source;
+        tag_type tag;
+        T data{};
+        Completion completion;
+
+        recv_operation(id_type source, tag_type tag, Completion completion)
+            : source(source), tag(tag), completion(std::move(completion))
+        {
+        }
+
+        // Resizable containers wait until their message has arrived, which is then matched and received at once
+        std::optional<request> start(communicator const& comm) override {
+            if constexpr(ResizableContainer<T>) {
+                return comm.try_irecv(source, tag, data);
+            } else {
+                return comm.irecv(source, tag, data);
+            }
+        }
+
+        std::optional<std::pair<id_type, tag_type>> receive_envelope() const noexcept override {
+            return std::pair{source, tag};
+        }
+
+        void complete() override {
+            completion.success(std::move(data));
+        }
+
+        void fail(std::exception_ptr e) noexcept override {
+            completion.failure(std::move(e));
+        }
+    };
+
+    communicator comm;
+    mpsc_queue<operation> submissions;
+    // Bumped after every submission, so that an idle engine thread sleeps on it instead of spinning
+    std::atomic<std::size_t> generation = 0;
+    std::atomic<std::size_t> outstanding = 0;
+    std::atomic<bool> stopping = false;
+
+    std::mutex error_mutex;
+    std::exception_ptr error;
+
+    std::thread worker;
+
+    void post(std::unique_ptr<operation> op) {
+        outstanding.fetch_add(1, std::memory_order_relaxed);
+        submissions.push(std::move(op));
+        wake();
+    }
+
+    void wake() noexcept {
+        generation.fetch_add(1, std::memory_order_release);
+        generation.notify_one();
+    }
+
+    void record(std::exception_ptr e) noexcept {
+        std::lock_guard lock(error_mutex);
+        if(!error) {
+            error = std::move(e);
+        }
+    }
+
+    void finish(std::unique_ptr<operation> const& op, std::exception_ptr e = {}) noexcept {
+        if(e) {
+            op->fail(std::move(e));
+        } else {
+            try {
+                op->complete();
+            } catch(...) {
+                op->fail(std::current_exception());
+            }
+        }
+        if(outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            outstanding.notify_all();
+        }
+    }
+
+    // Body of the engine thread, which is the only one to touch the requests
+    void run() noexcept {
+        // Operations waiting for their message to arrive, or for an earlier receive, before they can start
+        std::vector<std::unique_ptr<operation>> waiting;
+        // Started operations, and their requests at the same index
+        std::vector<std::unique_ptr<operation>> started;
+        std::vector<request> pending;
+
+        // Receives start in the order they were posted, as MPI matches them: one that waits for its message holds
+        // back the later ones that could match that same message
+        auto held_back = [&](operation const& op) {
+            const auto later = op.receive_envelope();
+            return later && std::any_of(waiting.begin(), waiting.end(), [&](auto const& w) {
+                const auto earlier = w->receive_envelope();
+                return earlier && may_match_same(*earlier, *later);
+            });
+        };
+
+        auto try_start = [&](std::unique_ptr<operation> op) {
+            if(held_back(*op)) {
+                waiting.push_back(std::move(op));
+                return;
+            }
+            try {
+                auto r = op->start(comm);
+                if(!r) {
+                    waiting.push_back(std::move(op));
+                    return;
+                }
+                started.push_back(std::move(op));
+                pending.push_back(std::move(*r));
+            } catch(...) {
+                finish(op, std::current_exception());
+            }
+        };
+
+        while(true) {
+            const auto seen = generation.load(std::memory_order_acquire);
+            const bool stop = stopping.load(std::memory_order_acquire);
+
+            for(auto& op: std::exchange(waiting, {})) {
+                try_start(std::move(op));
+            }
+            submissions.drain(try_start);
+
+            if(!pending.empty()) {
+                complete_requests(started, pending);
+            }
+
+            if(waiting.empty() && pending.empty()) {
+                if(stop) {
+                    return;
+                }
+                generation.wait(seen, std::memory_order_acquire);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    [[nodiscard]]
+    static bool may_match_same(std::pair<id_type, tag_type> a, std::pair<id_type, tag_type> b) noexcept {
+        const bool source = a.first == b.first || a.first == communicator::any_source || b.first == communicator::any_source;
+        const bool tag = a.second == b.second || a.second == communicator::any_tag || b.second == communicator::any_tag;
+        return source && tag;
+    }
+
+    // Finishes the operations whose requests completed
+    void complete_requests(std::vector<std::unique_ptr<operation>>& started, std::vector<request>& pending) noexcept {
+        if(request::test_some(pending).empty()) {
+            return;
+        }
+        erase_completed(pending, started, [this](std::unique_ptr<operation> const& op) { finish(op); });
+    }
+};
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "defines.h"
+
+namespace mpi {
+
+// RAII handle to a nonblocking operation
+template<Os OS, bool MpiEnabled>
+class basic_request;
+
+// RAII handle to a communication that is set up once and started many times
+template<Os OS, bool MpiEnabled>
+class basic_persistent_request;
+
+// Data owned by a persistent request, of a type known only to whoever set the request up. It lives on the heap, so
+// that moving the request leaves the buffer that MPI was given where it is.
+class owned_data {
+  public:
+    owned_data() noexcept = default;
+
+    template<typename T>
+    explicit owned_data(T&& value)
+        : storage(new std::remove_cvref_t<T>(std::forward<T>(value)), &destroy<std::remove_cvref_t<T>>)
+        , type(&typeid(std::remove_cvref_t<T>))
+    {
+    }
+
+    [[nodiscard]]
+    bool empty() const noexcept {
+        return storage == nullptr;
+    }
+
+    // T must be the type of the data that was stored
+    template<typename T>
+    [[nodiscard]]
+    T& get() noexcept {
+        assert(!empty() && *type == typeid(T));
+        return *static_cast<T*>(storage.get());
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    T const& get() const noexcept {
+        assert(!empty() && *type == typeid(T));
+        return *static_cast<T const*>(storage.get());
+    }
+
+  private:
+    std::unique_ptr<void, void(*)(void*)> storage {nullptr, nullptr};
+    std::type_info const* type = nullptr;
+
+    template<typename T>
+    static void destroy(void* p) noexcept {
+        delete static_cast<T*>(p);
+    }
+};
+
+// Removes the completed requests, which are inactive, along with the payload at the same index of each of them.
+// The payload of every completed request is passed to on_completed, and the rest are compacted in order.
+template<typename Request, typename Payload, typename F>
+void erase_completed(std::vector<Request>& requests, std::vector<Payload>& payloads, F&& on_completed) {
+    assert(requests.size() == payloads.size());
+    std::size_t kept = 0;
+    for(std::size_t i=0; i < requests.size(); ++i) {
+        if(!requests[i].active()) {
+            on_completed(payloads[i]);
+            continue;
+        }
+        if(kept != i) {
+            requests[kept] = std::move(requests[i]);
+            payloads[kept] = std::move(payloads[i]);
+        }
+        ++kept;
+    }
+    requests.erase(requests.begin() + static_cast<std::ptrdiff_t>(kept), requests.end());
+    payloads.erase(payloads.begin() + static_cast<std::ptrdiff_t>(kept), payloads.end());
+}
+
+}
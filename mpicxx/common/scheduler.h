@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "defines.h"
+#include "environment.h"
+#include "request.h"
+#include "task.h"
+
+namespace mpi {
+
+// Runs tasks on the calling thread. A task that awaits an incomplete request is suspended, and resumed once
+// MPI_Testsome reports the request as complete, so that a rank can keep many messages in flight while it computes.
+// When no task is ready to run, the scheduler blocks in MPI_Waitsome instead of spinning.
+template<Os OS, bool MpiEnabled>
+class basic_scheduler {
+  public:
+    using request = basic_request<OS, MpiEnabled>;
+    using environment = basic_environment<OS, MpiEnabled>;
+
+    basic_scheduler() noexcept = default;
+
+    // Suspended tasks refer to the scheduler that will resume them
+    basic_scheduler(basic_scheduler const&) = delete;
+    basic_scheduler& operator=(basic_scheduler const&) = delete;
+
+    // Runs the task, and every task it waits for, until it finishes.
+    // Returns its result, or rethrows the exception that escaped it.
+    template<typename T>
+    T run_until_complete(task<T> t) {
+        environment::assert_running();
+        struct restore {
+            basic_scheduler* previous;
+            ~restore() { current = previous; }
+        } guard{std::exchange(current, this)};
+
+        ready.push_back(t.coroutine);
+        while(!t.done()) {
+            step();
+        }
+        return t.coroutine.promise().result();
+    }
+
+    // Resumes every task that is ready, then checks once whether any pending request completed
+    void step() {
+        if(ready.empty()) {
+            if(pending.empty()) {
+                throw std::logic_error("Tasks are suspended, but no pending request can resume them");
+            }
+            resume_completed(request::wait_some(pending));
+            return;
+        }
+
+        auto batch = std::exchange(ready, {});
+        for(auto coroutine: batch) {
+            coroutine.resume();
+        }
+        if(!pending.empty()) {
+            resume_completed(request::test_some(pending));
+        }
+    }
+
+    // Number of tasks waiting for a request
+    [[nodiscard]]
+    std::size_t waiting() const noexcept {
+        return pending.size();
+    }
+
+    // Awaits the completion of a request, which is taken over and left inactive.
+    // Outside of a running scheduler, it simply blocks until the request completes.
+    class request_awaiter {
+      public:
+        explicit request_awaiter(request r) noexcept
+            : r(std::move(r))
+        {
+        }
+
+        bool await_ready() {
+            return r.test();
+        }
+
+        bool await_suspend(std::coroutine_handle<> awaiting) {
+            if(current == nullptr) {
+                r.wait();
+                return false;
+            }
+            current->pending.push_back(std::move(r));
+            current->suspended.push_back(awaiting);
+            return true;
+        }
+
+        void await_resume() const noexcept { }
+
+      private:
+        request r;
+    };
+
+    // Lets the other ready tasks run, and checks the pending requests, before the calling task continues
+    [[nodiscard]]
+    static auto yield() noexcept {
+        struct awaiter {
+            bool await_ready() const noexcept {
+                return current == nullptr;
+            }
+
+            void await_suspend(std::coroutine_handle<> awaiting) const {
+                current->ready.push_back(awaiting);
+            }
+
+            void await_resume() const noexcept { }
+        };
+        return awaiter{};
+    }
+
+    // Runs the tasks concurrently, and finishes once every one of them has.
+    // Rethrows the first exception that escaped any of them.
+    [[nodiscard]]
+    static task<void> when_all(std::vector<task<void>> tasks) {
+        co_await join(tasks.size(), [&](join_state& state) {
+            for(auto& t: tasks) {
+                run_child(t, state);
+            }
+        });
+    }
+
+    // Returns the results of the tasks in the order they were given
+    template<typename T>
+    [[nodiscard]]
+    static task<std::vector<T>> when_all(std::vector<task<T>> tasks) {
+        std::vector<std::optional<T>> results(tasks.size());
+        co_await join(tasks.size(), [&](join_state& state) {
+            for(std::size_t i=0; i < tasks.size(); ++i) {
+                run_child(tasks[i], results[i], state);
+            }
+        });
+
+        std::vector<T> values;
+        values.reserve(results.size());
+        for(auto& r: results) {
+            values.push_back(std::move(*r));
+        }
+        co_return values;
+    }
+
+  private:
+    static inline thread_local basic_scheduler* current = nullptr;
+
+    std::deque<std::coroutine_handle<>> ready;
+    // Requests awaited by suspended tasks, and the task waiting for each of them
+    std::vector<request> pending;
+    std::vector<std::coroutine_handle<>> suspended;
+
+    // Moves the tasks whose requests completed to the ready queue
+    void resume_completed(std::vector<std::size_t> const& completed) {
+        if(completed.empty()) {
+            return;
+        }
+        erase_completed(pending, suspended, [this](std::coroutine_handle<> h) { ready.push_back(h); });
+    }
+
+    // Counts the children of when_all that are still running, and resumes the parent after the last one
+    struct join_state {
+        std::size_t remaining;
+        std::coroutine_handle<> parent;
+        std::exception_ptr exception;
+
+        void fail(std::exception_ptr e) noexcept {
+            if(!exception) {
+                exception = std::move(e);
+            }
+        }
+
+        void finish() {
+            if(--remaining == 0) {
+                current->ready.push_back(parent);
+            }
+        }
+    };
+
+    template<typename F>
+    struct join_awaiter {
+        join_state state;
+        F start;
+
+        bool await_ready() const noexcept {
+            return state.remaining == 0;
+        }
+
+        // The children run right away until they first suspend, so they can all be waiting at once
+        void await_suspend(std::coroutine_handle<> parent) {
+            assert(current != nullptr);
+            state.parent = parent;
+            start(state);
+        }
+
+        void await_resume() const {
+            if(state.exception) {
+                std::rethrow_exception(state.exception);
+            }
+        }
+    };
+
+    template<typename F>
+    [[nodiscard]]
+    static join_awaiter<F> join(std::size_t count, F start) {
+        return {{count, {}, {}}, std::move(start)};
+    }
+
+    // Coroutine that starts immediately and destroys itself when it finishes
+    struct detached {
+        struct promise_type {
+            detached get_return_object() const noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept { }
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+    static detached run_child(task<void>& t, join_state& state) {
+        try {
+            co_await t;
+        } catch(...) {
+            state.fail(std::current_exception());
+        }
+        state.finish();
+    }
+
+    template<typename T>
+    static detached run_child(task<T>& t, std::optional<T>& result, join_state& state) {
+        try {
+            result.emplace(co_await t);
+        } catch(...) {
+            state.fail(std::current_exception());
+        }
+        state.finish();
+    }
+};
+
+// Suspends the calling task until the request completes
+template<Os OS, bool MpiEnabled>
+[[nodiscard]]
+auto operator co_await(basic_request<OS, MpiEnabled>&& r) noexcept {
+    return typename basic_scheduler<OS, MpiEnabled>::request_awaiter(std::move(r));
+}
+
+template<Os OS, bool MpiEnabled>
+[[nodiscard]]
+auto operator co_await(basic_request<OS, MpiEnabled>& r) noexcept {
+    return typename basic_scheduler<OS, MpiEnabled>::request_awaiter(std::move(r));
+}
+
+}
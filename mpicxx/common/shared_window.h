@@ -0,0 +1,11 @@
+#pragma once
+
+#include "defines.h"
+
+namespace mpi {
+
+// RAII handle to memory shared by all the ranks of a node
+template<Os OS, bool MpiEnabled, typename T>
+class basic_shared_window;
+
+}
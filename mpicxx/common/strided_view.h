@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace mpi {
+
+// Non-owning view of count blocks of block_length consecutive elements, whose starts are stride elements apart,
+// such as every k-th element of an array or a column of a row-major matrix. Point-to-point operations and broadcast
+// send and recieve it in place through MPI_Type_vector, without packing it into a contiguous buffer.
+template<typename T>
+class strided_view {
+  public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+
+    constexpr strided_view(T* first, std::size_t count, std::size_t stride, std::size_t block_length = 1) noexcept
+        : first(first)
+        , blocks(count)
+        , step(stride)
+        , length(block_length)
+    {
+        assert(block_length <= stride);
+    }
+
+    // Column col of a row-major matrix with the given number of columns
+    [[nodiscard]]
+    static constexpr strided_view column(std::span<T> matrix, std::size_t cols, std::size_t col) noexcept {
+        assert(cols > 0 && col < cols && matrix.size() % cols == 0);
+        return {matrix.data() + col, matrix.size() / cols, cols};
+    }
+
+    [[nodiscard]]
+    constexpr T* data() const noexcept {
+        return first;
+    }
+
+    // Number of blocks
+    [[nodiscard]]
+    constexpr std::size_t count() const noexcept {
+        return blocks;
+    }
+
+    // Distance between the starts of consecutive blocks, in elements
+    [[nodiscard]]
+    constexpr std::size_t stride() const noexcept {
+        return step;
+    }
+
+    [[nodiscard]]
+    constexpr std::size_t block_length() const noexcept {
+        return length;
+    }
+
+    // Number of elements in the view
+    [[nodiscard]]
+    constexpr std::size_t size() const noexcept {
+        return blocks * length;
+    }
+
+    [[nodiscard]]
+    constexpr T& operator[](std::size_t i) const noexcept {
+        assert(i < size());
+        return first[(i / length) * step + i % length];
+    }
+
+  private:
+    T* first;
+    std::size_t blocks;
+    std::size_t step;
+    std::size_t length;
+};
+
+}
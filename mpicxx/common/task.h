@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "defines.h"
+
+namespace mpi {
+
+template<Os OS, bool MpiEnabled>
+class basic_scheduler;
+
+template<typename T>
+class task;
+
+// Parts of the promise of a task that do not depend on its result
+class task_promise_base {
+  public:
+    // Tasks are lazy: they start running when awaited or scheduled
+    [[nodiscard]]
+    std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    // Resumes the awaiting coroutine by symmetric transfer, so that long chains of tasks do not grow the stack
+    struct final_awaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> finished) const noexcept {
+            return finished.promise().continuation;
+        }
+
+        void await_resume() const noexcept { }
+    };
+
+    [[nodiscard]]
+    final_awaiter final_suspend() const noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        exception = std::current_exception();
+    }
+
+    std::coroutine_handle<> continuation = std::noop_coroutine();
+
+  protected:
+    void rethrow_if_failed() const {
+        if(exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+  private:
+    std::exception_ptr exception;
+};
+
+template<typename T>
+class task_promise : public task_promise_base {
+  public:
+    [[nodiscard]]
+    task<T> get_return_object() noexcept {
+        return task<T>(std::coroutine_handle<task_promise>::from_promise(*this));
+    }
+
+    template<typename U>
+        requires std::convertible_to<U, T>
+    void return_value(U&& v) {
+        value.emplace(std::forward<U>(v));
+    }
+
+    // Rethrows the exception that escaped the task, if any
+    [[nodiscard]]
+    T result() {
+        rethrow_if_failed();
+        assert(value.has_value());
+        return std::move(*value);
+    }
+
+  private:
+    std::optional<T> value;
+};
+
+template<>
+class task_promise<void> : public task_promise_base {
+  public:
+    [[nodiscard]]
+    task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept { }
+
+    void result() const {
+        rethrow_if_failed();
+    }
+};
+
+// Coroutine that produces a T. Awaiting it runs it until it finishes, and returns its result or rethrows its exception.
+// A basic_scheduler runs tasks that await requests, resuming them once the requests complete.
+template<typename T = void>
+class task {
+  public:
+    using promise_type = task_promise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    explicit task(handle_type coroutine) noexcept
+        : coroutine(coroutine)
+    {
+    }
+
+    task(task const&) = delete;
+    task& operator=(task const&) = delete;
+
+    task(task&& other) noexcept
+        : coroutine(std::exchange(other.coroutine, {}))
+    {
+    }
+
+    task& operator=(task&& other) noexcept {
+        if(this != &other) {
+            destroy();
+            coroutine = std::exchange(other.coroutine, {});
+        }
+        return *this;
+    }
+
+    ~task() noexcept {
+        destroy();
+    }
+
+    [[nodiscard]]
+    bool done() const noexcept {
+        return !coroutine || coroutine.done();
+    }
+
+    [[nodiscard]]
+    auto operator co_await() noexcept {
+        struct awaiter {
+            handle_type coroutine;
+
+            bool await_ready() const noexcept {
+                return coroutine.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept {
+                coroutine.promise().continuation = awaiting;
+                return coroutine;
+            }
+
+            T await_resume() const {
+                return coroutine.promise().result();
+            }
+        };
+        assert(coroutine);
+        return awaiter{coroutine};
+    }
+
+  private:
+    template<Os, bool>
+    friend class basic_scheduler;
+
+    handle_type coroutine;
+
+    void destroy() noexcept {
+        if(coroutine) {
+            coroutine.destroy();
+        }
+    }
+};
+
+inline task<void> task_promise<void>::get_return_object() noexcept {
+    return task<void>(std::coroutine_handle<task_promise>::from_promise(*this));
+}
+
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "defines.h"
+#include "communicator.h"
+#include "environment.h"
+#include "operations.h"
+
+// Define as true to record a timeline of every call of the communicators and of every trace_region.
+// When false, the instrumentation compiles to nothing.
+#ifndef MPICXX_TRACE
+    #define MPICXX_TRACE false
+#endif
+
+// Events kept by each rank. Once full, the oldest ones are overwritten.
+#ifndef MPICXX_TRACE_CAPACITY
+    #define MPICXX_TRACE_CAPACITY (1 << 16)
+#endif
+
+namespace mpi {
+
+// Timeline of the calls and regions of this process, exported in the Chrome trace format that chrome://tracing and
+// Perfetto open. Events are stored in a ring buffer that any thread writes to without a global lock. Each slot has
+// its own flag, so that writers a multiple of the capacity apart take turns instead of tearing the event.
+//
+// With MPICXX_TRACE, every call of a communicator is traced, and the timelines of all ranks are merged into a single
+// file when the environment is finalized. The file is named by the MPICXX_TRACE_FILE environment variable
+// (mpicxx_trace.json by default).
+template<Os OS, bool MpiEnabled>
+class basic_tracer {
+  public:
+    using communicator = basic_communicator<OS, MpiEnabled>;
+    using environment = basic_environment<OS, MpiEnabled>;
+    using clock = std::chrono::steady_clock;
+
+    static constexpr bool enabled = MPICXX_TRACE;
+    static constexpr std::size_t capacity = MPICXX_TRACE_CAPACITY;
+    static_assert(capacity > 0);
+
+    // Names and categories must outlive the tracer, such as string literals
+    struct event {
+        char const* name;
+        char const* category;
+        std::int64_t begin;
+        std::int64_t end;
+        std::uint32_t thread;
+    };
+
+    static void record(char const* name, char const* category, clock::time_point begin, clock::time_point end) noexcept {
+        auto& self = singleton();
+        const auto i = self.next.fetch_add(1, std::memory_order_relaxed);
+        auto& s = self.buffer[i % capacity];
+        while(s.busy.test_and_set(std::memory_order_acquire)) { }
+        s.recorded = {name, category, nanoseconds(begin), nanoseconds(end), thread_id()};
+        s.busy.clear(std::memory_order_release);
+    }
+
+    // Events still in the buffer, oldest first. No other thread may record meanwhile.
+    [[nodiscard]]
+    static std::vector<event> events() {
+        auto& self = singleton();
+        const auto recorded = self.next.load(std::memory_order_acquire);
+        const auto kept = std::min<std::uint64_t>(recorded, capacity);
+
+        std::vector<event> out;
+        out.reserve(static_cast<std::size_t>(kept));
+        for(auto i = recorded - kept; i < recorded; ++i) {
+            out.push_back(self.buffer[i % capacity].recorded);
+        }
+        return out;
+    }
+
+    // Events that were overwritten because the buffer was full
+    [[nodiscard]]
+    static std::uint64_t dropped() noexcept {
+        const auto recorded = singleton().next.load(std::memory_order_acquire);
+        return recorded > capacity ? recorded - capacity : 0;
+    }
+
+    static void clear() noexcept {
+        singleton().next.store(0, std::memory_order_release);
+    }
+
+    // Rank 0 writes the events of every rank. Clocks are aligned on the exit of a barrier, as the clocks of
+    // different nodes start at different times. Collective.
+    static void write_trace(communicator const& comm, std::string const& path) {
+        const auto local = events();
+        const auto lost = dropped();
+
+        comm.barrier();
+        const std::int64_t local_sync = nanoseconds(clock::now());
+        std::int64_t root_sync = local_sync;
+        comm.broadcast(0, root_sync);
+        const std::int64_t offset = local_sync - root_sync;
+
+        // The timeline starts at the earliest event of any rank
+        std::int64_t first = local.empty() ? root_sync : local.front().begin - offset;
+        for(auto const& e: local) {
+            first = std::min(first, e.begin - offset);
+        }
+        std::int64_t origin;
+        comm.allreduce(first, origin, mpi::min<std::int64_t>{});
+
+        std::string text = format(comm.rank(), local, lost, offset + origin);
+        std::string all;
+        comm.gatherv(0, text, all);
+        if(comm.rank() != 0) {
+            return;
+        }
+
+        std::ofstream out(path);
+        out << "{\"traceEvents\":[\n" << all << "\n]}\n";
+    }
+
+    // Writes the trace when the environment is finalized. Every rank that uses a communicator registers it once.
+    static void trace_at_finalize() {
+        if constexpr(enabled) {
+            static const bool registered = [] {
+                environment::at_finalize([] {
+                    const char* path = std::getenv("MPICXX_TRACE_FILE");
+                    write_trace(communicator::get_default(), path ? path : "mpicxx_trace.json");
+                });
+                return true;
+            }();
+            static_cast<void>(registered);
+        }
+    }
+
+    // Traces the lifetime of a user-defined region, such as a compute phase
+    class timed_region {
+      public:
+        explicit timed_region(char const* name, char const* category = "region") noexcept
+            : name(name), category(category), start(clock::now())
+        {
+        }
+
+        timed_region(timed_region const&) = delete;
+        timed_region& operator=(timed_region const&) = delete;
+
+        ~timed_region() noexcept {
+            record(name, category, start, clock::now());
+        }
+
+      private:
+        char const* name;
+        char const* category;
+        clock::time_point start;
+    };
+
+    class null_region {
+      public:
+        constexpr explicit null_region(char const*, char const* = "region") noexcept { }
+    };
+
+    using region = std::conditional_t<enabled, timed_region, null_region>;
+
+  private:
+    struct slot {
+        std::atomic_flag busy;
+        event recorded;
+    };
+
+    std::atomic<std::uint64_t> next = 0;
+    std::unique_ptr<slot[]> buffer = std::make_unique<slot[]>(capacity);
+
+    // Never destroyed, as the trace is written by the environment, which may be destroyed after it
+    [[nodiscard]]
+    static basic_tracer& singleton() {
+        static basic_tracer* singleton_ = new basic_tracer;
+        return *singleton_;
+    }
+
+    [[nodiscard]]
+    static std::int64_t nanoseconds(clock::time_point t) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+    }
+
+    // Small number for each thread, in order of their first event
+    [[nodiscard]]
+    static std::uint32_t thread_id() noexcept {
+        static std::atomic<std::uint32_t> threads = 0;
+        thread_local const std::uint32_t id = threads.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    // Writes a name as the contents of a JSON string: quotes, backslashes and control characters are escaped
+    static void escape(std::ostream& out, char const* text) {
+        for(; *text != '\0'; ++text) {
+            const auto c = static_cast<unsigned char>(*text);
+            if(c == '"' || c == '\\') {
+                out << '\\' << *text;
+            } else if(c < 0x20) {
+                out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                    << std::dec << std::setfill(' ');
+            } else {
+                out << *text;
+            }
+        }
+    }
+
+    // Complete events of one rank, in microseconds since the origin. Every rank but the first starts with a comma,
+    // so that the gathered text is a valid list.
+    [[nodiscard]]
+    static std::string format(int rank, std::vector<event> const& local, std::uint64_t lost, std::int64_t origin) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(3);
+        if(rank != 0) {
+            out << ",\n";
+        }
+        out << R"({"name":"process_name","ph":"M","pid":)" << rank
+            << R"(,"args":{"name":"rank )" << rank << R"(","dropped_events":)" << lost << "}}";
+
+        for(auto const& e: local) {
+            out << ",\n" << R"({"name":")";
+            escape(out, e.name);
+            out << R"(","cat":")";
+            escape(out, e.category);
+            out << R"(","ph":"X","pid":)" << rank << R"(,"tid":)" << e.thread
+                << R"(,"ts":)" << static_cast<double>(e.begin - origin) * 1e-3
+                << R"(,"dur":)" << static_cast<double>(e.end - e.begin) * 1e-3 << '}';
+        }
+        return out.str();
+    }
+};
+
+}
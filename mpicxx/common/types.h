@@ -1,17 +1,73 @@
 # pragma once
 
+#include <array>
+#include <climits>
+#include <complex>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
 #include "extra_type_traits.h"
 #include "defines.h"
 
+// Largest element count passed to MPI in a single call. Longer messages are described by derived datatypes, or split
+// into several calls where derived datatypes are not allowed. Only lowered to test those paths with small buffers.
+#ifndef MPICXX_MAX_COUNT
+    #define MPICXX_MAX_COUNT INT_MAX
+#endif
+
 namespace mpi {
 
+inline constexpr std::int64_t max_count = MPICXX_MAX_COUNT;
+static_assert(max_count > 0 && max_count <= INT_MAX);
+
+// Types with a predefined MPI datatype
 template<typename T>
-concept ValidType = AnyOf<T,
+concept BuiltinType = AnyOf<T,
     short, unsigned short, int, unsigned int, long, unsigned long, long long, unsigned long long,
-    float, double, long double, char, signed char, unsigned char, wchar_t, bool>;
+    float, double, long double, char, signed char, unsigned char, wchar_t, bool,
+    std::complex<float>, std::complex<double>, std::complex<long double>>;
+
+/**
+ * Specialize this class to use a trivially copyable struct as a valid type,
+ * listing the pointers to all its members:
+ *
+ *     template<>
+ *     struct mpi::aggregate_traits<particle> {
+ *         static constexpr auto members = std::make_tuple(&particle::position, &particle::mass);
+ *     };
+ *
+ * All members must be valid types themselves.
+ */
+template<typename T>
+struct aggregate_traits;
+
+template<typename T>
+concept RegisteredAggregate = std::is_trivially_copyable_v<T> && requires { aggregate_traits<T>::members; };
+
+// Whether T can be mapped into an MPI datatype, either predefined or derived
+template<typename T>
+struct is_mapped_type : std::bool_constant<BuiltinType<T>> {};
+
+template<typename T, std::size_t S>
+struct is_mapped_type<std::array<T, S>> : is_mapped_type<T> {};
+
+template<RegisteredAggregate T>
+struct is_mapped_type<T> : std::true_type {};
+
+template<typename T>
+concept MappedType = is_mapped_type<T>::value;
+
+// Types that need a derived datatype to be built at runtime
+template<typename T>
+concept DerivedType = MappedType<T> && !BuiltinType<T>;
+
+// Types that are sent as a single element. Contiguous containers are sent element-wise instead.
+template<typename T>
+concept ValidType = MappedType<T> && !ContiguousContainer<T>;
 
 template<typename C>
-concept ValidContainer = ContiguousContainer<C> && ValidType<typename container_traits<C>::data>;
+concept ValidContainer = ContiguousContainer<C> && MappedType<typename container_traits<C>::data>;
 
 template<Os OS, bool MpiEnabled>
 struct basic_status;
@@ -19,6 +75,16 @@ struct basic_status;
 template<Os OS, bool MpiEnabled>
 struct typedefs;
 
-template<Os OS, bool MpiEnabled, ValidType T>
+// Source, tag and number of elements of a message that has arrived but has not been received yet
+template<Os OS, bool MpiEnabled>
+struct basic_envelope {
+    typename typedefs<OS, MpiEnabled>::id_type source;
+    typename typedefs<OS, MpiEnabled>::tag_type tag;
+    typename typedefs<OS, MpiEnabled>::size_type count;
+};
+
+// Implemented by template specializations.
+// Derived types have their own overload in each implementation.
+template<Os OS, bool MpiEnabled, BuiltinType T>
 constexpr typename typedefs<OS, MpiEnabled>::datatype get_datatype() noexcept;
-}
\ No newline at end of file
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "defines.h"
+
+namespace mpi {
+
+// Type of lock taken on the memory of a target rank during a passive epoch
+enum class lock_type {
+    exclusive, shared
+};
+
+// RAII handle to memory exposed to one-sided (RMA) operations
+template<Os OS, bool MpiEnabled, typename T>
+class basic_window;
+
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <ranges>
+#include <stdexcept>
+
+#include "defines.h"
+#include "communicator.h"
+#include "window.h"
+
+namespace mpi {
+
+// Order in which ranks claim work from a distributed_work_queue
+enum class claim_order {
+    global,         // All ranks claim consecutive chunks from a single counter
+    local_first     // Each rank starts with its own block, then steals from the back of the others' blocks
+};
+
+// Hands out chunks of the index space [0, total) to the ranks of a communicator, so that ranks that finish early
+// keep claiming work. Claims are one-sided atomic operations, so no rank has to act as master.
+// Construction and destruction are collective.
+template<Os OS, bool MpiEnabled>
+class basic_distributed_work_queue {
+  public:
+    using communicator = basic_communicator<OS, MpiEnabled>;
+    using window = basic_window<OS, MpiEnabled, unsigned long long>;
+    using id_type = typename communicator::id_type;
+    using index_range = std::ranges::iota_view<std::size_t, std::size_t>;
+
+    // The communicator must outlive the queue.
+    // Throws if the chunk is empty, or if a local_first queue has more indices than its blocks can hold.
+    basic_distributed_work_queue(communicator const& comm, std::size_t total, std::size_t chunk, claim_order order = claim_order::global)
+        : comm(comm)
+        , chunk(checked_chunk(chunk))
+        , order(order)
+        , total_indices(total)
+        , counters(make_counters(comm, total, order))
+        , claims(counters.lock_all())
+        , victim(comm.rank())
+    { }
+
+    // Claims the next chunk of indices, which belongs to this rank only.
+    // Returns an empty range once every index has been claimed.
+    [[nodiscard]]
+    index_range claim() {
+        if(order == claim_order::global) {
+            const unsigned long long increment = chunk;
+            unsigned long long first;
+            counters.fetch_and_op(increment, first, 0, 0, std::plus<>{});
+            counters.flush(0);
+            const auto begin = static_cast<std::size_t>(std::min(first, total_indices));
+            const auto end = static_cast<std::size_t>(std::min(first + increment, total_indices));
+            return {begin, end};
+        }
+
+        // Blocks only shrink, so the search resumes from the last block that had work
+        for(id_type visited = 0; visited < comm.size(); ++visited) {
+            auto claimed = claim_from(victim, victim == comm.rank());
+            if(!claimed.empty()) {
+                return claimed;
+            }
+            victim = (victim + 1) % comm.size();
+            if(victim == comm.rank()) {
+                break;
+            }
+        }
+        return {0, 0};
+    }
+
+  private:
+    // Blocks of local_first queues are packed as (begin << 32 | end), so that both ends are updated atomically
+    static constexpr unsigned shift = 32;
+    static constexpr unsigned long long mask = (1ull << shift) - 1;
+
+    communicator comm;
+    std::size_t chunk;
+    claim_order order;
+    unsigned long long total_indices;
+    window counters;
+    typename window::epoch claims;
+    id_type victim;
+
+    // Checked before the window is created, so that no rank enters the collective construction
+    [[nodiscard]]
+    static std::size_t checked_chunk(std::size_t chunk) {
+        if(chunk == 0) {
+            throw std::invalid_argument("Work queues must hand out chunks of at least one index");
+        }
+        return chunk;
+    }
+
+    [[nodiscard]]
+    static window make_counters(communicator const& c, std::size_t total, claim_order o) {
+        if(o == claim_order::local_first && total > mask) {
+            throw std::overflow_error("local_first work queues are limited to 2^32 - 1 indices");
+        }
+
+        window w(c, 1);
+
+        unsigned long long initial = 0;
+        if(o == claim_order::local_first) {
+            const auto ranks = static_cast<std::size_t>(c.size());
+            const auto rank = static_cast<std::size_t>(c.rank());
+            const auto begin = total * rank / ranks;
+            const auto end = total * (rank + 1) / ranks;
+            initial = (static_cast<unsigned long long>(begin) << shift) | end;
+        }
+
+        {
+            auto lock = w.lock(c.rank());
+            w.put(initial, c.rank(), 0);
+        }
+        c.barrier();
+        return w;
+    }
+
+    // Takes a chunk from the front of the block of the owner, or from the back of someone else's block
+    [[nodiscard]]
+    index_range claim_from(id_type target, bool front) {
+        // Origin buffers must stay alive until the operation is flushed
+        const unsigned long long zero = 0;
+        unsigned long long current;
+        counters.fetch_and_op(zero, current, target, 0, std::plus<>{});
+        counters.flush(target);
+
+        while(true) {
+            const auto begin = static_cast<std::size_t>(current >> shift);
+            const auto end = static_cast<std::size_t>(current & mask);
+            if(begin >= end) {
+                return {0, 0};
+            }
+
+            const auto n = std::min(chunk, end - begin);
+            const index_range claimed = front ? index_range{begin, begin + n} : index_range{end - n, end};
+            const unsigned long long desired = front
+                ? (static_cast<unsigned long long>(begin + n) << shift) | end
+                : (static_cast<unsigned long long>(begin) << shift) | (end - n);
+
+            unsigned long long previous;
+            counters.compare_and_swap(desired, current, previous, target, 0);
+            counters.flush(target);
+            if(previous == current) {
+                return claimed;
+            }
+            current = previous;
+        }
+    }
+};
+
+}
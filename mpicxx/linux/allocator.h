@@ -0,0 +1,34 @@
+#pragma once
+
+#include <mpicxx/common/defines.h>
+
+#if defined(PLATFORM_IS_LINUX) && MPI_ENABLED
+
+#include <cstddef>
+#include <new>
+
+#include <mpi.h>
+#include <mpicxx/common/allocator.h>
+
+namespace mpi {
+
+// MPI_Alloc_mem may return memory that is registered with the network, which saves pinning it on every transfer
+template<>
+inline void* basic_memory_pool<Os::Linux, true>::allocate_impl(std::size_t bytes)
+{
+    void* p;
+    if(MPI_Alloc_mem(static_cast<MPI_Aint>(bytes), MPI_INFO_NULL, &p) != MPI_SUCCESS) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+template<>
+inline void basic_memory_pool<Os::Linux, true>::deallocate_impl(void* p) noexcept
+{
+    MPI_Free_mem(p);
+}
+
+}
+
+#endif
@@ -0,0 +1,252 @@
+#pragma once
+
+#include <mpicxx/common/defines.h>
+
+// Real implementation for MPI_ENABLED==true in Linux
+#if defined(PLATFORM_IS_LINUX) && MPI_ENABLED
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <functional>
+#include <numeric>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <mpicxx/common/cartesian.h>
+#include <mpicxx/common/extra_type_traits.h>
+
+#include "communicator.h"
+#include "environment.h"
+#include "types.h"
+
+namespace mpi {
+
+template<>
+class basic_cartesian_communicator<Os::Linux, true> : public basic_communicator<Os::Linux, true> {
+  public:
+    using communicator = basic_communicator<Os::Linux, true>;
+
+    // Rank of the neighbours beyond the edge of a non-periodic dimension. Communication with it does nothing.
+    static constexpr id_type null_rank = MPI_PROC_NULL;
+
+    // Collective. Zero entries of dims are chosen with MPI_Dims_create, so that the grid is as square as possible.
+    // The grid must contain every rank of the communicator.
+    basic_cartesian_communicator(communicator const& comm, std::span<const int> dims, std::span<const bool> periodic, bool reorder = true)
+        : basic_cartesian_communicator(completed{}, comm, complete_dims(comm, dims), periodic, reorder)
+    {
+    }
+
+    [[nodiscard]]
+    int ndims() const noexcept {
+        return static_cast<int>(grid_dims.size());
+    }
+
+    // Number of ranks along each dimension
+    [[nodiscard]]
+    std::span<const int> dims() const noexcept {
+        return grid_dims;
+    }
+
+    [[nodiscard]]
+    bool periodic(int dim) const noexcept {
+        return grid_periodic[static_cast<std::size_t>(dim)];
+    }
+
+    // Coordinates of this rank, cached at construction
+    [[nodiscard]]
+    std::span<const int> coords() const noexcept {
+        return grid_coords;
+    }
+
+    [[nodiscard]]
+    std::vector<int> coords(id_type rank) const {
+        environment::assert_running();
+        std::vector<int> c(grid_dims.size());
+        MPI_Cart_coords(handle(), rank, ndims(), c.data());
+        return c;
+    }
+
+    // Rank at the given coordinates, wrapped around periodic dimensions.
+    // Returns null_rank outside of non-periodic dimensions.
+    [[nodiscard]]
+    id_type rank_at(std::span<const int> c) const {
+        environment::assert_running();
+        assert(c.size() == grid_dims.size());
+        for(std::size_t d=0; d < c.size(); ++d) {
+            if(!grid_periodic[d] && (c[d] < 0 || c[d] >= grid_dims[d])) {
+                return null_rank;
+            }
+        }
+        id_type r;
+        MPI_Cart_rank(handle(), c.data(), &r);
+        return r;
+    }
+
+    // Rank at an offset from this rank, such as {-1, 1} for the top right neighbour in 2D
+    [[nodiscard]]
+    id_type neighbour(std::span<const int> offset) const {
+        assert(offset.size() == grid_dims.size());
+        std::vector<int> c(grid_coords);
+        for(std::size_t d=0; d < c.size(); ++d) {
+            c[d] += offset[d];
+        }
+        return rank_at(c);
+    }
+
+    // Ranks to receive from and send to when data moves by displacement along a dimension
+    [[nodiscard]]
+    std::pair<id_type, id_type> shift(int dim, int displacement) const noexcept {
+        environment::assert_running();
+        id_type source, destination;
+        MPI_Cart_shift(handle(), dim, displacement, &source, &destination);
+        return {source, destination};
+    }
+
+  private:
+    std::vector<int> grid_dims;
+    std::vector<bool> grid_periodic;
+    std::vector<int> grid_coords;
+
+    // Tag for the constructor taking dimensions that were already completed with MPI_Dims_create
+    struct completed {};
+
+    basic_cartesian_communicator(completed, communicator const& comm, std::vector<int> dims, std::span<const bool> periodic, bool reorder)
+        : communicator(create(comm, dims, periodic, reorder))
+        , grid_dims(std::move(dims))
+        , grid_periodic(periodic.begin(), periodic.end())
+        , grid_coords(coords(rank()))
+    {
+    }
+
+    [[nodiscard]]
+    static std::vector<int> complete_dims(communicator const& comm, std::span<const int> dims) {
+        environment::assert_running();
+        std::vector<int> result(dims.begin(), dims.end());
+        MPI_Dims_create(comm.size(), static_cast<int>(result.size()), result.data());
+        return result;
+    }
+
+    [[nodiscard]]
+    static communicator create(communicator const& comm, std::vector<int> const& dims, std::span<const bool> periodic, bool reorder) {
+        assert(dims.size() == periodic.size());
+        assert(std::accumulate(dims.begin(), dims.end(), 1, std::multiplies<>{}) == comm.size());
+        std::vector<int> periods(periodic.begin(), periodic.end());
+        MPI_Comm c;
+        MPI_Cart_create(comm.handle(), static_cast<int>(dims.size()), dims.data(), periods.data(), reorder, &c);
+        return adopt(c);
+    }
+};
+
+// Ghost layers are exchanged with a single MPI_Neighbor_alltoallw over a graph that connects every rank to all of its
+// neighbours, corners included. Regions are described by subarray datatypes, so no data is packed by hand.
+template<mpi::ValidType T>
+class basic_halo_exchange<Os::Linux, true, T> {
+  public:
+    using cartesian_communicator = basic_cartesian_communicator<Os::Linux, true>;
+    using environment = basic_environment<Os::Linux, true>;
+    using id_type = typename cartesian_communicator::id_type;
+
+    // Collective. interior holds the extents of the block of this rank without ghost layers, in row-major order,
+    // and must have the same number of dimensions as the grid.
+    basic_halo_exchange(cartesian_communicator const& cart, std::span<const int> interior, int ghost)
+        : geometry(interior, ghost)
+    {
+        environment::assert_running();
+        assert(geometry.ndims() == cart.ndims());
+
+        // The boundary sent towards a side arrives in the halo on the opposite side of the neighbour.
+        // Sources and destinations are both listed in the order of the sides the data moves towards,
+        // which keeps the matching right when the same rank is a neighbour on several sides.
+        std::vector<id_type> sources, destinations;
+        for(auto const& side: geometry.sides()) {
+            std::vector<int> opposite(side.size());
+            std::transform(side.begin(), side.end(), opposite.begin(), std::negate<>{});
+
+            if(const id_type destination = cart.neighbour(side); destination != cartesian_communicator::null_rank) {
+                destinations.push_back(destination);
+                send_types.push_back(make_type(geometry.boundary(side)));
+            }
+            if(const id_type source = cart.neighbour(opposite); source != cartesian_communicator::null_rank) {
+                sources.push_back(source);
+                recv_types.push_back(make_type(geometry.halo(opposite)));
+            }
+        }
+
+        MPI_Dist_graph_create_adjacent(cart.handle(),
+            static_cast<int>(sources.size()), sources.data(), MPI_UNWEIGHTED,
+            static_cast<int>(destinations.size()), destinations.data(), MPI_UNWEIGHTED,
+            MPI_INFO_NULL, 0, &graph);
+
+        // Every region is described by its datatype, so all counts are one and all displacements zero
+        counts.assign(std::max(send_types.size(), recv_types.size()), 1);
+        displacements.assign(counts.size(), 0);
+    }
+
+    basic_halo_exchange(basic_halo_exchange const&) = delete;
+    basic_halo_exchange& operator=(basic_halo_exchange const&) = delete;
+
+    basic_halo_exchange(basic_halo_exchange&& other) noexcept
+        : geometry(std::move(other.geometry))
+        , graph(std::exchange(other.graph, MPI_COMM_NULL))
+        , send_types(std::move(other.send_types))
+        , recv_types(std::move(other.recv_types))
+        , counts(std::move(other.counts))
+        , displacements(std::move(other.displacements))
+    {
+    }
+
+    basic_halo_exchange& operator=(basic_halo_exchange&&) = delete;
+
+    ~basic_halo_exchange() noexcept {
+        if(graph == MPI_COMM_NULL) {
+            return;
+        }
+        // MPI cannot be called anymore after finalization
+        if(environment::stage() == environment::stages::running) {
+            for(auto& type: send_types) { MPI_Type_free(&type); }
+            for(auto& type: recv_types) { MPI_Type_free(&type); }
+            MPI_Comm_free(&graph);
+        }
+    }
+
+    [[nodiscard]]
+    halo_layout const& layout() const noexcept {
+        return geometry;
+    }
+
+    // Collective. Fills the ghost layers of the block with the boundaries of the neighbours.
+    template<mpi::ValidContainer C>
+        requires std::same_as<typename container_traits<C>::data, T>
+    void exchange(C& data) const {
+        environment::assert_running();
+        assert(container_traits<C>::size(data) == geometry.size());
+        T* buffer = container_traits<C>::pointer(data);
+        MPI_Neighbor_alltoallw(buffer, counts.data(), displacements.data(), send_types.data(),
+                               buffer, counts.data(), displacements.data(), recv_types.data(), graph);
+    }
+
+  private:
+    halo_layout geometry;
+    MPI_Comm graph = MPI_COMM_NULL;
+    std::vector<MPI_Datatype> send_types;
+    std::vector<MPI_Datatype> recv_types;
+    std::vector<int> counts;
+    std::vector<MPI_Aint> displacements;
+
+    [[nodiscard]]
+    MPI_Datatype make_type(halo_layout::region const& r) const {
+        MPI_Datatype type;
+        MPI_Type_create_subarray(geometry.ndims(), geometry.sizes().data(), r.sizes.data(), r.starts.data(),
+                                 MPI_ORDER_C, get_datatype<Os::Linux, true, T>(), &type);
+        MPI_Type_commit(&type);
+        return type;
+    }
+};
+
+}
+
+#endif
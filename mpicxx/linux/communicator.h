@@ -6,19 +6,30 @@
 #if defined(PLATFORM_IS_LINUX) && MPI_ENABLED
 
 
+#include <algorithm>
 #include <ios>
 #include <type_traits>
 #include <cassert>
 #include <sstream>
 #include <stdexcept>
 #include <memory>
+#include <utility>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <vector>
 
 #include <mpi.h>
 
 #include <mpicxx/common/extra_type_traits.h>
 #include <mpicxx/common/communicator.h>
+#include <mpicxx/common/profiler.h>
+#include <mpicxx/common/strided_view.h>
 
 #include "environment.h"
+#include "operations.h"
+#include "request.h"
 #include "types.h"
 
 namespace mpi {
@@ -31,26 +42,145 @@ class basic_communicator<Os::Linux, true> {
     using tag_type = typename typedefs<Os::Linux, true>::tag_type;
 
     using status = basic_status<Os::Linux, true>;
+    using envelope = basic_envelope<Os::Linux, true>;
     using environment = basic_environment<Os::Linux, true>;
+    using request = basic_request<Os::Linux, true>;
+    using persistent_request = basic_persistent_request<Os::Linux, true>;
+    using profiler = basic_profiler<Os::Linux, true>;
+    using tracer = basic_tracer<Os::Linux, true>;
     using handle_type = MPI_Comm;
 
+    // Wildcards for the source and tag of recv, probe and iprobe
+    static constexpr id_type any_source = MPI_ANY_SOURCE;
+    static constexpr tag_type any_tag = MPI_ANY_TAG;
+
+    // Color of the ranks that split leaves out
+    static constexpr int undefined = MPI_UNDEFINED;
+
+    // Wraps an existing handle without taking ownership of it
     explicit basic_communicator(MPI_Comm c)
         : communicator_handle(c)
     {
         environment::initialize();
+        profiler::report_at_finalize();
+        tracer::trace_at_finalize();
+        MPI_Comm_rank(communicator_handle, &communicator_rank);
+        MPI_Comm_size(communicator_handle, &communicator_size);
+
+        // The profiler identifies peers by their world rank, so the translation is only cached when profiling
+        if constexpr(profiler::enabled) {
+            if(communicator_handle != MPI_COMM_WORLD) {
+                world_ranks = std::make_shared<const std::vector<id_type>>(translate_to_world(all_ranks()));
+            }
+        }
     }
-    
-    basic_communicator(basic_communicator const& other) 
+
+    // Copies are non-owning views: they must not outlive the communicator that owns the handle
+    basic_communicator(basic_communicator const& other) noexcept
         : communicator_handle(other.communicator_handle)
+        , communicator_rank(other.communicator_rank)
+        , communicator_size(other.communicator_size)
+        , world_ranks(other.world_ranks)
     {
     }
 
+    basic_communicator(basic_communicator&& other) noexcept
+        : communicator_handle(other.communicator_handle)
+        , communicator_rank(other.communicator_rank)
+        , communicator_size(other.communicator_size)
+        , world_ranks(std::move(other.world_ranks))
+        , is_owning(std::exchange(other.is_owning, false))
+    {
+    }
+
+    basic_communicator& operator=(basic_communicator const& other) noexcept {
+        if(this != &other) {
+            free();
+            communicator_handle = other.communicator_handle;
+            communicator_rank = other.communicator_rank;
+            communicator_size = other.communicator_size;
+            world_ranks = other.world_ranks;
+        }
+        return *this;
+    }
+
+    basic_communicator& operator=(basic_communicator&& other) noexcept {
+        if(this != &other) {
+            free();
+            communicator_handle = other.communicator_handle;
+            communicator_rank = other.communicator_rank;
+            communicator_size = other.communicator_size;
+            world_ranks = std::move(other.world_ranks);
+            is_owning = std::exchange(other.is_owning, false);
+        }
+        return *this;
+    }
+
+    ~basic_communicator() noexcept {
+        free();
+    }
+
     [[nodiscard]]
     static basic_communicator get_default()
     {
         return basic_communicator{MPI_COMM_WORLD};
     }
 
+    // Communicator with the same group of ranks, but a separate communication context
+    [[nodiscard]]
+    basic_communicator dup() const
+    {
+        environment::assert_running();
+        MPI_Comm c;
+        MPI_Comm_dup(handle(), &c);
+        return adopt(c);
+    }
+
+    // Splits the ranks into one communicator per color, ordered by key.
+    // Colors must not be negative, except for undefined: those ranks are left out, and get nullopt.
+    [[nodiscard]]
+    std::optional<basic_communicator> split(int color, int key) const
+    {
+        environment::assert_running();
+        assert(color >= 0 || color == undefined);
+        MPI_Comm c;
+        MPI_Comm_split(handle(), color, key, &c);
+        if(c == MPI_COMM_NULL) {
+            return std::nullopt;
+        }
+        return adopt(c);
+    }
+
+    // Splits the ranks into one communicator per shared-memory node, ordered by key
+    [[nodiscard]]
+    basic_communicator split_shared(int key = 0) const
+    {
+        environment::assert_running();
+        MPI_Comm c;
+        MPI_Comm_split_type(handle(), MPI_COMM_TYPE_SHARED, key, MPI_INFO_NULL, &c);
+        return adopt(c);
+    }
+
+    // Whether this communicator will free its handle on destruction
+    [[nodiscard]]
+    bool owning() const noexcept
+    {
+        return is_owning;
+    }
+
+    // Frees the handle if this communicator owns it. Collective over all ranks in the communicator.
+    void free() noexcept
+    {
+        if(!std::exchange(is_owning, false)) {
+            return;
+        }
+        // MPI_Comm_free may not be called after finalization, so a communicator that outlives it only drops its handle
+        if(environment::stage() == environment::stages::running) {
+            MPI_Comm_free(&communicator_handle);
+        }
+        communicator_handle = MPI_COMM_NULL;
+    }
+
     [[nodiscard]]
     static std::string processor_name() noexcept 
     {
@@ -60,79 +190,380 @@ class basic_communicator<Os::Linux, true> {
         return name;
     }
 
+    // Rank and size are cached at construction, as they cannot change during the lifetime of a communicator
     [[nodiscard]]
-    size_type size() const noexcept
+    id_type size() const noexcept
     {
         environment::assert_running();
-        int world_size;
-        MPI_Comm_size(handle(), &world_size);
-        return world_size;
+        return communicator_size;
     }
 
     [[nodiscard]]
     id_type rank() const noexcept
     {
         environment::assert_running();
-        int world_rank;
-        MPI_Comm_rank(handle(), &world_rank);
-        return world_rank;
+        return communicator_rank;
+    }
+
+    // Rank in the world communicator of a rank of this one. Negative ranks, such as any_source, are returned as is.
+    [[nodiscard]]
+    id_type world_rank(id_type r) const
+    {
+        environment::assert_running();
+        if(r < 0 || communicator_handle == MPI_COMM_WORLD) {
+            return r;
+        }
+        if(world_ranks) {
+            return (*world_ranks)[static_cast<std::size_t>(r)];
+        }
+        return translate_to_world(std::vector<id_type>{r})[0];
     }
 
     void barrier() const noexcept
     {
         environment::assert_running();
+        const profiler::scope p(profiled_operation::barrier);
         MPI_Barrier(handle());
     }
 
+    // Completes once every rank has called it, which makes it suitable for termination detection
+    [[nodiscard]]
+    request ibarrier() const
+    {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::ibarrier);
+        request r;
+        MPI_Ibarrier(handle(), &r.handle());
+        return r;
+    }
+
     template<mpi::ValidType T>
     void send(id_type destination, tag_type tag, T& data) {
         environment::assert_running();
+        const profiler::scope p(profiled_operation::send, *this, destination, payload_bytes(data));
         MPI_Send(&data, 1u, get_datatype<Os::Linux, true, T>(), destination, tag, handle());
     }
 
     template<mpi::ValidContainer T>
     void send(id_type destination, tag_type tag, T& data) const {
         environment::assert_running();
-        MPI_Send(container_traits<T>::pointer(data),
-            static_cast<size_type>(container_traits<T>::size(data)),
-            get_datatype<Os::Linux, true, typename container_traits<T>::data>(),
+        const profiler::scope p(profiled_operation::send, *this, destination, payload_bytes(data));
+        const large_count<typename container_traits<T>::data> n(container_traits<T>::size(data));
+        MPI_Send(container_traits<T>::pointer(data), n.count(), n.datatype(),
             destination, tag, handle());
     }
 
+    // Strided views go out in place: the datatype selects their elements, so nothing is packed
+    template<typename T>
+        requires mpi::MappedType<std::remove_const_t<T>>
+    void send(id_type destination, tag_type tag, strided_view<T> data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::send, *this, destination, payload_bytes(data));
+        const strided_layout<T> layout(data);
+        MPI_Send(data.data(), 1, layout.datatype(), destination, tag, handle());
+    }
+
     template<mpi::ValidType T>
     void recv(id_type source, tag_type tag, T& data, status& status) const {
         environment::assert_running();
+        profiler::scope p(profiled_operation::recv, *this, source, payload_bytes(data));
         MPI_Recv(&data, 1u, get_datatype<Os::Linux, true, T>(), source, tag, handle(), &status.base());
+        p.set_peer(status.MPI_SOURCE);
     }
 
     template<mpi::ValidContainer T>
     void recv(id_type source, tag_type tag, T& data, status& status) const {
         environment::assert_running();
-        MPI_Recv(container_traits<T>::pointer(data),
-            static_cast<size_type>(container_traits<T>::size(data)),
-            get_datatype<Os::Linux, true, typename container_traits<T>::data>(),
+        profiler::scope p(profiled_operation::recv, *this, source, payload_bytes(data));
+        const large_count<typename container_traits<T>::data> n(container_traits<T>::size(data));
+        MPI_Recv(container_traits<T>::pointer(data), n.count(), n.datatype(),
             source, tag, handle(), &status.base());
+        p.set_peer(status.MPI_SOURCE);
+    }
+
+    // The message must have exactly as many elements as the view
+    template<mpi::MappedType T>
+    void recv(id_type source, tag_type tag, strided_view<T> data, status& status) const {
+        environment::assert_running();
+        profiler::scope p(profiled_operation::recv, *this, source, payload_bytes(data));
+        const strided_layout<T> layout(data);
+        MPI_Recv(data.data(), 1, layout.datatype(), source, tag, handle(), &status.base());
+        p.set_peer(status.MPI_SOURCE);
+    }
+
+    // The container is resized to fit the message. It is matched with MPI_Mprobe and then received with MPI_Mrecv,
+    // so that no other thread can receive it in between.
+    template<mpi::ValidContainer T>
+        requires mpi::ResizableContainer<T>
+    void recv(id_type source, tag_type tag, T& data, status& status) const {
+        environment::assert_running();
+        profiler::scope p(profiled_operation::recv, *this, source, payload_bytes(data));
+        using D = typename container_traits<T>::data;
+
+        MPI_Message message;
+        MPI_Mprobe(source, tag, handle(), &message, &status.base());
+
+        container_traits<T>::try_resize(data, static_cast<std::size_t>(element_count<D>(status.base())));
+        const large_count<D> n(container_traits<T>::size(data));
+        MPI_Mrecv(container_traits<T>::pointer(data), n.count(), n.datatype(), &message, &status.base());
+        p.set_peer(status.MPI_SOURCE);
+        p.set_bytes(payload_bytes(data));
+    }
+
+    // Blocks until a matching message arrives, and returns its envelope without receiving it. The count is in
+    // elements of T. With several threads, another one may receive the message first: prefer recv into a
+    // resizable container, which cannot race.
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    envelope probe(id_type source, tag_type tag) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::probe, *this, source, 0);
+        status s;
+        MPI_Probe(source, tag, handle(), &s.base());
+        return make_envelope<T>(s);
+    }
+
+    // Returns the envelope of a matching message if one has arrived, without blocking
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    std::optional<envelope> iprobe(id_type source, tag_type tag) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::probe, *this, source, 0);
+        status s;
+        int arrived;
+        MPI_Iprobe(source, tag, handle(), &arrived, &s.base());
+        if(!arrived) {
+            return std::nullopt;
+        }
+        return make_envelope<T>(s);
+    }
+
+    // Receives into a resizable container without blocking, if a matching message has arrived. It is matched with
+    // MPI_Improbe and then received with MPI_Imrecv, so that no other receive can take it in between. Otherwise,
+    // returns nullopt and leaves the container untouched.
+    template<mpi::ValidContainer T>
+        requires mpi::ResizableContainer<T>
+    [[nodiscard]]
+    std::optional<request> try_irecv(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        using D = typename container_traits<T>::data;
+
+        status s;
+        int arrived;
+        MPI_Message message;
+        {
+            const profiler::scope p(profiled_operation::probe, *this, source, 0);
+            MPI_Improbe(source, tag, handle(), &arrived, &message, &s.base());
+        }
+        if(!arrived) {
+            return std::nullopt;
+        }
+
+        container_traits<T>::try_resize(data, static_cast<std::size_t>(element_count<D>(s.base())));
+        const profiler::scope p(profiled_operation::irecv, *this, s.MPI_SOURCE, payload_bytes(data));
+        const large_count<D> n(container_traits<T>::size(data));
+        request r;
+        MPI_Imrecv(container_traits<T>::pointer(data), n.count(), n.datatype(), &message, &r.handle());
+        return r;
+    }
+
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    request isend(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::isend, *this, destination, payload_bytes(data));
+        request r;
+        MPI_Isend(&data, 1u, get_datatype<Os::Linux, true, T>(), destination, tag, handle(), &r.handle());
+        return r;
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    request isend(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::isend, *this, destination, payload_bytes(data));
+        request r;
+        const large_count<typename container_traits<T>::data> n(container_traits<T>::size(data));
+        MPI_Isend(container_traits<T>::pointer(data), n.count(), n.datatype(),
+            destination, tag, handle(), &r.handle());
+        return r;
+    }
+
+    template<typename T>
+        requires mpi::MappedType<std::remove_const_t<T>>
+    [[nodiscard]]
+    request isend(id_type destination, tag_type tag, strided_view<T> data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::isend, *this, destination, payload_bytes(data));
+        request r;
+        const strided_layout<T> layout(data);
+        MPI_Isend(data.data(), 1, layout.datatype(), destination, tag, handle(), &r.handle());
+        return r;
+    }
+
+    // Temporaries would be gone before the request completes, unless they are views of data that outlives them
+    template<typename T>
+        requires (!std::ranges::borrowed_range<T>)
+    request isend(id_type, tag_type, T const&&) const = delete;
+
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    request irecv(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::irecv, *this, source, payload_bytes(data));
+        request r;
+        MPI_Irecv(&data, 1u, get_datatype<Os::Linux, true, T>(), source, tag, handle(), &r.handle());
+        return r;
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    request irecv(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::irecv, *this, source, payload_bytes(data));
+        request r;
+        const large_count<typename container_traits<T>::data> n(container_traits<T>::size(data));
+        MPI_Irecv(container_traits<T>::pointer(data), n.count(), n.datatype(),
+            source, tag, handle(), &r.handle());
+        return r;
+    }
+
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    request irecv(id_type source, tag_type tag, strided_view<T> data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::irecv, *this, source, payload_bytes(data));
+        request r;
+        const strided_layout<T> layout(data);
+        MPI_Irecv(data.data(), 1, layout.datatype(), source, tag, handle(), &r.handle());
+        return r;
+    }
+
+    // Sets up a send that is started as many times as needed with persistent_request::start.
+    // The data is read at every start, so it must outlive the request and must not be resized.
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    persistent_request send_init(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        persistent_request r;
+        MPI_Send_init(&data, 1u, get_datatype<Os::Linux, true, T>(), destination, tag, handle(), &r.handle());
+        r.profile_as(profiled_operation::isend, profiled_peer(destination), payload_bytes(data));
+        return r;
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    persistent_request send_init(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        persistent_request r;
+        const large_count<typename container_traits<T>::data> n(container_traits<T>::size(data));
+        MPI_Send_init(container_traits<T>::pointer(data), n.count(), n.datatype(),
+            destination, tag, handle(), &r.handle());
+        r.bind(data);
+        r.profile_as(profiled_operation::isend, profiled_peer(destination), payload_bytes(data));
+        return r;
+    }
+
+    // Takes the data by value and keeps it inside the request, which exposes it through persistent_request::data.
+    // The buffer then lives exactly as long as the request, and is refilled through the accessor between starts.
+    template<typename T>
+        requires (!std::is_reference_v<T> && (mpi::ValidType<T> || mpi::ValidContainer<T>))
+    [[nodiscard]]
+    persistent_request send_init(id_type destination, tag_type tag, T&& data) const {
+        owned_data owned(std::move(data));
+        auto r = send_init(destination, tag, owned.template get<std::remove_cv_t<T>>());
+        r.adopt(std::move(owned));
+        return r;
+    }
+
+    // Sets up a receive that is started as many times as needed with persistent_request::start.
+    // The data is written at every start, so it must outlive the request and must not be resized.
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    persistent_request recv_init(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        persistent_request r;
+        MPI_Recv_init(&data, 1u, get_datatype<Os::Linux, true, T>(), source, tag, handle(), &r.handle());
+        r.profile_as(profiled_operation::irecv, profiled_peer(source), payload_bytes(data));
+        return r;
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    persistent_request recv_init(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        persistent_request r;
+        const large_count<typename container_traits<T>::data> n(container_traits<T>::size(data));
+        MPI_Recv_init(container_traits<T>::pointer(data), n.count(), n.datatype(),
+            source, tag, handle(), &r.handle());
+        r.bind(data);
+        r.profile_as(profiled_operation::irecv, profiled_peer(source), payload_bytes(data));
+        return r;
+    }
+
+    // Takes the data by value and keeps it inside the request, where persistent_request::data reads what was received
+    template<typename T>
+        requires (!std::is_reference_v<T> && (mpi::ValidType<T> || mpi::ValidContainer<T>))
+    [[nodiscard]]
+    persistent_request recv_init(id_type source, tag_type tag, T&& data) const {
+        owned_data owned(std::move(data));
+        auto r = recv_init(source, tag, owned.template get<std::remove_cv_t<T>>());
+        r.adopt(std::move(owned));
+        return r;
     }
 
     template<mpi::ValidType T>
     void broadcast(id_type source, T& data) const {
         environment::assert_running();
+        const profiler::scope p(profiled_operation::broadcast, profiler::no_peer, payload_bytes(data));
         MPI_Bcast(&data, 1u, get_datatype<Os::Linux, true, T>(), source, handle());
     }
 
     template<mpi::ValidContainer T>
     void broadcast(id_type source, T& data) const {
         environment::assert_running();
-        MPI_Bcast(container_traits<T>::pointer(data),
-            static_cast<size_type>(container_traits<T>::size(data)),
-            get_datatype<Os::Linux, true, typename container_traits<T>::data>(),
+        const profiler::scope p(profiled_operation::broadcast, profiler::no_peer, payload_bytes(data));
+        const large_count<typename container_traits<T>::data> n(container_traits<T>::size(data));
+        MPI_Bcast(container_traits<T>::pointer(data), n.count(), n.datatype(),
             source,
             handle());
     }
 
+    template<mpi::MappedType T>
+    void broadcast(id_type source, strided_view<T> data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::broadcast, profiler::no_peer, payload_bytes(data));
+        const strided_layout<T> layout(data);
+        MPI_Bcast(data.data(), 1, layout.datatype(), source, handle());
+    }
+
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    request ibroadcast(id_type source, T& data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::ibroadcast, profiler::no_peer, payload_bytes(data));
+        request r;
+        MPI_Ibcast(&data, 1u, get_datatype<Os::Linux, true, T>(), source, handle(), &r.handle());
+        return r;
+    }
+
+    // The container is not resized, so it must already have the size of the message in every rank
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    request ibroadcast(id_type source, T& data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::ibroadcast, profiler::no_peer, payload_bytes(data));
+        request r;
+        const large_count<typename container_traits<T>::data> n(container_traits<T>::size(data));
+        MPI_Ibcast(container_traits<T>::pointer(data), n.count(), n.datatype(),
+            source, handle(), &r.handle());
+        return r;
+    }
+
     template<mpi::ValidContainer C>
     void gather(id_type destination, typename container_traits<C>::data data, C& output) const noexcept {
         environment::assert_running(); 
+        const profiler::scope p(profiled_operation::gather, profiler::no_peer, payload_bytes(data));
         using T = typename container_traits<C>::data;
         T* recv = nullptr;
         
@@ -149,27 +580,660 @@ class basic_communicator<Os::Linux, true> {
     template<mpi::ValidContainer C>
     void gather(id_type destination, C const& data, C& output) const noexcept {
         environment::assert_running();
+        const profiler::scope p(profiled_operation::gather, profiler::no_peer, payload_bytes(data));
         using T = typename container_traits<C>::data;
         
-        const size_type msg_size = static_cast<size_type>(container_traits<C>::size(data));
+        const std::size_t msg_size = container_traits<C>::size(data);
         T const* send_ptr = container_traits<C>::pointer(data);
         
         if(rank() == destination) {
-            container_traits<C>::try_resize(output, msg_size * size());
+            container_traits<C>::try_resize(output, msg_size * static_cast<std::size_t>(size()));
         }
         T* recv_ptr = container_traits<C>::pointer(output);
 
-        MPI_Gather(send_ptr, msg_size, get_datatype<Os::Linux, true, T>(),
-                   recv_ptr, msg_size, get_datatype<Os::Linux, true, T>(),
+        const large_count<T> n(msg_size);
+        MPI_Gather(send_ptr, n.count(), n.datatype(),
+                   recv_ptr, n.count(), n.datatype(),
                    destination, handle());
     }
 
+    // In-place gather. In the destination, data holds the messages of all ranks and its own contribution must already
+    // be at its offset, so it is not copied. In the other ranks, data is the message to send.
+    template<mpi::ValidContainer C>
+    void gather(id_type destination, C& data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::gather, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t total = container_traits<C>::size(data);
+        if(rank() != destination) {
+            const large_count<T> n(total);
+            MPI_Gather(container_traits<C>::pointer(data), n.count(), n.datatype(),
+                       nullptr, 0, n.datatype(), destination, handle());
+            return;
+        }
+
+        assert(total % static_cast<std::size_t>(size()) == 0);
+        const large_count<T> n(total / static_cast<std::size_t>(size()));
+        MPI_Gather(MPI_IN_PLACE, 0, n.datatype(),
+                   container_traits<C>::pointer(data), n.count(), n.datatype(),
+                   destination, handle());
+    }
+
+    // The output is resized before returning, and filled once the request completes
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igather(id_type destination, typename container_traits<C>::data const& data, C& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::igather, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+        T* recv = nullptr;
+
+        if (rank() == destination) {
+            container_traits<C>::try_resize(output, static_cast<std::size_t>(size()));
+            recv = container_traits<C>::pointer(output);
+        }
+
+        request r;
+        MPI_Igather(&data, 1, get_datatype<Os::Linux, true, T>(),
+                    recv, 1, get_datatype<Os::Linux, true, T>(),
+                    destination, handle(), &r.handle());
+        return r;
+    }
+
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igather(id_type destination, C const& data, C& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::igather, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t msg_size = container_traits<C>::size(data);
+        if(rank() == destination) {
+            container_traits<C>::try_resize(output, msg_size * static_cast<std::size_t>(size()));
+        }
+
+        request r;
+        const large_count<T> n(msg_size);
+        MPI_Igather(container_traits<C>::pointer(data), n.count(), n.datatype(),
+                    container_traits<C>::pointer(output), n.count(), n.datatype(),
+                    destination, handle(), &r.handle());
+        return r;
+    }
+
+    // Temporaries would be gone before the request completes, unless they are views of data that outlives them
+    template<typename T, typename C>
+        requires (!std::ranges::borrowed_range<T>)
+    request igather(id_type, T const&&, C&) const = delete;
+
+    // Sends the i-th element of the data in the source rank to rank i
+    template<mpi::ValidContainer C>
+    void scatter(id_type source, C const& data, typename container_traits<C>::data& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::scatter, profiler::no_peer, payload_bytes(output));
+        using T = typename container_traits<C>::data;
+
+        T const* send_ptr = nullptr;
+        if(rank() == source) {
+            assert(container_traits<C>::size(data) >= static_cast<std::size_t>(size()));
+            send_ptr = container_traits<C>::pointer(data);
+        }
+
+        MPI_Scatter(send_ptr, 1, get_datatype<Os::Linux, true, T>(),
+                    &output, 1, get_datatype<Os::Linux, true, T>(),
+                    source, handle());
+    }
+
+    // Splits the data in the source rank into equally-sized chunks, and sends the i-th chunk to rank i.
+    // The size of the output determines the size of the chunks, so it must be the same in all ranks.
+    template<mpi::ValidContainer C>
+    void scatter(id_type source, C const& data, C& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::scatter, profiler::no_peer, payload_bytes(output));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t msg_size = container_traits<C>::size(output);
+        T const* send_ptr = nullptr;
+        if(rank() == source) {
+            assert(container_traits<C>::size(data) >= msg_size * static_cast<std::size_t>(size()));
+            send_ptr = container_traits<C>::pointer(data);
+        }
+
+        const large_count<T> n(msg_size);
+        MPI_Scatter(send_ptr, n.count(), n.datatype(),
+                    container_traits<C>::pointer(output), n.count(), n.datatype(),
+                    source, handle());
+    }
+
+    template<mpi::ValidContainer C>
+    void allgather(typename container_traits<C>::data data, C& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::allgather, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(size()));
+
+        MPI_Allgather(&data, 1, get_datatype<Os::Linux, true, T>(),
+                      container_traits<C>::pointer(output), 1, get_datatype<Os::Linux, true, T>(),
+                      handle());
+    }
+
+    // All ranks must send containers of the same size
+    template<mpi::ValidContainer C>
+    void allgather(C const& data, C& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::allgather, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size * static_cast<std::size_t>(size()));
+
+        const large_count<T> n(msg_size);
+        MPI_Allgather(container_traits<C>::pointer(data), n.count(), n.datatype(),
+                      container_traits<C>::pointer(output), n.count(), n.datatype(),
+                      handle());
+    }
+
+    // In-place allgather. Data holds the messages of all ranks, and the contribution of each rank must already be
+    // at its offset. All ranks must pass containers of the same size.
+    template<mpi::ValidContainer C>
+    void allgather(C& data) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::allgather, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t total = container_traits<C>::size(data);
+        assert(total % static_cast<std::size_t>(size()) == 0);
+
+        const large_count<T> n(total / static_cast<std::size_t>(size()));
+        MPI_Allgather(MPI_IN_PLACE, 0, n.datatype(),
+                      container_traits<C>::pointer(data), n.count(), n.datatype(),
+                      handle());
+    }
+
+    // Splits the data into equally-sized chunks, and sends the i-th chunk to rank i.
+    // The output contains the chunks recieved from every rank, in order.
+    template<mpi::ValidContainer C>
+    void alltoall(C const& data, C& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::alltoall, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t total_size = container_traits<C>::size(data);
+        assert(total_size % static_cast<std::size_t>(size()) == 0);
+        container_traits<C>::try_resize(output, total_size);
+
+        const large_count<T> n(total_size / static_cast<std::size_t>(size()));
+        MPI_Alltoall(container_traits<C>::pointer(data), n.count(), n.datatype(),
+                     container_traits<C>::pointer(output), n.count(), n.datatype(),
+                     handle());
+    }
+
+    // Sends send_counts[i] elements to rank i, taken back-to-back from the data.
+    // The output is resized once to fit all recieved messages.
+    template<mpi::ValidContainer C>
+    void alltoallv(C const& data, C& output, std::span<const size_type> send_counts) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::alltoallv, profiler::no_peer, payload_bytes(data));
+        assert(send_counts.size() == static_cast<std::size_t>(size()));
+
+        std::vector<size_type> recv_counts(static_cast<std::size_t>(size()));
+        MPI_Alltoall(send_counts.data(), 1, get_datatype<Os::Linux, true, size_type>(),
+                     recv_counts.data(), 1, get_datatype<Os::Linux, true, size_type>(),
+                     handle());
+
+        alltoallv(data, output, send_counts, recv_counts);
+    }
+
+    // Sends send_counts[i] elements to rank i, and recieves recv_counts[i] elements from rank i,
+    // skipping the size exchange.
+    template<mpi::ValidContainer C>
+    void alltoallv(C const& data, C& output, std::span<const size_type> send_counts, std::span<const size_type> recv_counts) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::alltoallv, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+        assert(send_counts.size() == static_cast<std::size_t>(size()));
+        assert(recv_counts.size() == static_cast<std::size_t>(size()));
+
+        const std::vector<size_type> send_displacements = compute_displacements(send_counts);
+        const std::vector<size_type> recv_displacements = compute_displacements(recv_counts);
+        assert(container_traits<C>::size(data) >= static_cast<std::size_t>(send_displacements.back() + send_counts.back()));
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(recv_displacements.back() + recv_counts.back()));
+
+        MPI_Alltoallv(container_traits<C>::pointer(data), narrow_counts(send_counts).data(), narrow_counts(send_displacements).data(),
+                      get_datatype<Os::Linux, true, T>(),
+                      container_traits<C>::pointer(output), narrow_counts(recv_counts).data(), narrow_counts(recv_displacements).data(),
+                      get_datatype<Os::Linux, true, T>(),
+                      handle());
+    }
+
+    // Gathers containers of different sizes. The output is resized once to fit all messages.
+    template<mpi::ValidContainer C>
+    void gatherv(id_type destination, C const& data, C& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::gatherv, profiler::no_peer, payload_bytes(data));
+        const auto msg_size = static_cast<size_type>(container_traits<C>::size(data));
+
+        std::vector<size_type> counts;
+        if(rank() == destination) {
+            counts.resize(static_cast<std::size_t>(size()));
+        }
+        MPI_Gather(&msg_size, 1, get_datatype<Os::Linux, true, size_type>(),
+                   counts.data(), 1, get_datatype<Os::Linux, true, size_type>(),
+                   destination, handle());
+
+        gatherv(destination, data, output, counts);
+    }
+
+    // Gathers containers of different sizes, skipping the size exchange.
+    // The message size of every rank must be provided in counts. Counts are only read at the destination.
+    template<mpi::ValidContainer C>
+    void gatherv(id_type destination, C const& data, C& output, std::span<const size_type> counts) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::gatherv, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        std::vector<size_type> displacements;
+        T* recv_ptr = nullptr;
+        if(rank() == destination) {
+            assert(counts.size() == static_cast<std::size_t>(size()));
+            displacements = compute_displacements(counts);
+            container_traits<C>::try_resize(output, static_cast<std::size_t>(displacements.back() + counts.back()));
+            recv_ptr = container_traits<C>::pointer(output);
+        }
+
+        const large_count<T> n(container_traits<C>::size(data));
+        MPI_Gatherv(container_traits<C>::pointer(data), n.count(), n.datatype(),
+                    recv_ptr, narrow_counts(counts).data(), narrow_counts(displacements).data(), get_datatype<Os::Linux, true, T>(),
+                    destination, handle());
+    }
+
+    // Nonblocking gatherv. Message sizes are gathered before returning, so only the data transfer overlaps.
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igatherv(id_type destination, C const& data, C& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::igatherv, profiler::no_peer, payload_bytes(data));
+        const auto msg_size = static_cast<size_type>(container_traits<C>::size(data));
+
+        std::vector<size_type> counts;
+        if(rank() == destination) {
+            counts.resize(static_cast<std::size_t>(size()));
+        }
+        MPI_Gather(&msg_size, 1, get_datatype<Os::Linux, true, size_type>(),
+                   counts.data(), 1, get_datatype<Os::Linux, true, size_type>(),
+                   destination, handle());
+
+        return igatherv(destination, data, output, counts);
+    }
+
+    // Nonblocking gatherv with known message sizes
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igatherv(id_type destination, C const& data, C& output, std::span<const size_type> counts) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::igatherv, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        std::vector<size_type> displacements;
+        T* recv_ptr = nullptr;
+        if(rank() == destination) {
+            assert(counts.size() == static_cast<std::size_t>(size()));
+            displacements = compute_displacements(counts);
+            container_traits<C>::try_resize(output, static_cast<std::size_t>(displacements.back() + counts.back()));
+            recv_ptr = container_traits<C>::pointer(output);
+        }
+
+        // MPI reads the counts and displacements until the request completes, so the request keeps them
+        std::vector<int> recv_counts = narrow_counts(counts);
+        std::vector<int> recv_displacements = narrow_counts(displacements);
+
+        request r;
+        const large_count<T> n(container_traits<C>::size(data));
+        MPI_Igatherv(container_traits<C>::pointer(data), n.count(), n.datatype(),
+                     recv_ptr, recv_counts.data(), recv_displacements.data(), get_datatype<Os::Linux, true, T>(),
+                     destination, handle(), &r.handle());
+        r.attach(std::move(recv_counts));
+        r.attach(std::move(recv_displacements));
+        return r;
+    }
+
+    // Gathers containers of different sizes into all ranks. The output is resized once to fit all messages.
+    template<mpi::ValidContainer C>
+    void allgatherv(C const& data, C& output) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::allgatherv, profiler::no_peer, payload_bytes(data));
+        const auto msg_size = static_cast<size_type>(container_traits<C>::size(data));
+
+        std::vector<size_type> counts(static_cast<std::size_t>(size()));
+        MPI_Allgather(&msg_size, 1, get_datatype<Os::Linux, true, size_type>(),
+                      counts.data(), 1, get_datatype<Os::Linux, true, size_type>(),
+                      handle());
+
+        allgatherv(data, output, counts);
+    }
+
+    // Gathers containers of different sizes into all ranks, skipping the size exchange.
+    // The message size of every rank must be provided in counts, and be the same in all ranks.
+    template<mpi::ValidContainer C>
+    void allgatherv(C const& data, C& output, std::span<const size_type> counts) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::allgatherv, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+        assert(counts.size() == static_cast<std::size_t>(size()));
+
+        const std::vector<size_type> displacements = compute_displacements(counts);
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(displacements.back() + counts.back()));
+
+        const large_count<T> n(container_traits<C>::size(data));
+        MPI_Allgatherv(container_traits<C>::pointer(data), n.count(), n.datatype(),
+                       container_traits<C>::pointer(output), narrow_counts(counts).data(), narrow_counts(displacements).data(),
+                       get_datatype<Os::Linux, true, T>(),
+                       handle());
+    }
+
+    // Splits the data in the source rank as evenly as possible among all ranks.
+    // Lower ranks get the extra elements when the size is not divisible by the number of ranks.
+    template<mpi::ValidContainer C>
+    void scatterv(id_type source, C const& data, C& output) const {
+        environment::assert_running();
+        profiler::scope p(profiled_operation::scatterv);
+
+        auto total_size = static_cast<size_type>(rank() == source ? container_traits<C>::size(data) : 0);
+        MPI_Bcast(&total_size, 1, get_datatype<Os::Linux, true, size_type>(), source, handle());
+
+        std::vector<size_type> counts(static_cast<std::size_t>(size()), total_size / size());
+        std::for_each(counts.begin(), counts.begin() + total_size % size(), [](size_type& c) { ++c; });
+
+        scatterv(source, data, output, counts);
+        p.set_bytes(payload_bytes(output));
+    }
+
+    // Splits the data in the source rank, sending counts[i] elements to rank i.
+    // Counts must be the same in all ranks. The output is resized to fit the message.
+    template<mpi::ValidContainer C>
+    void scatterv(id_type source, C const& data, C& output, std::span<const size_type> counts) const {
+        environment::assert_running();
+        profiler::scope p(profiled_operation::scatterv);
+        using T = typename container_traits<C>::data;
+        assert(counts.size() == static_cast<std::size_t>(size()));
+
+        std::vector<size_type> displacements;
+        T const* send_ptr = nullptr;
+        if(rank() == source) {
+            displacements = compute_displacements(counts);
+            assert(container_traits<C>::size(data) >= static_cast<std::size_t>(displacements.back() + counts.back()));
+            send_ptr = container_traits<C>::pointer(data);
+        }
+
+        const size_type msg_size = counts[static_cast<std::size_t>(rank())];
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(msg_size));
+
+        const large_count<T> n(static_cast<std::size_t>(msg_size));
+        MPI_Scatterv(send_ptr, narrow_counts(counts).data(), narrow_counts(displacements).data(), get_datatype<Os::Linux, true, T>(),
+                     container_traits<C>::pointer(output), n.count(), n.datatype(),
+                     source, handle());
+        p.set_bytes(payload_bytes(output));
+    }
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void reduce(id_type destination, T const& data, T& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::reduce, profiler::no_peer, payload_bytes(data));
+        MPI_Reduce(&data, &output, 1, get_datatype<Os::Linux, true, T>(), get_operation<T, Op>(), destination, handle());
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void reduce(id_type destination, C const& data, C& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::reduce, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t msg_size = container_traits<C>::size(data);
+        T* recv_ptr = nullptr;
+        if(rank() == destination) {
+            container_traits<C>::try_resize(output, msg_size);
+            recv_ptr = container_traits<C>::pointer(output);
+        }
+
+        in_pieces(msg_size, [&](std::size_t offset, int count) {
+            MPI_Reduce(container_traits<C>::pointer(data) + offset, recv_ptr ? recv_ptr + offset : nullptr,
+                       count, get_datatype<Os::Linux, true, T>(),
+                       get_operation<T, Op>(), destination, handle());
+        });
+    }
+
+    // In-place reduction: the result overwrites the data in the destination, and the data of other ranks is left unmodified
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void reduce(id_type destination, T& data, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::reduce, profiler::no_peer, payload_bytes(data));
+        const bool in_place = rank() == destination;
+        MPI_Reduce(in_place ? MPI_IN_PLACE : &data, in_place ? &data : nullptr,
+                   1, get_datatype<Os::Linux, true, T>(), get_operation<T, Op>(), destination, handle());
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void reduce(id_type destination, C& data, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::reduce, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const bool in_place = rank() == destination;
+        T* ptr = container_traits<C>::pointer(data);
+        in_pieces(container_traits<C>::size(data), [&](std::size_t offset, int count) {
+            MPI_Reduce(in_place ? MPI_IN_PLACE : ptr + offset, in_place ? ptr + offset : nullptr,
+                       count, get_datatype<Os::Linux, true, T>(),
+                       get_operation<T, Op>(), destination, handle());
+        });
+    }
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void allreduce(T const& data, T& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::allreduce, profiler::no_peer, payload_bytes(data));
+        MPI_Allreduce(&data, &output, 1, get_datatype<Os::Linux, true, T>(), get_operation<T, Op>(), handle());
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void allreduce(C const& data, C& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::allreduce, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size);
+
+        in_pieces(msg_size, [&](std::size_t offset, int count) {
+            MPI_Allreduce(container_traits<C>::pointer(data) + offset, container_traits<C>::pointer(output) + offset,
+                          count, get_datatype<Os::Linux, true, T>(),
+                          get_operation<T, Op>(), handle());
+        });
+    }
+
+    // In-place reduction: the result overwrites the data in every rank, so no second buffer is needed
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void allreduce(T& data, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::allreduce, profiler::no_peer, payload_bytes(data));
+        MPI_Allreduce(MPI_IN_PLACE, &data, 1, get_datatype<Os::Linux, true, T>(), get_operation<T, Op>(), handle());
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void allreduce(C& data, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::allreduce, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        T* ptr = container_traits<C>::pointer(data);
+        in_pieces(container_traits<C>::size(data), [&](std::size_t offset, int count) {
+            MPI_Allreduce(MPI_IN_PLACE, ptr + offset, count, get_datatype<Os::Linux, true, T>(),
+                          get_operation<T, Op>(), handle());
+        });
+    }
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    [[nodiscard]]
+    request iallreduce(T const& data, T& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::iallreduce, profiler::no_peer, payload_bytes(data));
+        request r;
+        MPI_Iallreduce(&data, &output, 1, get_datatype<Os::Linux, true, T>(), get_operation<T, Op>(), handle(), &r.handle());
+        return r;
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    [[nodiscard]]
+    request iallreduce(C const& data, C& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::iallreduce, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        // A single request cannot be split into pieces like the blocking reductions
+        const std::size_t msg_size = container_traits<C>::size(data);
+        if(static_cast<std::int64_t>(msg_size) > max_count) {
+            throw std::overflow_error("iallreduce is limited to max_count elements");
+        }
+        container_traits<C>::try_resize(output, msg_size);
+
+        request r;
+        MPI_Iallreduce(container_traits<C>::pointer(data), container_traits<C>::pointer(output),
+                       static_cast<int>(msg_size), get_datatype<Os::Linux, true, T>(),
+                       get_operation<T, Op>(), handle(), &r.handle());
+        return r;
+    }
+
+    // Temporaries would be gone before the request completes, unless they are views of data that outlives them
+    template<typename T, typename C, typename Op>
+        requires (!std::ranges::borrowed_range<T>)
+    request iallreduce(T const&&, C&, Op) const = delete;
+
+    // Inclusive prefix reduction: rank i obtains the reduction of the data in ranks 0 to i
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void scan(T const& data, T& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::scan, profiler::no_peer, payload_bytes(data));
+        MPI_Scan(&data, &output, 1, get_datatype<Os::Linux, true, T>(), get_operation<T, Op>(), handle());
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void scan(C const& data, C& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::scan, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size);
+
+        in_pieces(msg_size, [&](std::size_t offset, int count) {
+            MPI_Scan(container_traits<C>::pointer(data) + offset, container_traits<C>::pointer(output) + offset,
+                     count, get_datatype<Os::Linux, true, T>(),
+                     get_operation<T, Op>(), handle());
+        });
+    }
+
+    // Exclusive prefix reduction: rank i obtains the reduction of the data in ranks 0 to i-1.
+    // The output in rank 0 is undefined, as MPI_Exscan may overwrite it.
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void exscan(T const& data, T& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::exscan, profiler::no_peer, payload_bytes(data));
+        MPI_Exscan(&data, &output, 1, get_datatype<Os::Linux, true, T>(), get_operation<T, Op>(), handle());
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void exscan(C const& data, C& output, Op) const {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::exscan, profiler::no_peer, payload_bytes(data));
+        using T = typename container_traits<C>::data;
+
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size);
+
+        in_pieces(msg_size, [&](std::size_t offset, int count) {
+            MPI_Exscan(container_traits<C>::pointer(data) + offset, container_traits<C>::pointer(output) + offset,
+                       count, get_datatype<Os::Linux, true, T>(),
+                       get_operation<T, Op>(), handle());
+        });
+    }
+
     handle_type handle() const noexcept {
         return communicator_handle;
     }
 
+  protected:
+    // Wraps a handle that was just created, and frees it on destruction
+    [[nodiscard]]
+    static basic_communicator adopt(handle_type c)
+    {
+        basic_communicator comm{c};
+        comm.is_owning = true;
+        return comm;
+    }
+
   private:
     handle_type communicator_handle;
+    id_type communicator_rank;
+    id_type communicator_size;
+    // World rank of every rank, shared by the copies of the communicator. Only cached when profiling.
+    std::shared_ptr<const std::vector<id_type>> world_ranks;
+    bool is_owning = false;
+
+    [[nodiscard]]
+    std::vector<id_type> all_ranks() const {
+        std::vector<id_type> ranks(static_cast<std::size_t>(communicator_size));
+        std::iota(ranks.begin(), ranks.end(), id_type{0});
+        return ranks;
+    }
+
+    [[nodiscard]]
+    std::vector<id_type> translate_to_world(std::vector<id_type> const& ranks) const {
+        MPI_Group group;
+        MPI_Group world;
+        MPI_Comm_group(communicator_handle, &group);
+        MPI_Comm_group(MPI_COMM_WORLD, &world);
+        std::vector<id_type> translated(ranks.size());
+        MPI_Group_translate_ranks(group, static_cast<int>(ranks.size()), ranks.data(), world, translated.data());
+        MPI_Group_free(&group);
+        MPI_Group_free(&world);
+        return translated;
+    }
+
+    // Persistent requests outlive the communicator, so the peer of their starts is translated when they are set up
+    [[nodiscard]]
+    id_type profiled_peer(id_type r) const {
+        if constexpr(profiler::enabled) {
+            return world_rank(r);
+        } else {
+            return r;
+        }
+    }
+
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    static envelope make_envelope(status& s) {
+        return {s.MPI_SOURCE, s.MPI_TAG, element_count<T>(s.base())};
+    }
+
+    // Calls reduction(offset, count) on consecutive pieces of at most max_count elements, and at least once.
+    // Builtin operations cannot be applied to the derived datatypes that describe longer messages.
+    template<typename F>
+    static void in_pieces(std::size_t total, F&& reduction) {
+        std::size_t offset = 0;
+        do {
+            const std::size_t count = std::min(total - offset, static_cast<std::size_t>(max_count));
+            reduction(offset, static_cast<int>(count));
+            offset += count;
+        } while(offset < total);
+    }
+
+    // Offset of each rank's message in a buffer where messages are stored back-to-back
+    [[nodiscard]]
+    static std::vector<size_type> compute_displacements(std::span<const size_type> counts) {
+        std::vector<size_type> displacements(counts.size());
+        std::exclusive_scan(counts.begin(), counts.end(), displacements.begin(), size_type{0});
+        return displacements;
+    }
 };
 
 }
@@ -10,9 +10,19 @@
 namespace mpi {
 
 template<>
-inline void basic_environment<Os::Linux, true>::initialize_impl()
+inline threading basic_environment<Os::Linux, true>::initialize_impl(threading required)
 {
-    MPI_Init(NULL, NULL);
+    const int levels[] = {MPI_THREAD_SINGLE, MPI_THREAD_FUNNELED, MPI_THREAD_SERIALIZED, MPI_THREAD_MULTIPLE};
+
+    int provided;
+    MPI_Init_thread(NULL, NULL, levels[static_cast<int>(required)], &provided);
+
+    switch (provided) {
+        case MPI_THREAD_FUNNELED:   return threading::funneled;
+        case MPI_THREAD_SERIALIZED: return threading::serialized;
+        case MPI_THREAD_MULTIPLE:   return threading::multiple;
+    }
+    return threading::single;
 }
 
 template<>
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <mpicxx/common/defines.h>
+
+// Real implementation for MPI_ENABLED==true in Linux
+#if defined(PLATFORM_IS_LINUX) && MPI_ENABLED
+
+#include <mpi.h>
+
+#include <mpicxx/common/operations.h>
+#include <mpicxx/common/types.h>
+
+#include "environment.h"
+
+namespace mpi {
+
+[[nodiscard]] inline MPI_Op get_builtin_operation_handle(builtin_operation op) noexcept {
+    switch(op) {
+        case builtin_operation::sum:         return MPI_SUM;
+        case builtin_operation::prod:        return MPI_PROD;
+        case builtin_operation::min:         return MPI_MIN;
+        case builtin_operation::max:         return MPI_MAX;
+        case builtin_operation::logical_and: return MPI_LAND;
+        case builtin_operation::logical_or:  return MPI_LOR;
+        case builtin_operation::bit_and:     return MPI_BAND;
+        case builtin_operation::bit_or:      return MPI_BOR;
+        case builtin_operation::bit_xor:     return MPI_BXOR;
+        case builtin_operation::none:        break;
+    }
+    return MPI_OP_NULL;
+}
+
+// Callback with the signature MPI_Op_create expects. MPI computes inout[i] = in[i] op inout[i],
+// where in belongs to the lower rank, so the argument order matters for non-commutative operations.
+template<MappedType T, ReduceOperation<T> Op>
+void user_operation_callback(void* in, void* inout, int* len, MPI_Datatype*) {
+    const Op op{};
+    T const* lhs = static_cast<T const*>(in);
+    T* rhs = static_cast<T*>(inout);
+    for(int i=0; i < *len; ++i) {
+        rhs[i] = static_cast<T>(op(lhs[i], rhs[i]));
+    }
+}
+
+// Returns the MPI operation equivalent to Op acting on T.
+// User-defined operations are created once and freed at finalization.
+template<MappedType T, ReduceOperation<T> Op>
+[[nodiscard]] MPI_Op get_operation() {
+    constexpr builtin_operation builtin = get_builtin_operation<Op, T>();
+    if constexpr (builtin != builtin_operation::none) {
+        return get_builtin_operation_handle(builtin);
+    } else {
+        static const MPI_Op op = []() {
+            MPI_Op handle;
+            MPI_Op_create(&user_operation_callback<T, Op>, is_commutative<Op>::value, &handle);
+            basic_environment<Os::Linux, true>::at_finalize([handle]() mutable { MPI_Op_free(&handle); });
+            return handle;
+        }();
+        return op;
+    }
+}
+
+}
+
+#endif
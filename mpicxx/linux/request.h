@@ -0,0 +1,390 @@
+#pragma once
+
+#include <mpicxx/common/defines.h>
+
+// Real implementation for MPI_ENABLED==true in Linux
+#if defined(PLATFORM_IS_LINUX) && MPI_ENABLED
+
+#include <cassert>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <mpicxx/common/extra_type_traits.h>
+#include <mpicxx/common/profiler.h>
+#include <mpicxx/common/request.h>
+
+#include "environment.h"
+#include "types.h"
+
+namespace mpi {
+
+template<>
+class basic_request<Os::Linux, true> {
+  public:
+    using status = basic_status<Os::Linux, true>;
+    using environment = basic_environment<Os::Linux, true>;
+    using profiler = basic_profiler<Os::Linux, true>;
+    using handle_type = MPI_Request;
+
+    basic_request() noexcept = default;
+
+    explicit basic_request(handle_type r) noexcept
+        : request_handle(r)
+    {
+    }
+
+    basic_request(basic_request const&) = delete;
+    basic_request& operator=(basic_request const&) = delete;
+
+    basic_request(basic_request&& other) noexcept
+        : request_handle(std::exchange(other.request_handle, MPI_REQUEST_NULL))
+        , arguments(std::move(other.arguments))
+    {
+    }
+
+    basic_request& operator=(basic_request&& other) noexcept {
+        if(this != &other) {
+            wait();
+            request_handle = std::exchange(other.request_handle, MPI_REQUEST_NULL);
+            arguments = std::move(other.arguments);
+        }
+        return *this;
+    }
+
+    // Pending operations are completed before releasing the handle, so
+    // that buffers are never left attached to a forgotten request
+    ~basic_request() noexcept {
+        wait();
+    }
+
+    [[nodiscard]]
+    bool active() const noexcept {
+        return request_handle != MPI_REQUEST_NULL;
+    }
+
+    // Waits are timed, so that the time blocked on a nonblocking operation shows up in the profile and the trace
+    void wait() noexcept {
+        if(!active()) {
+            return;
+        }
+        const profiler::scope p(profiled_operation::wait);
+        MPI_Wait(&request_handle, MPI_STATUS_IGNORE);
+    }
+
+    void wait(status& status) noexcept {
+        const profiler::scope p(profiled_operation::wait);
+        MPI_Wait(&request_handle, &status.base());
+    }
+
+    [[nodiscard]]
+    bool test() noexcept {
+        int flag;
+        MPI_Test(&request_handle, &flag, MPI_STATUS_IGNORE);
+        return flag;
+    }
+
+    [[nodiscard]]
+    bool test(status& status) noexcept {
+        int flag;
+        MPI_Test(&request_handle, &flag, &status.base());
+        return flag;
+    }
+
+    // Blocks until every request is complete
+    static void wait_all(std::span<basic_request> requests) {
+        environment::assert_running();
+        auto handles = gather_handles(requests);
+        const profiler::scope p(profiled_operation::wait);
+        MPI_Waitall(static_cast<int>(handles.size()), handles.data(), MPI_STATUSES_IGNORE);
+        scatter_handles(handles, requests);
+    }
+
+    // Blocks until one request is complete, and returns its index.
+    // Returns nullopt if none of the requests were active.
+    static std::optional<std::size_t> wait_any(std::span<basic_request> requests) {
+        environment::assert_running();
+        auto handles = gather_handles(requests);
+        const profiler::scope p(profiled_operation::wait);
+        int index;
+        MPI_Waitany(static_cast<int>(handles.size()), handles.data(), &index, MPI_STATUS_IGNORE);
+        scatter_handles(handles, requests);
+
+        if(index == MPI_UNDEFINED) {
+            return {};
+        }
+        return static_cast<std::size_t>(index);
+    }
+
+    // Blocks until at least one request is complete, and returns the indices of all completed requests.
+    // Returns an empty vector if none of the requests were active.
+    static std::vector<std::size_t> wait_some(std::span<basic_request> requests) {
+        environment::assert_running();
+        auto handles = gather_handles(requests);
+        std::vector<int> indices(handles.size());
+        const profiler::scope p(profiled_operation::wait);
+        int count;
+        MPI_Waitsome(static_cast<int>(handles.size()), handles.data(), &count, indices.data(), MPI_STATUSES_IGNORE);
+        scatter_handles(handles, requests);
+
+        if(count == MPI_UNDEFINED) {
+            return {};
+        }
+        return {indices.begin(), indices.begin() + count};
+    }
+
+    // Returns the indices of the requests that completed, without blocking.
+    // Returns an empty vector if none of the requests were active.
+    static std::vector<std::size_t> test_some(std::span<basic_request> requests) {
+        environment::assert_running();
+        auto handles = gather_handles(requests);
+        std::vector<int> indices(handles.size());
+        int count;
+        MPI_Testsome(static_cast<int>(handles.size()), handles.data(), &count, indices.data(), MPI_STATUSES_IGNORE);
+        scatter_handles(handles, requests);
+
+        if(count == MPI_UNDEFINED) {
+            return {};
+        }
+        return {indices.begin(), indices.begin() + count};
+    }
+
+    [[nodiscard]]
+    handle_type& handle() noexcept {
+        return request_handle;
+    }
+
+    // Keeps an argument array alive until the request is destroyed, as nonblocking collectives
+    // read counts and displacements until they complete
+    void attach(std::vector<int> argument) {
+        arguments.push_back(std::move(argument));
+    }
+
+  private:
+    handle_type request_handle = MPI_REQUEST_NULL;
+    std::vector<std::vector<int>> arguments;
+
+    static std::vector<handle_type> gather_handles(std::span<basic_request> requests) {
+        std::vector<handle_type> handles(requests.size());
+        for(std::size_t i=0; i < requests.size(); ++i) {
+            handles[i] = requests[i].request_handle;
+        }
+        return handles;
+    }
+
+    static void scatter_handles(std::vector<handle_type> const& handles, std::span<basic_request> requests) noexcept {
+        assert(handles.size() == requests.size());
+        for(std::size_t i=0; i < requests.size(); ++i) {
+            requests[i].request_handle = handles[i];
+        }
+    }
+};
+
+template<>
+class basic_persistent_request<Os::Linux, true> {
+  public:
+    using status = basic_status<Os::Linux, true>;
+    using environment = basic_environment<Os::Linux, true>;
+    using profiler = basic_profiler<Os::Linux, true>;
+    using handle_type = MPI_Request;
+
+    basic_persistent_request() noexcept = default;
+
+    basic_persistent_request(basic_persistent_request const&) = delete;
+    basic_persistent_request& operator=(basic_persistent_request const&) = delete;
+
+    basic_persistent_request(basic_persistent_request&& other) noexcept
+        : request_handle(std::exchange(other.request_handle, MPI_REQUEST_NULL))
+        , started(std::exchange(other.started, false))
+        , bound(std::exchange(other.bound, {}))
+        , owned(std::move(other.owned))
+        , profiled(other.profiled)
+    {
+    }
+
+    basic_persistent_request& operator=(basic_persistent_request&& other) noexcept {
+        if(this != &other) {
+            free();
+            request_handle = std::exchange(other.request_handle, MPI_REQUEST_NULL);
+            started = std::exchange(other.started, false);
+            bound = std::exchange(other.bound, {});
+            owned = std::move(other.owned);
+            profiled = other.profiled;
+        }
+        return *this;
+    }
+
+    // A started communication is completed before the request is freed
+    ~basic_persistent_request() noexcept {
+        free();
+    }
+
+    // Whether the communication was started and has not been completed yet
+    [[nodiscard]]
+    bool active() const noexcept {
+        return started;
+    }
+
+    void start() noexcept {
+        environment::assert_running();
+        assert(!started);
+        assert(bound.unchanged());
+        const profiler::scope p(profiled.op, profiled.peer, profiled.bytes);
+        MPI_Start(&request_handle);
+        started = true;
+    }
+
+    void wait() noexcept {
+        if(!started) {
+            return;
+        }
+        const profiler::scope p(profiled_operation::wait);
+        MPI_Wait(&request_handle, MPI_STATUS_IGNORE);
+        started = false;
+    }
+
+    void wait(status& status) noexcept {
+        const profiler::scope p(profiled_operation::wait);
+        MPI_Wait(&request_handle, &status.base());
+        started = false;
+    }
+
+    [[nodiscard]]
+    bool test() noexcept {
+        if(!started) {
+            return true;
+        }
+        int flag;
+        MPI_Test(&request_handle, &flag, MPI_STATUS_IGNORE);
+        started = !flag;
+        return flag;
+    }
+
+    // Starts every request at once. When calls are profiled, the requests are started one by one instead, which MPI
+    // defines as equivalent, so that each start is recorded with its own peer and size.
+    static void start_all(std::span<basic_persistent_request> requests) {
+        environment::assert_running();
+        if constexpr(!std::is_empty_v<profiler::scope>) {
+            for(auto& r: requests) {
+                r.start();
+            }
+        } else {
+            auto handles = gather_handles(requests);
+            for(auto& r: requests) {
+                assert(!r.started);
+                assert(r.bound.unchanged());
+                r.started = true;
+            }
+            MPI_Startall(static_cast<int>(handles.size()), handles.data());
+        }
+    }
+
+    // Blocks until every request is complete. Requests that were not started are ignored.
+    static void wait_all(std::span<basic_persistent_request> requests) {
+        environment::assert_running();
+        auto handles = gather_handles(requests);
+        const profiler::scope p(profiled_operation::wait);
+        MPI_Waitall(static_cast<int>(handles.size()), handles.data(), MPI_STATUSES_IGNORE);
+        for(auto& r: requests) {
+            r.started = false;
+        }
+    }
+
+    // Records the container the request transfers, so that debug builds detect it being resized before the request
+    // is started again. The container must outlive the request, which reads its buffer at every start, so a container
+    // destroyed in between is not detected: the check itself would then read freed memory.
+    template<ContiguousContainer C>
+    void bind(C const& container) noexcept {
+        bound = {&container, container_traits<C>::pointer(container), container_traits<C>::size(container),
+                 &binding::template same_buffer<C>};
+    }
+
+    // Operation, world rank of the peer and size with which every start is profiled
+    void profile_as(profiled_operation op, profiler::id_type world_peer, std::size_t bytes) noexcept {
+        profiled = {op, world_peer, bytes};
+    }
+
+    // Keeps the data the request transfers alive for as long as the request, which is freed first
+    void adopt(owned_data data) noexcept {
+        owned = std::move(data);
+    }
+
+    // Data owned by the request, which was given to send_init or recv_init by value. T must be its type.
+    template<typename T>
+    [[nodiscard]]
+    T& data() noexcept {
+        return owned.template get<T>();
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    T const& data() const noexcept {
+        return owned.template get<T>();
+    }
+
+    [[nodiscard]]
+    handle_type& handle() noexcept {
+        return request_handle;
+    }
+
+  private:
+    struct binding {
+        void const* container = nullptr;
+        void const* buffer = nullptr;
+        std::size_t size = 0;
+        bool (*check)(binding const&) = nullptr;
+
+        // Only valid while the container is alive, which starting the request requires anyway
+        template<typename C>
+        static bool same_buffer(binding const& b) {
+            auto const& c = *static_cast<C const*>(b.container);
+            return container_traits<C>::pointer(c) == b.buffer && container_traits<C>::size(c) == b.size;
+        }
+
+        [[nodiscard]]
+        bool unchanged() const {
+            return check == nullptr || check(*this);
+        }
+    };
+
+    handle_type request_handle = MPI_REQUEST_NULL;
+    bool started = false;
+    binding bound;
+    owned_data owned;
+
+    struct profiled_call {
+        profiled_operation op = profiled_operation::isend;
+        profiler::id_type peer = profiler::no_peer;
+        std::size_t bytes = 0;
+    } profiled;
+
+    // Persistent requests keep their handle after completion, so there is no need to copy the handles back
+    static std::vector<handle_type> gather_handles(std::span<basic_persistent_request> requests) {
+        std::vector<handle_type> handles(requests.size());
+        for(std::size_t i=0; i < requests.size(); ++i) {
+            handles[i] = requests[i].request_handle;
+        }
+        return handles;
+    }
+
+    void free() noexcept {
+        if(request_handle == MPI_REQUEST_NULL) {
+            return;
+        }
+        // MPI cannot be called anymore after finalization
+        if(environment::stage() == environment::stages::running) {
+            wait();
+            MPI_Request_free(&request_handle);
+        }
+        request_handle = MPI_REQUEST_NULL;
+        started = false;
+    }
+};
+
+}
+
+#endif
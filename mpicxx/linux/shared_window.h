@@ -0,0 +1,205 @@
+#pragma once
+
+#include <mpicxx/common/defines.h>
+
+// Real implementation for MPI_ENABLED==true in Linux
+#if defined(PLATFORM_IS_LINUX) && MPI_ENABLED
+
+#include <cassert>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+#include <mpicxx/common/shared_window.h>
+
+#include "communicator.h"
+#include "environment.h"
+#include "types.h"
+
+namespace mpi {
+
+// Segments of memory allocated with MPI_Win_allocate_shared.
+// Every rank contributes one segment, and can read and write the segment of any other rank on the node
+// through plain loads and stores. Accesses from different ranks must be separated by fence, or by sync
+// and a barrier while the epoch returned by lock_all is open.
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+class basic_shared_window<Os::Linux, true, T> {
+  public:
+    using communicator = basic_communicator<Os::Linux, true>;
+    using environment = basic_environment<Os::Linux, true>;
+    using size_type = typename communicator::size_type;
+    using id_type = typename communicator::id_type;
+    using handle_type = MPI_Win;
+
+    // RAII guard around a passive epoch, which is closed on destruction
+    class epoch {
+      public:
+        epoch(epoch const&) = delete;
+        epoch& operator=(epoch const&) = delete;
+        epoch& operator=(epoch&&) = delete;
+
+        epoch(epoch&& other) noexcept
+            : window_handle(other.window_handle)
+            , epoch_kind(std::exchange(other.epoch_kind, kind::closed))
+            , epoch_target(other.epoch_target)
+        {
+        }
+
+        ~epoch() noexcept {
+            close();
+        }
+
+        // Closes the epoch early
+        void close() noexcept {
+            switch(std::exchange(epoch_kind, kind::closed)) {
+                case kind::lock:     MPI_Win_unlock(epoch_target, window_handle); break;
+                case kind::lock_all: MPI_Win_unlock_all(window_handle); break;
+                case kind::closed:   break;
+            }
+        }
+
+      private:
+        friend class basic_shared_window;
+
+        enum class kind {
+            closed, lock, lock_all
+        };
+
+        epoch(handle_type w, kind k, id_type target = 0) noexcept
+            : window_handle(w)
+            , epoch_kind(k)
+            , epoch_target(target)
+        {
+        }
+
+        handle_type window_handle;
+        kind epoch_kind;
+        id_type epoch_target;
+    };
+
+    // Collective over the communicator, whose ranks must all share memory (see communicator::split_shared).
+    // Each rank allocates count elements, which may differ between ranks and be zero.
+    basic_shared_window(communicator const& node, size_type count)
+        : window_rank(node.rank())
+    {
+        environment::assert_running();
+        assert(count >= 0);
+
+        T* base;
+        MPI_Win_allocate_shared(static_cast<MPI_Aint>(count) * static_cast<MPI_Aint>(sizeof(T)),
+                                static_cast<int>(sizeof(T)), MPI_INFO_NULL, node.handle(),
+                                &base, &window_handle);
+
+        // The segments never move, so they are looked up once
+        segments.reserve(static_cast<std::size_t>(node.size()));
+        for(id_type r=0; r < node.size(); ++r) {
+            MPI_Aint bytes;
+            int disp_unit;
+            T* ptr;
+            MPI_Win_shared_query(window_handle, r, &bytes, &disp_unit, &ptr);
+            segments.emplace_back(ptr, static_cast<std::size_t>(bytes) / sizeof(T));
+        }
+    }
+
+    basic_shared_window(basic_shared_window const&) = delete;
+    basic_shared_window& operator=(basic_shared_window const&) = delete;
+
+    basic_shared_window(basic_shared_window&& other) noexcept
+        : window_handle(std::exchange(other.window_handle, MPI_WIN_NULL))
+        , window_rank(other.window_rank)
+        , segments(std::move(other.segments))
+    {
+    }
+
+    basic_shared_window& operator=(basic_shared_window&& other) noexcept {
+        if(this != &other) {
+            free();
+            window_handle = std::exchange(other.window_handle, MPI_WIN_NULL);
+            window_rank = other.window_rank;
+            segments = std::move(other.segments);
+        }
+        return *this;
+    }
+
+    // Collective over the communicator the window was created with
+    ~basic_shared_window() noexcept {
+        free();
+    }
+
+    // Segment of this rank
+    [[nodiscard]]
+    std::span<T> local() const noexcept {
+        return segment(window_rank);
+    }
+
+    // Segment of any rank on the node
+    [[nodiscard]]
+    std::span<T> segment(id_type rank) const noexcept {
+        assert(rank >= 0 && static_cast<std::size_t>(rank) < segments.size());
+        return segments[static_cast<std::size_t>(rank)];
+    }
+
+    // Number of ranks sharing the window
+    [[nodiscard]]
+    id_type size() const noexcept {
+        return static_cast<id_type>(segments.size());
+    }
+
+    // Collective. Completes every previous access, so that writes become visible to all ranks.
+    void fence() const noexcept {
+        environment::assert_running();
+        MPI_Win_fence(0, window_handle);
+    }
+
+    // Passive epoch on every segment, in which accesses are ordered with sync and barriers
+    [[nodiscard]]
+    epoch lock_all() const noexcept {
+        environment::assert_running();
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, window_handle);
+        return {window_handle, epoch::kind::lock_all};
+    }
+
+    // Exclusive access to the segment of a rank, for as long as the epoch is open
+    [[nodiscard]]
+    epoch lock(id_type rank) const noexcept {
+        environment::assert_running();
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, rank, 0, window_handle);
+        return {window_handle, epoch::kind::lock, rank};
+    }
+
+    // Synchronizes the private and public copies of the window, inside a lock or lock_all epoch
+    void sync() const noexcept {
+        environment::assert_running();
+        MPI_Win_sync(window_handle);
+    }
+
+    [[nodiscard]]
+    handle_type handle() const noexcept {
+        return window_handle;
+    }
+
+  private:
+    handle_type window_handle = MPI_WIN_NULL;
+    id_type window_rank;
+    std::vector<std::span<T>> segments;
+
+    void free() noexcept {
+        if(window_handle == MPI_WIN_NULL) {
+            return;
+        }
+        // MPI_Win_free would be erroneous past finalization, in which case only the handle and the segment views are cleared
+        if(environment::stage() == environment::stages::running) {
+            MPI_Win_free(&window_handle);
+        }
+        window_handle = MPI_WIN_NULL;
+        segments.clear();
+    }
+};
+
+}
+
+#endif
@@ -4,9 +4,24 @@
 
 #if defined(PLATFORM_IS_LINUX) && MPI_ENABLED
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <climits>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
 #include <mpi.h>
+#include <mpicxx/common/strided_view.h>
 #include <mpicxx/common/types.h>
 
+#include "environment.h"
+
 namespace mpi {
 
 template<>
@@ -16,7 +31,8 @@ struct basic_status<Os::Linux, true> : MPI_Status {
 
 template<>
 struct typedefs<Os::Linux, true> {
-    using size_type = int;
+    // Element counts are 64-bit, as messages may hold more than INT_MAX elements
+    using size_type = std::int64_t;
     using id_type = int;
     using tag_type = int;
     using datatype = MPI_Datatype;
@@ -38,6 +54,205 @@ template<> [[nodiscard]] constexpr typedefs<Os::Linux, true>::datatype get_datat
 template<> [[nodiscard]] constexpr typedefs<Os::Linux, true>::datatype get_datatype<Os::Linux, true, double>()             noexcept { return MPI_DOUBLE; }
 template<> [[nodiscard]] constexpr typedefs<Os::Linux, true>::datatype get_datatype<Os::Linux, true, long double>()        noexcept { return MPI_LONG_DOUBLE; }
 template<> [[nodiscard]] constexpr typedefs<Os::Linux, true>::datatype get_datatype<Os::Linux, true, bool>()               noexcept { return MPI_C_BOOL; }
+template<> [[nodiscard]] constexpr typedefs<Os::Linux, true>::datatype get_datatype<Os::Linux, true, std::complex<float>>()        noexcept { return MPI_CXX_FLOAT_COMPLEX; }
+template<> [[nodiscard]] constexpr typedefs<Os::Linux, true>::datatype get_datatype<Os::Linux, true, std::complex<double>>()       noexcept { return MPI_CXX_DOUBLE_COMPLEX; }
+template<> [[nodiscard]] constexpr typedefs<Os::Linux, true>::datatype get_datatype<Os::Linux, true, std::complex<long double>>()  noexcept { return MPI_CXX_LONG_DOUBLE_COMPLEX; }
+
+// Builds the (uncommitted) datatype for each kind of derived type
+template<typename T>
+struct derived_datatype_builder;
+
+template<Os OS, bool MpiEnabled, DerivedType T> requires (OS == Os::Linux && MpiEnabled)
+[[nodiscard]] typename typedefs<Os::Linux, true>::datatype get_datatype();
+
+// Fixes the extent of a datatype to match sizeof(T), so that trailing padding is skipped in arrays of T
+template<typename T>
+[[nodiscard]] MPI_Datatype resize_to_extent_of(MPI_Datatype datatype) {
+    MPI_Datatype resized;
+    MPI_Type_create_resized(datatype, 0, static_cast<MPI_Aint>(sizeof(T)), &resized);
+    MPI_Type_free(&datatype);
+    return resized;
+}
+
+template<MappedType T, std::size_t S>
+struct derived_datatype_builder<std::array<T, S>> {
+    [[nodiscard]] static MPI_Datatype build() {
+        MPI_Datatype datatype;
+        MPI_Type_contiguous(static_cast<int>(S), get_datatype<Os::Linux, true, T>(), &datatype);
+        return resize_to_extent_of<std::array<T, S>>(datatype);
+    }
+};
+
+template<RegisteredAggregate T>
+struct derived_datatype_builder<T> {
+    [[nodiscard]] static MPI_Datatype build() {
+        constexpr auto members = aggregate_traits<T>::members;
+        constexpr std::size_t n_members = std::tuple_size_v<std::remove_const_t<decltype(members)>>;
+
+        std::array<int, n_members> block_lengths;
+        std::array<MPI_Aint, n_members> displacements;
+        std::array<MPI_Datatype, n_members> datatypes;
+        block_lengths.fill(1);
+
+        // Offsets are measured on an actual instance, as offsetof cannot take member pointers
+        const T instance{};
+        const auto base = reinterpret_cast<std::byte const*>(&instance);
+
+        [&]<std::size_t...I>(std::index_sequence<I...>) {
+            ((displacements[I] = reinterpret_cast<std::byte const*>(&(instance.*std::get<I>(members))) - base), ...);
+            ((datatypes[I] = member_datatype<decltype(instance.*std::get<I>(members))>()), ...);
+        }(std::make_index_sequence<n_members>{});
+
+        MPI_Datatype datatype;
+        MPI_Type_create_struct(static_cast<int>(n_members), block_lengths.data(), displacements.data(), datatypes.data(), &datatype);
+        return resize_to_extent_of<T>(datatype);
+    }
+
+  private:
+    template<typename Member>
+    [[nodiscard]] static MPI_Datatype member_datatype() {
+        using M = std::remove_cvref_t<Member>;
+        static_assert(MappedType<M>, "All members of a registered aggregate must be valid types");
+        return get_datatype<Os::Linux, true, M>();
+    }
+};
+
+// Count and datatype describing n elements of T in a single call. Counts above max_count are described as one element
+// of a derived datatype made of max_count-element blocks followed by the remainder. Only the sequence of elements has
+// to match between sender and receiver, so either side may describe the message differently.
+// The derived datatype is freed on destruction, which MPI allows while operations that use it are pending.
+template<MappedType T>
+class large_count {
+  public:
+    explicit large_count(std::size_t n) {
+        const auto elements = static_cast<std::int64_t>(n);
+        if(elements <= max_count) {
+            buffer_count = static_cast<int>(elements);
+            return;
+        }
+
+        const MPI_Datatype element = get_datatype<Os::Linux, true, T>();
+        const std::int64_t blocks = elements / max_count;
+        const std::int64_t remainder = elements % max_count;
+
+        MPI_Datatype block, body;
+        MPI_Type_contiguous(static_cast<int>(max_count), element, &block);
+        MPI_Type_contiguous(static_cast<int>(blocks), block, &body);
+        MPI_Type_free(&block);
+
+        if(remainder == 0) {
+            type = body;
+        } else {
+            MPI_Datatype tail;
+            MPI_Type_contiguous(static_cast<int>(remainder), element, &tail);
+            const int lengths[] = {1, 1};
+            const MPI_Aint displacements[] = {0, static_cast<MPI_Aint>(blocks * max_count) * static_cast<MPI_Aint>(sizeof(T))};
+            const MPI_Datatype types[] = {body, tail};
+            MPI_Type_create_struct(2, lengths, displacements, types, &type);
+            MPI_Type_free(&body);
+            MPI_Type_free(&tail);
+        }
+        MPI_Type_commit(&type);
+        buffer_count = 1;
+        owned = true;
+    }
+
+    large_count(large_count const&) = delete;
+    large_count& operator=(large_count const&) = delete;
+
+    ~large_count() noexcept {
+        if(owned) {
+            MPI_Type_free(&type);
+        }
+    }
+
+    [[nodiscard]]
+    int count() const noexcept {
+        return buffer_count;
+    }
+
+    [[nodiscard]]
+    MPI_Datatype datatype() const noexcept {
+        return type;
+    }
+
+  private:
+    int buffer_count = 0;
+    MPI_Datatype type = get_datatype<Os::Linux, true, T>();
+    bool owned = false;
+};
+
+// Datatype selecting the elements of a strided view, as one element of an MPI_Type_vector.
+// Freed on destruction, like the datatypes of large_count.
+template<typename T>
+    requires MappedType<std::remove_cv_t<T>>
+class strided_layout {
+  public:
+    explicit strided_layout(strided_view<T> const& view) {
+        if(view.count() > INT_MAX || view.stride() > INT_MAX) {
+            throw std::overflow_error("Strided views are limited to INT_MAX elements and a stride of INT_MAX");
+        }
+        MPI_Type_vector(static_cast<int>(view.count()), static_cast<int>(view.block_length()), static_cast<int>(view.stride()),
+                        get_datatype<Os::Linux, true, std::remove_cv_t<T>>(), &type);
+        MPI_Type_commit(&type);
+    }
+
+    strided_layout(strided_layout const&) = delete;
+    strided_layout& operator=(strided_layout const&) = delete;
+
+    ~strided_layout() noexcept {
+        MPI_Type_free(&type);
+    }
+
+    [[nodiscard]]
+    MPI_Datatype datatype() const noexcept {
+        return type;
+    }
+
+  private:
+    MPI_Datatype type;
+};
+
+// Number of elements of T in a received or probed message, including counts that MPI_Get_count cannot report
+template<MappedType T>
+[[nodiscard]] std::int64_t element_count(MPI_Status const& status) {
+    const MPI_Datatype element = get_datatype<Os::Linux, true, T>();
+    int count;
+    MPI_Get_count(&status, element, &count);
+    if(count != MPI_UNDEFINED) {
+        return count;
+    }
+    MPI_Count bytes;
+    int element_size;
+    MPI_Get_elements_x(&status, MPI_BYTE, &bytes);
+    MPI_Type_size(element, &element_size);
+    return static_cast<std::int64_t>(bytes / element_size);
+}
+
+// Narrows the counts or displacements of a v-collective, which MPI 3 only accepts as ints.
+// Throws rather than truncating those that do not fit.
+[[nodiscard]] inline std::vector<int> narrow_counts(std::span<const std::int64_t> counts) {
+    std::vector<int> narrowed(counts.size());
+    std::transform(counts.begin(), counts.end(), narrowed.begin(), [](std::int64_t c) {
+        if(c > INT_MAX) {
+            throw std::overflow_error("Counts and displacements of v-collectives are limited to INT_MAX elements");
+        }
+        return static_cast<int>(c);
+    });
+    return narrowed;
+}
+
+// Derived datatypes are built and committed once per type, and freed at finalization
+template<Os OS, bool MpiEnabled, DerivedType T> requires (OS == Os::Linux && MpiEnabled)
+[[nodiscard]] typename typedefs<Os::Linux, true>::datatype get_datatype() {
+    static const MPI_Datatype datatype = []() {
+        MPI_Datatype handle = derived_datatype_builder<T>::build();
+        MPI_Type_commit(&handle);
+        basic_environment<Os::Linux, true>::at_finalize([handle]() mutable { MPI_Type_free(&handle); });
+        return handle;
+    }();
+    return datatype;
+}
 
 }
 
@@ -0,0 +1,320 @@
+#pragma once
+
+#include <mpicxx/common/defines.h>
+
+// Real implementation for MPI_ENABLED==true in Linux
+#if defined(PLATFORM_IS_LINUX) && MPI_ENABLED
+
+#include <cassert>
+#include <concepts>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include <mpi.h>
+
+#include <mpicxx/common/extra_type_traits.h>
+#include <mpicxx/common/operations.h>
+#include <mpicxx/common/profiler.h>
+#include <mpicxx/common/window.h>
+
+#include "communicator.h"
+#include "environment.h"
+#include "operations.h"
+#include "types.h"
+
+namespace mpi {
+
+// Memory that other ranks read and write with one-sided operations, addressed in elements of T.
+// Operations are only allowed inside an epoch, and their buffers must not be touched until the epoch
+// is closed or the target is flushed. Operations, fences, flushes and the closing of epochs are profiled without a
+// peer, as targets are ranks of the window's communicator, which the window does not keep.
+template<mpi::ValidType T>
+class basic_window<Os::Linux, true, T> {
+  public:
+    using communicator = basic_communicator<Os::Linux, true>;
+    using environment = basic_environment<Os::Linux, true>;
+    using size_type = typename communicator::size_type;
+    using id_type = typename communicator::id_type;
+    using profiler = basic_profiler<Os::Linux, true>;
+    using handle_type = MPI_Win;
+
+    // RAII guard around an access or exposure epoch, which is closed on destruction
+    class epoch {
+      public:
+        epoch(epoch const&) = delete;
+        epoch& operator=(epoch const&) = delete;
+        epoch& operator=(epoch&&) = delete;
+
+        epoch(epoch&& other) noexcept
+            : window_handle(other.window_handle)
+            , epoch_kind(std::exchange(other.epoch_kind, kind::closed))
+            , epoch_target(other.epoch_target)
+        {
+        }
+
+        ~epoch() noexcept {
+            close();
+        }
+
+        // Closes the epoch early, completing every operation issued inside it
+        void close() noexcept {
+            if(epoch_kind == kind::closed) {
+                return;
+            }
+            const profiler::scope p(epoch_kind == kind::fence ? profiled_operation::fence : profiled_operation::epoch_close);
+            switch(std::exchange(epoch_kind, kind::closed)) {
+                case kind::fence:    MPI_Win_fence(0, window_handle); break;
+                case kind::access:   MPI_Win_complete(window_handle); break;
+                case kind::exposure: MPI_Win_wait(window_handle); break;
+                case kind::lock:     MPI_Win_unlock(epoch_target, window_handle); break;
+                case kind::lock_all: MPI_Win_unlock_all(window_handle); break;
+                case kind::closed:   break;
+            }
+        }
+
+      private:
+        friend class basic_window;
+
+        enum class kind {
+            closed, fence, access, exposure, lock, lock_all
+        };
+
+        epoch(handle_type w, kind k, id_type target = 0) noexcept
+            : window_handle(w)
+            , epoch_kind(k)
+            , epoch_target(target)
+        {
+        }
+
+        handle_type window_handle;
+        kind epoch_kind;
+        id_type epoch_target;
+    };
+
+    // Collective. Allocates count elements on this rank, which may differ between ranks and be zero.
+    basic_window(communicator const& comm, size_type count)
+    {
+        environment::assert_running();
+        assert(count >= 0);
+        T* base;
+        MPI_Win_allocate(static_cast<MPI_Aint>(count) * static_cast<MPI_Aint>(sizeof(T)),
+                         static_cast<int>(sizeof(T)), MPI_INFO_NULL, comm.handle(), &base, &window_handle);
+        memory = {base, static_cast<std::size_t>(count)};
+    }
+
+    // Collective. Exposes existing memory, which must outlive the window.
+    basic_window(communicator const& comm, std::span<T> exposed)
+        : memory(exposed)
+    {
+        environment::assert_running();
+        MPI_Win_create(memory.data(), static_cast<MPI_Aint>(memory.size_bytes()),
+                       static_cast<int>(sizeof(T)), MPI_INFO_NULL, comm.handle(), &window_handle);
+    }
+
+    basic_window(basic_window const&) = delete;
+    basic_window& operator=(basic_window const&) = delete;
+
+    basic_window(basic_window&& other) noexcept
+        : window_handle(std::exchange(other.window_handle, MPI_WIN_NULL))
+        , memory(std::exchange(other.memory, {}))
+    {
+    }
+
+    basic_window& operator=(basic_window&& other) noexcept {
+        if(this != &other) {
+            free();
+            window_handle = std::exchange(other.window_handle, MPI_WIN_NULL);
+            memory = std::exchange(other.memory, {});
+        }
+        return *this;
+    }
+
+    // Collective over the communicator the window was created with
+    ~basic_window() noexcept {
+        free();
+    }
+
+    // Memory of this rank. Only safe to access outside of epochs that may touch it.
+    [[nodiscard]]
+    std::span<T> local() const noexcept {
+        return memory;
+    }
+
+    // Collective. Separates two active epochs: operations before it complete, and are visible after it.
+    void fence() const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::fence);
+        MPI_Win_fence(0, window_handle);
+    }
+
+    // Collective. Active epoch on every rank, closed by a second fence.
+    [[nodiscard]]
+    epoch fence_epoch() const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::fence);
+        MPI_Win_fence(0, window_handle);
+        return {window_handle, epoch::kind::fence};
+    }
+
+    // Access epoch on the given targets, which must each open a matching exposure epoch (post-start-complete-wait)
+    [[nodiscard]]
+    epoch access(std::span<const id_type> targets) const {
+        environment::assert_running();
+        MPI_Group group = make_group(targets);
+        MPI_Win_start(group, 0, window_handle);
+        MPI_Group_free(&group);
+        return {window_handle, epoch::kind::access};
+    }
+
+    // Exposure epoch to the given origins, which must each open a matching access epoch
+    [[nodiscard]]
+    epoch expose(std::span<const id_type> origins) const {
+        environment::assert_running();
+        MPI_Group group = make_group(origins);
+        MPI_Win_post(group, 0, window_handle);
+        MPI_Group_free(&group);
+        return {window_handle, epoch::kind::exposure};
+    }
+
+    // Passive epoch on a single target, which does not take part in the synchronization
+    [[nodiscard]]
+    epoch lock(id_type target, lock_type type = lock_type::exclusive) const noexcept {
+        environment::assert_running();
+        MPI_Win_lock(type == lock_type::exclusive ? MPI_LOCK_EXCLUSIVE : MPI_LOCK_SHARED, target, 0, window_handle);
+        return {window_handle, epoch::kind::lock, target};
+    }
+
+    // Shared passive epoch on every target
+    [[nodiscard]]
+    epoch lock_all() const noexcept {
+        environment::assert_running();
+        MPI_Win_lock_all(0, window_handle);
+        return {window_handle, epoch::kind::lock_all};
+    }
+
+    // Completes the operations issued to the target so far, without closing the passive epoch
+    void flush(id_type target) const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::flush);
+        MPI_Win_flush(target, window_handle);
+    }
+
+    void flush_all() const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::flush);
+        MPI_Win_flush_all(window_handle);
+    }
+
+    void put(T const& data, id_type target, size_type offset) const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::put, profiler::no_peer, payload_bytes(data));
+        MPI_Put(&data, 1, get_datatype<Os::Linux, true, T>(),
+                target, offset, 1, get_datatype<Os::Linux, true, T>(), window_handle);
+    }
+
+    template<mpi::ValidContainer C>
+        requires std::same_as<typename container_traits<C>::data, T>
+    void put(C const& data, id_type target, size_type offset) const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::put, profiler::no_peer, payload_bytes(data));
+        const large_count<T> n(container_traits<C>::size(data));
+        MPI_Put(container_traits<C>::pointer(data), n.count(), n.datatype(),
+                target, offset, n.count(), n.datatype(), window_handle);
+    }
+
+    void get(T& output, id_type target, size_type offset) const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::get, profiler::no_peer, payload_bytes(output));
+        MPI_Get(&output, 1, get_datatype<Os::Linux, true, T>(),
+                target, offset, 1, get_datatype<Os::Linux, true, T>(), window_handle);
+    }
+
+    // Reads as many elements as fit in the output
+    template<mpi::ValidContainer C>
+        requires std::same_as<typename container_traits<C>::data, T>
+    void get(C& output, id_type target, size_type offset) const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::get, profiler::no_peer, payload_bytes(output));
+        const large_count<T> n(container_traits<C>::size(output));
+        MPI_Get(container_traits<C>::pointer(output), n.count(), n.datatype(),
+                target, offset, n.count(), n.datatype(), window_handle);
+    }
+
+    // Atomically combines the data into the target memory, element by element
+    template<mpi::BuiltinOperation<T> Op>
+    void accumulate(T const& data, id_type target, size_type offset, Op) const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::accumulate, profiler::no_peer, payload_bytes(data));
+        MPI_Accumulate(&data, 1, get_datatype<Os::Linux, true, T>(),
+                       target, offset, 1, get_datatype<Os::Linux, true, T>(),
+                       get_operation<T, Op>(), window_handle);
+    }
+
+    template<mpi::ValidContainer C, mpi::BuiltinOperation<T> Op>
+        requires std::same_as<typename container_traits<C>::data, T>
+    void accumulate(C const& data, id_type target, size_type offset, Op) const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::accumulate, profiler::no_peer, payload_bytes(data));
+        // Derived datatypes made of a single predefined type are allowed in accumulate, unlike in reductions
+        const large_count<T> n(container_traits<C>::size(data));
+        MPI_Accumulate(container_traits<C>::pointer(data), n.count(), n.datatype(),
+                       target, offset, n.count(), n.datatype(),
+                       get_operation<T, Op>(), window_handle);
+    }
+
+    // Atomically combines the data into a target element, and stores the value it held before in the result
+    template<mpi::BuiltinOperation<T> Op>
+    void fetch_and_op(T const& data, T& result, id_type target, size_type offset, Op) const noexcept {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::fetch_op, profiler::no_peer, payload_bytes(data));
+        MPI_Fetch_and_op(&data, &result, get_datatype<Os::Linux, true, T>(),
+                         target, offset, get_operation<T, Op>(), window_handle);
+    }
+
+    // Atomically replaces a target element with the desired value if it equals the expected one,
+    // and stores the value it held before in the result
+    void compare_and_swap(T const& desired, T const& expected, T& result, id_type target, size_type offset) const noexcept
+        requires mpi::BuiltinLogical<T>
+    {
+        environment::assert_running();
+        const profiler::scope p(profiled_operation::compare_swap, profiler::no_peer, payload_bytes(desired));
+        MPI_Compare_and_swap(&desired, &expected, &result, get_datatype<Os::Linux, true, T>(),
+                             target, offset, window_handle);
+    }
+
+    [[nodiscard]]
+    handle_type handle() const noexcept {
+        return window_handle;
+    }
+
+  private:
+    handle_type window_handle = MPI_WIN_NULL;
+    std::span<T> memory;
+
+    // Group of the given ranks of the window's communicator
+    [[nodiscard]]
+    MPI_Group make_group(std::span<const id_type> ranks) const {
+        MPI_Group window_group, group;
+        MPI_Win_get_group(window_handle, &window_group);
+        MPI_Group_incl(window_group, static_cast<int>(ranks.size()), ranks.data(), &group);
+        MPI_Group_free(&window_group);
+        return group;
+    }
+
+    void free() noexcept {
+        if(window_handle == MPI_WIN_NULL) {
+            return;
+        }
+        // Once MPI is finalized the window cannot be freed anymore, so it only forgets the handle
+        if(environment::stage() == environment::stages::running) {
+            MPI_Win_free(&window_handle);
+        }
+        window_handle = MPI_WIN_NULL;
+        memory = {};
+    }
+};
+
+}
+
+#endif
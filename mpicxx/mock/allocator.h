@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <mpicxx/common/allocator.h>
+
+namespace mpi {
+
+template<>
+inline void* basic_memory_pool<Os::Linux, false>::allocate_impl(std::size_t bytes)
+{
+    if(void* p = std::malloc(bytes)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+template<>
+inline void* basic_memory_pool<Os::Windows, false>::allocate_impl(std::size_t bytes)
+{
+    if(void* p = std::malloc(bytes)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+template<>
+inline void basic_memory_pool<Os::Linux, false>::deallocate_impl(void* p) noexcept { std::free(p); }
+
+template<>
+inline void basic_memory_pool<Os::Windows, false>::deallocate_impl(void* p) noexcept { std::free(p); }
+
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <mpicxx/common/cartesian.h>
+#include <mpicxx/common/extra_type_traits.h>
+#include "communicator.h"
+#include "environment.h"
+
+namespace mpi {
+
+// Mock implementation for MPI_ENABLED = false
+// The grid holds a single rank, which is its own neighbour along periodic dimensions
+template<Os OS>
+class basic_cartesian_communicator<OS, false> : public basic_communicator<OS, false> {
+  public:
+    using communicator = basic_communicator<OS, false>;
+    using environment = basic_environment<OS, false>;
+    using id_type = typename communicator::id_type;
+
+    static constexpr id_type null_rank = -1;
+
+    basic_cartesian_communicator(communicator const& comm, std::span<const int> dims, std::span<const bool> periodic, bool = true)
+        : communicator(comm.dup())
+        , grid_dims(dims.size(), 1)
+        , grid_periodic(periodic.begin(), periodic.end())
+        , grid_coords(dims.size(), 0)
+    {
+        assert(dims.size() == periodic.size());
+        assert(std::all_of(dims.begin(), dims.end(), [](int n) { return n == 0 || n == 1; }));
+    }
+
+    [[nodiscard]]
+    int ndims() const noexcept {
+        return static_cast<int>(grid_dims.size());
+    }
+
+    [[nodiscard]]
+    std::span<const int> dims() const noexcept {
+        return grid_dims;
+    }
+
+    [[nodiscard]]
+    bool periodic(int dim) const noexcept {
+        return grid_periodic[static_cast<std::size_t>(dim)];
+    }
+
+    [[nodiscard]]
+    std::span<const int> coords() const noexcept {
+        return grid_coords;
+    }
+
+    [[nodiscard]]
+    std::vector<int> coords([[maybe_unused]] id_type rank) const {
+        assert(rank == 0);
+        return grid_coords;
+    }
+
+    [[nodiscard]]
+    id_type rank_at(std::span<const int> c) const {
+        environment::assert_running();
+        assert(c.size() == grid_dims.size());
+        for(std::size_t d=0; d < c.size(); ++d) {
+            if(!grid_periodic[d] && c[d] != 0) {
+                return null_rank;
+            }
+        }
+        return 0;
+    }
+
+    [[nodiscard]]
+    id_type neighbour(std::span<const int> offset) const {
+        return rank_at(offset);
+    }
+
+    [[nodiscard]]
+    std::pair<id_type, id_type> shift(int dim, int displacement) const noexcept {
+        environment::assert_running();
+        if(displacement != 0 && !periodic(dim)) {
+            return {null_rank, null_rank};
+        }
+        return {0, 0};
+    }
+
+  private:
+    std::vector<int> grid_dims;
+    std::vector<bool> grid_periodic;
+    std::vector<int> grid_coords;
+};
+
+// Periodic neighbours are the rank itself, so ghost layers are copied from the opposite boundary
+template<Os OS, mpi::ValidType T>
+class basic_halo_exchange<OS, false, T> {
+  public:
+    using cartesian_communicator = basic_cartesian_communicator<OS, false>;
+    using environment = basic_environment<OS, false>;
+
+    basic_halo_exchange(cartesian_communicator const& cart, std::span<const int> interior, int ghost)
+        : geometry(interior, ghost)
+    {
+        environment::assert_running();
+        assert(geometry.ndims() == cart.ndims());
+
+        for(auto const& side: geometry.sides()) {
+            if(cart.neighbour(side) == cartesian_communicator::null_rank) {
+                continue;
+            }
+            std::vector<int> opposite(side.size());
+            std::transform(side.begin(), side.end(), opposite.begin(), std::negate<>{});
+            sources.push_back(geometry.flat_indices(geometry.boundary(side)));
+            destinations.push_back(geometry.flat_indices(geometry.halo(opposite)));
+        }
+    }
+
+    [[nodiscard]]
+    halo_layout const& layout() const noexcept {
+        return geometry;
+    }
+
+    template<mpi::ValidContainer C>
+        requires std::same_as<typename container_traits<C>::data, T>
+    void exchange(C& data) const {
+        environment::assert_running();
+        assert(container_traits<C>::size(data) == geometry.size());
+        T* buffer = container_traits<C>::pointer(data);
+        for(std::size_t i=0; i < sources.size(); ++i) {
+            for(std::size_t j=0; j < sources[i].size(); ++j) {
+                buffer[destinations[i][j]] = buffer[sources[i][j]];
+            }
+        }
+    }
+
+  private:
+    halo_layout geometry;
+    std::vector<std::vector<std::size_t>> sources;
+    std::vector<std::vector<std::size_t>> destinations;
+};
+
+}
@@ -1,14 +1,22 @@
 #pragma once
 
 #include "mpicxx/common/types.h"
+#include <algorithm>
 #include <cassert>
 #include <map>
 #include <cstring>
+#include <optional>
+#include <ranges>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
 #include <mpicxx/common/communicator.h>
+#include <mpicxx/common/strided_view.h>
+#include <mpicxx/common/operations.h>
 #include "environment.h"
+#include "request.h"
 #include "types.h"
 
 namespace mpi {
@@ -19,24 +27,56 @@ class basic_communicator<OS, false> {
   public:
 
     using status = basic_status<OS, false>;
+    using envelope = basic_envelope<OS, false>;
     using environment = basic_environment<OS, false>;
+    using request = basic_request<OS, false>;
+    using persistent_request = basic_persistent_request<OS, false>;
     
     using size_type = typename typedefs<OS, false>::size_type;
     using id_type = typename typedefs<OS, false>::id_type;
     using tag_type = typename typedefs<OS, false>::tag_type;
     using handle_type = void*;
 
+    static constexpr id_type any_source = -1;
+    static constexpr tag_type any_tag = -1;
+
+    // Color of the ranks that split leaves out
+    static constexpr int undefined = -1;
+
     explicit basic_communicator(handle_type c)
         : communicator_handle(c)
     {
         basic_environment<OS, false>::initialize();
     }
     
-    basic_communicator(basic_communicator const& other) 
+    // Copies are non-owning views, as in the MPI implementation
+    basic_communicator(basic_communicator const& other) noexcept
         : communicator_handle(other.communicator_handle)
     {
     }
 
+    basic_communicator(basic_communicator&& other) noexcept
+        : communicator_handle(other.communicator_handle)
+        , is_owning(std::exchange(other.is_owning, false))
+    {
+    }
+
+    basic_communicator& operator=(basic_communicator const& other) noexcept {
+        if(this != &other) {
+            communicator_handle = other.communicator_handle;
+            is_owning = false;
+        }
+        return *this;
+    }
+
+    basic_communicator& operator=(basic_communicator&& other) noexcept {
+        if(this != &other) {
+            communicator_handle = other.communicator_handle;
+            is_owning = std::exchange(other.is_owning, false);
+        }
+        return *this;
+    }
+
     [[nodiscard]]
     static basic_communicator get_default()
     {
@@ -44,13 +84,44 @@ class basic_communicator<OS, false> {
     }
 
     [[nodiscard]]
-    constexpr size_type size() const noexcept {
+    basic_communicator dup() const {
+        environment::assert_running();
+        return adopt(communicator_handle);
+    }
+
+    [[nodiscard]]
+    std::optional<basic_communicator> split(int color, int) const {
+        environment::assert_running();
+        assert(color >= 0 || color == undefined);
+        if(color == undefined) {
+            return std::nullopt;
+        }
+        return adopt(communicator_handle);
+    }
+
+    [[nodiscard]]
+    basic_communicator split_shared(int = 0) const {
+        environment::assert_running();
+        return adopt(communicator_handle);
+    }
+
+    [[nodiscard]]
+    bool owning() const noexcept {
+        return is_owning;
+    }
+
+    void free() noexcept {
+        is_owning = false;
+    }
+
+    [[nodiscard]]
+    constexpr id_type size() const noexcept {
         environment::assert_running(); 
         return 1;
     }
 
     [[nodiscard]]
-    constexpr size_type rank() const noexcept {
+    constexpr id_type rank() const noexcept {
         environment::assert_running(); 
         return 0;
     }
@@ -62,6 +133,13 @@ class basic_communicator<OS, false> {
 
     constexpr void barrier() const noexcept { }
 
+    // Collectives on a single rank complete immediately, so the requests are already done
+    [[nodiscard]]
+    request ibarrier() const {
+        environment::assert_running();
+        return {};
+    }
+
     template<mpi::ValidType T>
     void send([[maybe_unused]] id_type destination, tag_type, T&) {
         assert(destination == 0);
@@ -74,6 +152,13 @@ class basic_communicator<OS, false> {
         throw std::runtime_error("A rank cannot send a message to itself");
     }
 
+    template<typename T>
+        requires mpi::MappedType<std::remove_const_t<T>>
+    void send([[maybe_unused]] id_type destination, tag_type, strided_view<T>) const {
+        assert(destination == 0);
+        throw std::runtime_error("A rank cannot send a message to itself");
+    }
+
     template<mpi::ValidType T>
     void recv([[maybe_unused]] id_type source, tag_type, T&, status&) const  {
         environment::assert_running();
@@ -88,6 +173,142 @@ class basic_communicator<OS, false> {
         throw std::runtime_error("A rank cannot get a message from itself");
     }
 
+    template<mpi::MappedType T>
+    void recv([[maybe_unused]] id_type source, tag_type, strided_view<T>, status&) const {
+        environment::assert_running();
+        assert(source == 0);
+        throw std::runtime_error("A rank cannot get a message from itself");
+    }
+
+    // No message can ever arrive, as a rank cannot send to itself
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    envelope probe([[maybe_unused]] id_type source, tag_type) const {
+        environment::assert_running();
+        assert(source == 0 || source == any_source);
+        throw std::runtime_error("A rank cannot get a message from itself");
+    }
+
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    std::optional<envelope> iprobe([[maybe_unused]] id_type source, tag_type) const {
+        environment::assert_running();
+        assert(source == 0 || source == any_source);
+        return std::nullopt;
+    }
+
+    template<mpi::ValidContainer T>
+        requires mpi::ResizableContainer<T>
+    [[nodiscard]]
+    std::optional<request> try_irecv([[maybe_unused]] id_type source, tag_type, T&) const {
+        environment::assert_running();
+        assert(source == 0 || source == any_source);
+        return std::nullopt;
+    }
+
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    request isend([[maybe_unused]] id_type destination, tag_type, T const&) const {
+        environment::assert_running();
+        assert(destination == 0);
+        throw std::runtime_error("A rank cannot send a message to itself");
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    request isend([[maybe_unused]] id_type destination, tag_type, T const&) const {
+        environment::assert_running();
+        assert(destination == 0);
+        throw std::runtime_error("A rank cannot send a message to itself");
+    }
+
+    template<typename T>
+        requires mpi::MappedType<std::remove_const_t<T>>
+    [[nodiscard]]
+    request isend([[maybe_unused]] id_type destination, tag_type, strided_view<T>) const {
+        environment::assert_running();
+        assert(destination == 0);
+        throw std::runtime_error("A rank cannot send a message to itself");
+    }
+
+    template<typename T>
+        requires (!std::ranges::borrowed_range<T>)
+    request isend(id_type, tag_type, T const&&) const = delete;
+
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    request irecv([[maybe_unused]] id_type source, tag_type, T&) const {
+        environment::assert_running();
+        assert(source == 0);
+        throw std::runtime_error("A rank cannot get a message from itself");
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    request irecv([[maybe_unused]] id_type source, tag_type, T&) const {
+        environment::assert_running();
+        assert(source == 0);
+        throw std::runtime_error("A rank cannot get a message from itself");
+    }
+
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    request irecv([[maybe_unused]] id_type source, tag_type, strided_view<T>) const {
+        environment::assert_running();
+        assert(source == 0);
+        throw std::runtime_error("A rank cannot get a message from itself");
+    }
+
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    persistent_request send_init([[maybe_unused]] id_type destination, tag_type, T const&) const {
+        environment::assert_running();
+        assert(destination == 0);
+        throw std::runtime_error("A rank cannot send a message to itself");
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    persistent_request send_init([[maybe_unused]] id_type destination, tag_type, T const&) const {
+        environment::assert_running();
+        assert(destination == 0);
+        throw std::runtime_error("A rank cannot send a message to itself");
+    }
+
+    template<typename T>
+        requires (!std::is_reference_v<T> && (mpi::ValidType<T> || mpi::ValidContainer<T>))
+    [[nodiscard]]
+    persistent_request send_init([[maybe_unused]] id_type destination, tag_type, T&&) const {
+        environment::assert_running();
+        assert(destination == 0);
+        throw std::runtime_error("A rank cannot send a message to itself");
+    }
+
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    persistent_request recv_init([[maybe_unused]] id_type source, tag_type, T&) const {
+        environment::assert_running();
+        assert(source == 0);
+        throw std::runtime_error("A rank cannot get a message from itself");
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    persistent_request recv_init([[maybe_unused]] id_type source, tag_type, T&) const {
+        environment::assert_running();
+        assert(source == 0);
+        throw std::runtime_error("A rank cannot get a message from itself");
+    }
+
+    template<typename T>
+        requires (!std::is_reference_v<T> && (mpi::ValidType<T> || mpi::ValidContainer<T>))
+    [[nodiscard]]
+    persistent_request recv_init([[maybe_unused]] id_type source, tag_type, T&&) const {
+        environment::assert_running();
+        assert(source == 0);
+        throw std::runtime_error("A rank cannot get a message from itself");
+    }
+
     template<mpi::ValidType T>
     constexpr void broadcast([[maybe_unused]] id_type source, T&) const {
         environment::assert_running();
@@ -99,7 +320,27 @@ class basic_communicator<OS, false> {
         environment::assert_running();
         assert(source == rank());
     }
+
+    template<mpi::MappedType T>
+    void broadcast([[maybe_unused]] id_type source, strided_view<T>) const {
+        environment::assert_running();
+        assert(source == rank());
+    }
     
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    request ibroadcast(id_type source, T& data) const {
+        broadcast(source, data);
+        return {};
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    request ibroadcast(id_type source, T& data) const {
+        broadcast(source, data);
+        return {};
+    }
+
     template<mpi::ValidContainer C>
     void gather([[maybe_unused]] id_type destination, typename container_traits<C>::data data, C& output) const {        
         environment::assert_running();
@@ -119,13 +360,261 @@ class basic_communicator<OS, false> {
         memcpy(container_traits<C>::pointer(output), container_traits<C>::pointer(data), msg_size * sizeof(typename container_traits<C>::data));
     }
 
+    // The only rank already holds the gathered data
+    template<mpi::ValidContainer C>
+    void gather([[maybe_unused]] id_type destination, C&) const {
+        environment::assert_running();
+        assert (rank() == destination);
+    }
+
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igather(id_type destination, typename container_traits<C>::data const& data, C& output) const {
+        gather(destination, data, output);
+        return {};
+    }
+
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igather(id_type destination, C const& data, C& output) const {
+        gather(destination, data, output);
+        return {};
+    }
+
+    template<typename T, typename C>
+        requires (!std::ranges::borrowed_range<T>)
+    request igather(id_type, T const&&, C&) const = delete;
+
+    template<mpi::ValidContainer C>
+    void scatter([[maybe_unused]] id_type source, C const& data, typename container_traits<C>::data& output) const {
+        environment::assert_running();
+        assert(rank() == source);
+        output = container_traits<C>::front(data);
+    }
+
+    template<mpi::ValidContainer C>
+    void scatter([[maybe_unused]] id_type source, C const& data, C& output) const {
+        environment::assert_running();
+        assert(rank() == source);
+
+        const std::size_t msg_size = container_traits<C>::size(output);
+        assert(container_traits<C>::size(data) >= msg_size);
+        std::copy_n(container_traits<C>::pointer(data), msg_size, container_traits<C>::pointer(output));
+    }
+
+    template<mpi::ValidContainer C>
+    void allgather(typename container_traits<C>::data data, C& output) const {
+        environment::assert_running();
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(size()));
+        container_traits<C>::front(output) = data;
+    }
+
+    template<mpi::ValidContainer C>
+    void allgather(C const& data, C& output) const {
+        environment::assert_running();
+        copy(data, output);
+    }
+
+    template<mpi::ValidContainer C>
+    void allgather(C&) const {
+        environment::assert_running();
+    }
+
+    template<mpi::ValidContainer C>
+    void alltoall(C const& data, C& output) const {
+        environment::assert_running();
+        copy(data, output);
+    }
+
+    template<mpi::ValidContainer C>
+    void alltoallv(C const& data, C& output, std::span<const size_type> send_counts) const {
+        alltoallv(data, output, send_counts, send_counts);
+    }
+
+    template<mpi::ValidContainer C>
+    void alltoallv(C const& data, C& output, std::span<const size_type> send_counts, [[maybe_unused]] std::span<const size_type> recv_counts) const {
+        environment::assert_running();
+        assert(send_counts.size() == 1 && recv_counts.size() == 1 && send_counts[0] == recv_counts[0]);
+        assert(container_traits<C>::size(data) >= static_cast<std::size_t>(send_counts[0]));
+
+        const auto msg_size = static_cast<std::size_t>(send_counts[0]);
+        container_traits<C>::try_resize(output, msg_size);
+        std::copy_n(container_traits<C>::pointer(data), msg_size, container_traits<C>::pointer(output));
+    }
+
+    template<mpi::ValidContainer C>
+    void gatherv([[maybe_unused]] id_type destination, C const& data, C& output) const {
+        environment::assert_running();
+        assert(rank() == destination);
+        copy(data, output);
+    }
+
+    template<mpi::ValidContainer C>
+    void gatherv([[maybe_unused]] id_type destination, C const& data, C& output, [[maybe_unused]] std::span<const size_type> counts) const {
+        environment::assert_running();
+        assert(rank() == destination);
+        assert(counts.size() == 1 && static_cast<std::size_t>(counts[0]) == container_traits<C>::size(data));
+        copy(data, output);
+    }
+
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igatherv(id_type destination, C const& data, C& output) const {
+        gatherv(destination, data, output);
+        return {};
+    }
+
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igatherv(id_type destination, C const& data, C& output, std::span<const size_type> counts) const {
+        gatherv(destination, data, output, counts);
+        return {};
+    }
+
+    template<mpi::ValidContainer C>
+    void allgatherv(C const& data, C& output) const {
+        environment::assert_running();
+        copy(data, output);
+    }
+
+    template<mpi::ValidContainer C>
+    void allgatherv(C const& data, C& output, [[maybe_unused]] std::span<const size_type> counts) const {
+        environment::assert_running();
+        assert(counts.size() == 1 && static_cast<std::size_t>(counts[0]) == container_traits<C>::size(data));
+        copy(data, output);
+    }
+
+    template<mpi::ValidContainer C>
+    void scatterv([[maybe_unused]] id_type source, C const& data, C& output) const {
+        environment::assert_running();
+        assert(rank() == source);
+        copy(data, output);
+    }
+
+    template<mpi::ValidContainer C>
+    void scatterv([[maybe_unused]] id_type source, C const& data, C& output, std::span<const size_type> counts) const {
+        environment::assert_running();
+        assert(rank() == source);
+        assert(counts.size() == 1 && static_cast<std::size_t>(counts[0]) <= container_traits<C>::size(data));
+
+        const auto msg_size = static_cast<std::size_t>(counts[0]);
+        container_traits<C>::try_resize(output, msg_size);
+        std::copy_n(container_traits<C>::pointer(data), msg_size, container_traits<C>::pointer(output));
+    }
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void reduce([[maybe_unused]] id_type destination, T const& data, T& output, Op) const {
+        environment::assert_running();
+        assert(rank() == destination);
+        output = data;
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void reduce([[maybe_unused]] id_type destination, C const& data, C& output, Op) const {
+        environment::assert_running();
+        assert(rank() == destination);
+        copy(data, output);
+    }
+
+    // The reduction over a single rank is its own data
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void reduce([[maybe_unused]] id_type destination, T&, Op) const {
+        environment::assert_running();
+        assert(rank() == destination);
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void reduce([[maybe_unused]] id_type destination, C&, Op) const {
+        environment::assert_running();
+        assert(rank() == destination);
+    }
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void allreduce(T const& data, T& output, Op) const {
+        environment::assert_running();
+        output = data;
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void allreduce(C const& data, C& output, Op) const {
+        environment::assert_running();
+        copy(data, output);
+    }
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void allreduce(T&, Op) const {
+        environment::assert_running();
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void allreduce(C&, Op) const {
+        environment::assert_running();
+    }
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    [[nodiscard]]
+    request iallreduce(T const& data, T& output, Op op) const {
+        allreduce(data, output, op);
+        return {};
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    [[nodiscard]]
+    request iallreduce(C const& data, C& output, Op op) const {
+        allreduce(data, output, op);
+        return {};
+    }
+
+    template<typename T, typename C, typename Op>
+        requires (!std::ranges::borrowed_range<T>)
+    request iallreduce(T const&&, C&, Op) const = delete;
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void scan(T const& data, T& output, Op) const {
+        environment::assert_running();
+        output = data;
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void scan(C const& data, C& output, Op) const {
+        environment::assert_running();
+        copy(data, output);
+    }
+
+    // The output in rank 0 is undefined, and there are no other ranks
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void exscan(T const&, T&, Op) const {
+        environment::assert_running();
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void exscan(C const& data, C& output, Op) const {
+        environment::assert_running();
+        container_traits<C>::try_resize(output, container_traits<C>::size(data));
+    }
+
 protected:
+    [[nodiscard]]
+    static basic_communicator adopt(handle_type c) {
+        basic_communicator comm{c};
+        comm.is_owning = true;
+        return comm;
+    }
+
     handle_type handle() const noexcept {
         return communicator_handle;
     }
 
 private:
     handle_type communicator_handle;
+    bool is_owning = false;
+
+    template<mpi::ValidContainer C>
+    static void copy(C const& data, C& output) {
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size);
+        std::copy_n(container_traits<C>::pointer(data), msg_size, container_traits<C>::pointer(output));
+    }
 };
 
 
@@ -6,10 +6,10 @@
 namespace mpi {
 
 template<>
-inline void basic_environment<Os::Linux, false>::initialize_impl(){ }
+inline threading basic_environment<Os::Linux, false>::initialize_impl(threading required){ return required; }
 
 template<>
-inline void basic_environment<Os::Windows, false>::initialize_impl(){ }
+inline threading basic_environment<Os::Windows, false>::initialize_impl(threading required){ return required; }
 
 template<>
 inline void basic_environment<Os::Linux, false>::finalize_impl(){ }
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <mpicxx/common/extra_type_traits.h>
+#include <mpicxx/common/request.h>
+#include "environment.h"
+#include "types.h"
+
+namespace mpi {
+
+// Mock implementation for MPI_ENABLED = false
+// With a single rank there is never anything to wait for, so every request is born complete
+template<Os OS>
+class basic_request<OS, false> {
+  public:
+    using status = basic_status<OS, false>;
+    using environment = basic_environment<OS, false>;
+    using handle_type = void*;
+
+    basic_request() noexcept = default;
+
+    basic_request(basic_request const&) = delete;
+    basic_request& operator=(basic_request const&) = delete;
+
+    basic_request(basic_request&&) noexcept = default;
+    basic_request& operator=(basic_request&&) noexcept = default;
+
+    [[nodiscard]]
+    constexpr bool active() const noexcept {
+        return false;
+    }
+
+    constexpr void wait() noexcept { }
+
+    constexpr void wait(status&) noexcept { }
+
+    [[nodiscard]]
+    constexpr bool test() noexcept {
+        return true;
+    }
+
+    [[nodiscard]]
+    constexpr bool test(status&) noexcept {
+        return true;
+    }
+
+    static void wait_all(std::span<basic_request>) {
+        environment::assert_running();
+    }
+
+    static std::optional<std::size_t> wait_any(std::span<basic_request>) {
+        environment::assert_running();
+        return {};
+    }
+
+    static std::vector<std::size_t> wait_some(std::span<basic_request>) {
+        environment::assert_running();
+        return {};
+    }
+
+    static std::vector<std::size_t> test_some(std::span<basic_request>) {
+        environment::assert_running();
+        return {};
+    }
+};
+
+// Persistent communications cannot be set up with a single rank, so these are never started
+template<Os OS>
+class basic_persistent_request<OS, false> {
+  public:
+    using status = basic_status<OS, false>;
+    using environment = basic_environment<OS, false>;
+    using handle_type = void*;
+
+    basic_persistent_request() noexcept = default;
+
+    basic_persistent_request(basic_persistent_request const&) = delete;
+    basic_persistent_request& operator=(basic_persistent_request const&) = delete;
+
+    basic_persistent_request(basic_persistent_request&&) noexcept = default;
+    basic_persistent_request& operator=(basic_persistent_request&&) noexcept = default;
+
+    [[nodiscard]]
+    constexpr bool active() const noexcept {
+        return false;
+    }
+
+    void start() noexcept {
+        environment::assert_running();
+    }
+
+    constexpr void wait() noexcept { }
+
+    constexpr void wait(status&) noexcept { }
+
+    [[nodiscard]]
+    constexpr bool test() noexcept {
+        return true;
+    }
+
+    static void start_all(std::span<basic_persistent_request>) {
+        environment::assert_running();
+    }
+
+    static void wait_all(std::span<basic_persistent_request>) {
+        environment::assert_running();
+    }
+
+    template<ContiguousContainer C>
+    constexpr void bind(C const&) noexcept { }
+
+    void adopt(owned_data data) noexcept {
+        owned = std::move(data);
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    T& data() noexcept {
+        return owned.template get<T>();
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    T const& data() const noexcept {
+        return owned.template get<T>();
+    }
+
+  private:
+    owned_data owned;
+};
+
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cassert>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <mpicxx/common/shared_window.h>
+#include "communicator.h"
+#include "environment.h"
+
+namespace mpi {
+
+// Mock implementation for MPI_ENABLED = false
+// The only rank on the node owns the only segment, and there is nobody to synchronize with
+template<Os OS, typename T>
+    requires std::is_trivially_copyable_v<T>
+class basic_shared_window<OS, false, T> {
+  public:
+    using communicator = basic_communicator<OS, false>;
+    using environment = basic_environment<OS, false>;
+    using size_type = typename communicator::size_type;
+    using id_type = typename communicator::id_type;
+    using handle_type = void*;
+
+    // Guards are still non-trivial, so that they are not reported as unused variables
+    class epoch {
+      public:
+        ~epoch() noexcept { }
+
+        constexpr void close() noexcept { }
+    };
+
+    basic_shared_window(communicator const&, size_type count)
+        : data(std::make_unique<T[]>(static_cast<std::size_t>(count)))
+        , count(static_cast<std::size_t>(count))
+    {
+        environment::assert_running();
+        assert(count >= 0);
+    }
+
+    basic_shared_window(basic_shared_window const&) = delete;
+    basic_shared_window& operator=(basic_shared_window const&) = delete;
+
+    basic_shared_window(basic_shared_window&& other) noexcept
+        : data(std::move(other.data))
+        , count(std::exchange(other.count, 0))
+    {
+    }
+
+    basic_shared_window& operator=(basic_shared_window&& other) noexcept {
+        data = std::move(other.data);
+        count = std::exchange(other.count, 0);
+        return *this;
+    }
+
+    [[nodiscard]]
+    std::span<T> local() const noexcept {
+        return {data.get(), count};
+    }
+
+    [[nodiscard]]
+    std::span<T> segment([[maybe_unused]] id_type rank) const noexcept {
+        assert(rank == 0);
+        return local();
+    }
+
+    [[nodiscard]]
+    constexpr id_type size() const noexcept {
+        return 1;
+    }
+
+    constexpr void fence() const noexcept { }
+
+    [[nodiscard]]
+    constexpr epoch lock_all() const noexcept {
+        return {};
+    }
+
+    [[nodiscard]]
+    epoch lock([[maybe_unused]] id_type rank) const noexcept {
+        assert(rank == 0);
+        return {};
+    }
+
+    constexpr void sync() const noexcept { }
+
+  private:
+    std::unique_ptr<T[]> data;
+    std::size_t count;
+};
+
+}
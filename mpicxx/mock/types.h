@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <mpicxx/common/types.h>
 
 namespace mpi {
@@ -16,7 +18,7 @@ struct basic_status<OS, false>
 
 template<Os OS>
 struct typedefs<OS, false> {
-    using size_type = int;
+    using size_type = std::int64_t;
     using id_type = int;
     using tag_type = int;
 
@@ -36,7 +38,11 @@ struct typedefs<OS, false> {
         signed_char_,
         unsigned_char_,
         wchar_t_,
-        bool_
+        bool_,
+        complex_float_,
+        complex_double_,
+        complex_long_double_,
+        derived_
     };
 };
 
@@ -57,6 +63,9 @@ template<> [[nodiscard]] constexpr typedefs<Os::Linux, false>::datatype get_data
 template<> [[nodiscard]] constexpr typedefs<Os::Linux, false>::datatype get_datatype<Os::Linux, false, double>()             noexcept { return typedefs<Os::Linux, false>::datatype::double_; }
 template<> [[nodiscard]] constexpr typedefs<Os::Linux, false>::datatype get_datatype<Os::Linux, false, long double>()        noexcept { return typedefs<Os::Linux, false>::datatype::long_double_; }
 template<> [[nodiscard]] constexpr typedefs<Os::Linux, false>::datatype get_datatype<Os::Linux, false, bool>()               noexcept { return typedefs<Os::Linux, false>::datatype::bool_; }
+template<> [[nodiscard]] constexpr typedefs<Os::Linux, false>::datatype get_datatype<Os::Linux, false, std::complex<float>>()       noexcept { return typedefs<Os::Linux, false>::datatype::complex_float_; }
+template<> [[nodiscard]] constexpr typedefs<Os::Linux, false>::datatype get_datatype<Os::Linux, false, std::complex<double>>()      noexcept { return typedefs<Os::Linux, false>::datatype::complex_double_; }
+template<> [[nodiscard]] constexpr typedefs<Os::Linux, false>::datatype get_datatype<Os::Linux, false, std::complex<long double>>() noexcept { return typedefs<Os::Linux, false>::datatype::complex_long_double_; }
 
 template<> [[nodiscard]] constexpr typedefs<Os::Windows, false>::datatype get_datatype<Os::Windows, false, char>()               noexcept { return typedefs<Os::Windows, false>::datatype::char_; }
 template<> [[nodiscard]] constexpr typedefs<Os::Windows, false>::datatype get_datatype<Os::Windows, false, signed char>()        noexcept { return typedefs<Os::Windows, false>::datatype::signed_char_; }
@@ -74,6 +83,13 @@ template<> [[nodiscard]] constexpr typedefs<Os::Windows, false>::datatype get_da
 template<> [[nodiscard]] constexpr typedefs<Os::Windows, false>::datatype get_datatype<Os::Windows, false, double>()             noexcept { return typedefs<Os::Windows, false>::datatype::double_; }
 template<> [[nodiscard]] constexpr typedefs<Os::Windows, false>::datatype get_datatype<Os::Windows, false, long double>()        noexcept { return typedefs<Os::Windows, false>::datatype::long_double_; }
 template<> [[nodiscard]] constexpr typedefs<Os::Windows, false>::datatype get_datatype<Os::Windows, false, bool>()               noexcept { return typedefs<Os::Windows, false>::datatype::bool_; }
+template<> [[nodiscard]] constexpr typedefs<Os::Windows, false>::datatype get_datatype<Os::Windows, false, std::complex<float>>()       noexcept { return typedefs<Os::Windows, false>::datatype::complex_float_; }
+template<> [[nodiscard]] constexpr typedefs<Os::Windows, false>::datatype get_datatype<Os::Windows, false, std::complex<double>>()      noexcept { return typedefs<Os::Windows, false>::datatype::complex_double_; }
+template<> [[nodiscard]] constexpr typedefs<Os::Windows, false>::datatype get_datatype<Os::Windows, false, std::complex<long double>>() noexcept { return typedefs<Os::Windows, false>::datatype::complex_long_double_; }
+
 
+// No datatype needs to be built without MPI
+template<Os OS, bool MpiEnabled, DerivedType T> requires (!MpiEnabled)
+[[nodiscard]] constexpr typename typedefs<OS, false>::datatype get_datatype() noexcept { return typedefs<OS, false>::datatype::derived_; }
 
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include <mpicxx/common/extra_type_traits.h>
+#include <mpicxx/common/operations.h>
+#include <mpicxx/common/window.h>
+#include "communicator.h"
+#include "environment.h"
+
+namespace mpi {
+
+// Mock implementation for MPI_ENABLED = false
+// The only target is the rank itself, so operations act on local memory immediately
+template<Os OS, mpi::ValidType T>
+class basic_window<OS, false, T> {
+  public:
+    using communicator = basic_communicator<OS, false>;
+    using environment = basic_environment<OS, false>;
+    using size_type = typename communicator::size_type;
+    using id_type = typename communicator::id_type;
+    using handle_type = void*;
+
+    // Guards are still non-trivial, so that they are not reported as unused variables
+    class epoch {
+      public:
+        ~epoch() noexcept { }
+
+        constexpr void close() noexcept { }
+    };
+
+    basic_window(communicator const&, size_type count)
+        : owned(std::make_unique<T[]>(static_cast<std::size_t>(count)))
+        , memory(owned.get(), static_cast<std::size_t>(count))
+    {
+        environment::assert_running();
+        assert(count >= 0);
+    }
+
+    basic_window(communicator const&, std::span<T> exposed)
+        : memory(exposed)
+    {
+        environment::assert_running();
+    }
+
+    basic_window(basic_window const&) = delete;
+    basic_window& operator=(basic_window const&) = delete;
+
+    basic_window(basic_window&& other) noexcept
+        : owned(std::move(other.owned))
+        , memory(std::exchange(other.memory, {}))
+    {
+    }
+
+    basic_window& operator=(basic_window&& other) noexcept {
+        owned = std::move(other.owned);
+        memory = std::exchange(other.memory, {});
+        return *this;
+    }
+
+    [[nodiscard]]
+    std::span<T> local() const noexcept {
+        return memory;
+    }
+
+    constexpr void fence() const noexcept { }
+
+    [[nodiscard]]
+    constexpr epoch fence_epoch() const noexcept {
+        return {};
+    }
+
+    [[nodiscard]]
+    epoch access([[maybe_unused]] std::span<const id_type> targets) const noexcept {
+        assert(std::ranges::all_of(targets, [](id_type r){ return r == 0; }));
+        return {};
+    }
+
+    [[nodiscard]]
+    epoch expose([[maybe_unused]] std::span<const id_type> origins) const noexcept {
+        assert(std::ranges::all_of(origins, [](id_type r){ return r == 0; }));
+        return {};
+    }
+
+    [[nodiscard]]
+    epoch lock([[maybe_unused]] id_type target, lock_type = lock_type::exclusive) const noexcept {
+        assert(target == 0);
+        return {};
+    }
+
+    [[nodiscard]]
+    constexpr epoch lock_all() const noexcept {
+        return {};
+    }
+
+    constexpr void flush(id_type) const noexcept { }
+
+    constexpr void flush_all() const noexcept { }
+
+    void put(T const& data, id_type target, size_type offset) const noexcept {
+        at(target, offset, 1)[0] = data;
+    }
+
+    template<mpi::ValidContainer C>
+        requires std::same_as<typename container_traits<C>::data, T>
+    void put(C const& data, id_type target, size_type offset) const noexcept {
+        const auto count = container_traits<C>::size(data);
+        std::copy_n(container_traits<C>::pointer(data), count, at(target, offset, count).begin());
+    }
+
+    void get(T& output, id_type target, size_type offset) const noexcept {
+        output = at(target, offset, 1)[0];
+    }
+
+    template<mpi::ValidContainer C>
+        requires std::same_as<typename container_traits<C>::data, T>
+    void get(C& output, id_type target, size_type offset) const noexcept {
+        const auto count = container_traits<C>::size(output);
+        std::ranges::copy(at(target, offset, count), container_traits<C>::pointer(output));
+    }
+
+    template<mpi::BuiltinOperation<T> Op>
+    void accumulate(T const& data, id_type target, size_type offset, Op op) const noexcept {
+        T& element = at(target, offset, 1)[0];
+        element = static_cast<T>(op(element, data));
+    }
+
+    template<mpi::ValidContainer C, mpi::BuiltinOperation<T> Op>
+        requires std::same_as<typename container_traits<C>::data, T>
+    void accumulate(C const& data, id_type target, size_type offset, Op op) const noexcept {
+        const auto count = container_traits<C>::size(data);
+        auto elements = at(target, offset, count);
+        T const* source = container_traits<C>::pointer(data);
+        for(std::size_t i=0; i < count; ++i) {
+            elements[i] = static_cast<T>(op(elements[i], source[i]));
+        }
+    }
+
+    template<mpi::BuiltinOperation<T> Op>
+    void fetch_and_op(T const& data, T& result, id_type target, size_type offset, Op op) const noexcept {
+        T& element = at(target, offset, 1)[0];
+        result = element;
+        element = static_cast<T>(op(element, data));
+    }
+
+    void compare_and_swap(T const& desired, T const& expected, T& result, id_type target, size_type offset) const noexcept
+        requires mpi::BuiltinLogical<T>
+    {
+        T& element = at(target, offset, 1)[0];
+        result = element;
+        if(element == expected) {
+            element = desired;
+        }
+    }
+
+  private:
+    std::unique_ptr<T[]> owned;
+    std::span<T> memory;
+
+    [[nodiscard]]
+    std::span<T> at([[maybe_unused]] id_type target, size_type offset, std::size_t count) const noexcept {
+        environment::assert_running();
+        assert(target == 0);
+        assert(offset >= 0 && static_cast<std::size_t>(offset) + count <= memory.size());
+        return memory.subspan(static_cast<std::size_t>(offset), count);
+    }
+};
+
+}
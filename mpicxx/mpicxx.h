@@ -2,19 +2,84 @@
 
 #include "mpicxx/common/defines.h"
 
+#include "mock/allocator.h"
+#include "mock/cartesian.h"
 #include "mock/communicator.h"
 #include "mock/environment.h"
+#include "mock/request.h"
+#include "mock/shared_window.h"
 #include "mock/types.h"
+#include "mock/window.h"
 
+#include "linux/allocator.h"
+#include "linux/cartesian.h"
 #include "linux/communicator.h"
 #include "linux/environment.h"
+#include "linux/request.h"
+#include "linux/shared_window.h"
 #include "linux/types.h"
+#include "linux/window.h"
+
+#include "threads/allocator.h"
+#include "threads/communicator.h"
+#include "threads/environment.h"
+#include "threads/request.h"
+#include "threads/world.h"
+
+#include "common/aggregator.h"
+#include "common/profiler.h"
+#include "common/tracer.h"
+#include "common/progress_engine.h"
+#include "common/scheduler.h"
+#include "common/strided_view.h"
+#include "common/task.h"
+#include "common/work_queue.h"
 
 namespace mpi {
 
 using communicator = basic_communicator<os(), mpi_enabled()>;
+using cartesian_communicator = basic_cartesian_communicator<os(), mpi_enabled()>;
 using status = basic_status<os(), mpi_enabled()>;
+using envelope = basic_envelope<os(), mpi_enabled()>;
 using environment = basic_environment<os(), mpi_enabled()>;
+using request = basic_request<os(), mpi_enabled()>;
+using persistent_request = basic_persistent_request<os(), mpi_enabled()>;
+
+using memory_pool = basic_memory_pool<os(), mpi_enabled()>;
+
+template<typename T>
+using allocator = basic_allocator<os(), mpi_enabled(), T>;
+
+// Vector whose storage comes from the memory pool, and whose resize leaves new elements default-initialized
+template<typename T>
+using buffer = std::vector<T, allocator<T>>;
+
+template<typename T>
+using shared_window = basic_shared_window<os(), mpi_enabled(), T>;
+
+template<typename T>
+using window = basic_window<os(), mpi_enabled(), T>;
+
+using aggregator = basic_aggregator<os(), mpi_enabled()>;
+
+using distributed_work_queue = basic_distributed_work_queue<os(), mpi_enabled()>;
+
+using scheduler = basic_scheduler<os(), mpi_enabled()>;
+
+using progress_engine = basic_progress_engine<os(), mpi_enabled()>;
+
+using profiler = basic_profiler<os(), mpi_enabled()>;
+
+using tracer = basic_tracer<os(), mpi_enabled()>;
+using trace_region = tracer::region;
+
+template<typename T>
+using halo_exchange = basic_halo_exchange<os(), mpi_enabled(), T>;
+
+// Every rank is a thread of this process, whatever the platform and MPI_ENABLED (see run_threads)
+using thread_communicator = basic_communicator<Os::Threads, false>;
+using thread_request = basic_request<Os::Threads, false>;
+using thread_status = basic_status<Os::Threads, false>;
 
 using size_type = typedefs<os(), mpi_enabled()>::size_type;
 using id_type = typedefs<os(), mpi_enabled()>::id_type;
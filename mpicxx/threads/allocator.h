@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include <mpicxx/common/allocator.h>
+
+namespace mpi {
+
+template<>
+inline void* basic_memory_pool<Os::Threads, false>::allocate_impl(std::size_t bytes)
+{
+    if(void* p = std::malloc(bytes)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+template<>
+inline void basic_memory_pool<Os::Threads, false>::deallocate_impl(void* p) noexcept { std::free(p); }
+
+}
\ No newline at end of file
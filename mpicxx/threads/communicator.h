@@ -0,0 +1,1501 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <mpicxx/common/cartesian.h>
+#include <mpicxx/common/communicator.h>
+#include <mpicxx/common/operations.h>
+#include <mpicxx/common/shared_window.h>
+#include <mpicxx/common/strided_view.h>
+#include <mpicxx/common/window.h>
+#include <mpicxx/mock/types.h>
+#include "environment.h"
+#include "request.h"
+#include "world.h"
+
+namespace mpi {
+
+// Runs every rank as a thread of this process, so that multi-rank code runs without MPI (see run_threads).
+// Messages go through a mailbox per rank, matched by source and tag in the order they were sent, as in MPI. Blocking
+// sends copy the data at once, nonblocking ones lend the buffer until the receiver has copied it, and containers
+// sent as rvalues are handed over whole, so that a receiver of the same type takes over their storage.
+template<>
+class basic_communicator<Os::Threads, false> {
+  public:
+    using size_type = typename typedefs<Os::Threads, false>::size_type;
+    using id_type = typename typedefs<Os::Threads, false>::id_type;
+    using tag_type = typename typedefs<Os::Threads, false>::tag_type;
+
+    using status = basic_status<Os::Threads, false>;
+    using envelope = basic_envelope<Os::Threads, false>;
+    using environment = basic_environment<Os::Threads, false>;
+    using request = basic_request<Os::Threads, false>;
+    using persistent_request = basic_persistent_request<Os::Threads, false>;
+    using handle_type = thread_group*;
+
+    // Wildcards for the source and tag of recv, probe and iprobe
+    static constexpr id_type any_source = -1;
+    static constexpr tag_type any_tag = -1;
+
+    // Color of the ranks that split leaves out
+    static constexpr int undefined = -1;
+
+    // Rank of a group, which is shared with the other ranks and lives as long as any communicator uses it
+    basic_communicator(std::shared_ptr<thread_group> group, id_type rank)
+        : group(std::move(group))
+        , communicator_rank(rank)
+    {
+        environment::initialize();
+        assert(rank >= 0 && rank < this->group->size());
+    }
+
+    // Copies are non-owning views, as in the MPI implementation
+    basic_communicator(basic_communicator const& other) noexcept
+        : group(other.group)
+        , communicator_rank(other.communicator_rank)
+    {
+    }
+
+    basic_communicator(basic_communicator&& other) noexcept
+        : group(other.group)
+        , communicator_rank(other.communicator_rank)
+        , is_owning(std::exchange(other.is_owning, false))
+    {
+    }
+
+    basic_communicator& operator=(basic_communicator const& other) noexcept {
+        if(this != &other) {
+            group = other.group;
+            communicator_rank = other.communicator_rank;
+            is_owning = false;
+        }
+        return *this;
+    }
+
+    basic_communicator& operator=(basic_communicator&& other) noexcept {
+        if(this != &other) {
+            group = other.group;
+            communicator_rank = other.communicator_rank;
+            is_owning = std::exchange(other.is_owning, false);
+        }
+        return *this;
+    }
+
+    // World of the calling thread. Threads that were not started by run_threads are a world of a single rank.
+    [[nodiscard]]
+    static basic_communicator get_default()
+    {
+        auto& current = current_thread_rank;
+        if(!current.world) {
+            current.world = std::make_shared<thread_group>(std::vector{std::make_shared<thread_signal>()});
+        }
+        return basic_communicator{current.world, current.rank};
+    }
+
+    [[nodiscard]]
+    basic_communicator dup() const {
+        return *split(0, rank());
+    }
+
+    // Splits the ranks into one communicator per color, ordered by key. Rank 0 creates all the groups and hands
+    // each rank its own. Colors must not be negative, except for undefined: those ranks are left out, and get nullopt.
+    [[nodiscard]]
+    std::optional<basic_communicator> split(int color, int key) const {
+        environment::assert_running();
+        assert(color >= 0 || color == undefined);
+
+        const std::vector<int> mine{color, key};
+        std::vector<int> all;
+        allgather(mine, all);
+
+        const auto members = [&](int c) {
+            std::vector<id_type> ranks;
+            for(id_type r=0; r < size(); ++r) {
+                if(all[static_cast<std::size_t>(2 * r)] == c) {
+                    ranks.push_back(r);
+                }
+            }
+            std::stable_sort(ranks.begin(), ranks.end(), [&](id_type a, id_type b) {
+                return all[static_cast<std::size_t>(2 * a + 1)] < all[static_cast<std::size_t>(2 * b + 1)];
+            });
+            return ranks;
+        };
+
+        const auto own = members(color);
+        const auto new_rank = static_cast<id_type>(std::find(own.begin(), own.end(), rank()) - own.begin());
+
+        if(rank() != 0) {
+            if(color == undefined) {
+                return std::nullopt;
+            }
+            auto m = receive(collective_context, 0, split_tag);
+            return adopt(std::static_pointer_cast<thread_group>(m.object), new_rank);
+        }
+
+        std::map<int, std::shared_ptr<thread_group>> groups;
+        for(id_type r=0; r < size(); ++r) {
+            const int c = all[static_cast<std::size_t>(2 * r)];
+            if(c == undefined) {
+                continue;
+            }
+            if(!groups.contains(c)) {
+                std::vector<std::shared_ptr<thread_signal>> signals;
+                for(id_type member: members(c)) {
+                    signals.push_back(group->signals()[static_cast<std::size_t>(member)]);
+                }
+                groups.emplace(c, std::make_shared<thread_group>(std::move(signals)));
+            }
+            if(r != 0) {
+                post_shared(r, collective_context, split_tag, groups[c], typeid(thread_group), nullptr, 0);
+            }
+        }
+        if(color == undefined) {
+            return std::nullopt;
+        }
+        return adopt(groups[color], new_rank);
+    }
+
+    // All the ranks share the memory of this process
+    [[nodiscard]]
+    basic_communicator split_shared(int key = 0) const {
+        return *split(0, key);
+    }
+
+    [[nodiscard]]
+    bool owning() const noexcept {
+        return is_owning;
+    }
+
+    // The group is released along with the last communicator that uses it
+    void free() noexcept {
+        is_owning = false;
+    }
+
+    [[nodiscard]]
+    id_type size() const noexcept {
+        environment::assert_running();
+        return group->size();
+    }
+
+    [[nodiscard]]
+    id_type rank() const noexcept {
+        environment::assert_running();
+        return communicator_rank;
+    }
+
+    [[nodiscard]]
+    static std::string processor_name() noexcept {
+        return "ThreadsProcessor";
+    }
+
+    void barrier() const {
+        environment::assert_running();
+        static_cast<void>(tree_reduce(barrier_tag, static_cast<char const*>(nullptr), 0, std::plus<char>{}));
+        tree_broadcast(0, barrier_tag, nullptr, 0);
+    }
+
+    // Every rank tells every other one that it has arrived
+    [[nodiscard]]
+    request ibarrier() const {
+        environment::assert_running();
+        for(id_type r=0; r < size(); ++r) {
+            if(r != rank()) {
+                post_owned(r, collective_context, ibarrier_tag, {});
+            }
+        }
+        return receive_all_request(ibarrier_tag, [](id_type, thread_message&) { });
+    }
+
+    template<mpi::ValidType T>
+    void send(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        post_copy(destination, p2p_context, tag, &data, sizeof(T));
+    }
+
+    template<mpi::ValidContainer T>
+    void send(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        post_copy(destination, p2p_context, tag, container_traits<T>::pointer(data), bytes_of(data));
+    }
+
+    // Rvalue containers are handed over whole: a receiver of the same type takes over their storage, so that
+    // nothing is copied
+    template<mpi::ValidContainer C>
+        requires mpi::ResizableContainer<C>
+    void send(id_type destination, tag_type tag, C&& data) const {
+        environment::assert_running();
+        post_object(destination, p2p_context, tag, std::move(data));
+    }
+
+    template<typename T>
+        requires mpi::MappedType<std::remove_const_t<T>>
+    void send(id_type destination, tag_type tag, strided_view<T> data) const {
+        environment::assert_running();
+        post_owned(destination, p2p_context, tag, pack(data));
+    }
+
+    template<mpi::ValidType T>
+    void recv(id_type source, tag_type tag, T& data, status& status) const {
+        environment::assert_running();
+        auto m = receive(p2p_context, source, tag);
+        fill_status(m, status);
+        unpack(m, data);
+    }
+
+    // Resizable containers are resized to fit the message
+    template<mpi::ValidContainer T>
+    void recv(id_type source, tag_type tag, T& data, status& status) const {
+        environment::assert_running();
+        auto m = receive(p2p_context, source, tag);
+        fill_status(m, status);
+        unpack(m, data);
+    }
+
+    // The message must have exactly as many elements as the view
+    template<mpi::MappedType T>
+    void recv(id_type source, tag_type tag, strided_view<T> data, status& status) const {
+        environment::assert_running();
+        auto m = receive(p2p_context, source, tag);
+        fill_status(m, status);
+        unpack(m, data);
+    }
+
+    // Blocks until a matching message arrives, and returns its envelope without receiving it.
+    // The count is in elements of T.
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    envelope probe(id_type source, tag_type tag) const {
+        environment::assert_running();
+        std::optional<thread_header> header;
+        signal().wait_until([&] {
+            header = own_mailbox().peek(p2p_context, source, tag);
+            return header.has_value();
+        });
+        return make_envelope<T>(*header);
+    }
+
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    std::optional<envelope> iprobe(id_type source, tag_type tag) const {
+        environment::assert_running();
+        const auto header = own_mailbox().peek(p2p_context, source, tag);
+        if(!header) {
+            return std::nullopt;
+        }
+        return make_envelope<T>(*header);
+    }
+
+    // Receives into a resizable container if a matching message has arrived, which completes at once.
+    // Otherwise, returns nullopt and leaves the container untouched.
+    template<mpi::ValidContainer T>
+        requires mpi::ResizableContainer<T>
+    [[nodiscard]]
+    std::optional<request> try_irecv(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        auto m = own_mailbox().take(p2p_context, source, tag);
+        if(!m) {
+            return std::nullopt;
+        }
+        unpack(*m, data);
+        return request{};
+    }
+
+    // The data is lent to the receiver, and the request completes once it has been copied
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    request isend(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        return lend(destination, p2p_context, tag, &data, sizeof(T));
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    request isend(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        return lend(destination, p2p_context, tag, container_traits<T>::pointer(data), bytes_of(data));
+    }
+
+    // Strided views are packed, so the request is already complete
+    template<typename T>
+        requires mpi::MappedType<std::remove_const_t<T>>
+    [[nodiscard]]
+    request isend(id_type destination, tag_type tag, strided_view<T> data) const {
+        send(destination, tag, data);
+        return {};
+    }
+
+    // Temporaries would be gone before the request completes, unless they are views of data that outlives them
+    template<typename T>
+        requires (!std::ranges::borrowed_range<T>)
+    request isend(id_type, tag_type, T const&&) const = delete;
+
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    request irecv(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        return receive_request(p2p_context, source, tag, [&data](thread_message& m) { unpack(m, data); });
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    request irecv(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        return receive_request(p2p_context, source, tag, [&data](thread_message& m) { unpack(m, data); });
+    }
+
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    request irecv(id_type source, tag_type tag, strided_view<T> data) const {
+        environment::assert_running();
+        return receive_request(p2p_context, source, tag, [data](thread_message& m) { unpack(m, data); });
+    }
+
+    // Each start posts a new nonblocking send of the data, which must outlive the request
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    persistent_request send_init(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        return persistent_request([comm = *this, destination, tag, &data] { return comm.isend(destination, tag, data); });
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    persistent_request send_init(id_type destination, tag_type tag, T const& data) const {
+        environment::assert_running();
+        return persistent_request([comm = *this, destination, tag, &data] { return comm.isend(destination, tag, data); });
+    }
+
+    // Takes the data by value and keeps it inside the request, which exposes it through persistent_request::data
+    template<typename T>
+        requires (!std::is_reference_v<T> && (mpi::ValidType<T> || mpi::ValidContainer<T>))
+    [[nodiscard]]
+    persistent_request send_init(id_type destination, tag_type tag, T&& data) const {
+        owned_data owned(std::move(data));
+        auto r = send_init(destination, tag, owned.template get<std::remove_cv_t<T>>());
+        r.adopt(std::move(owned));
+        return r;
+    }
+
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    persistent_request recv_init(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        return persistent_request([comm = *this, source, tag, &data] { return comm.irecv(source, tag, data); });
+    }
+
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    persistent_request recv_init(id_type source, tag_type tag, T& data) const {
+        environment::assert_running();
+        return persistent_request([comm = *this, source, tag, &data] { return comm.irecv(source, tag, data); });
+    }
+
+    template<typename T>
+        requires (!std::is_reference_v<T> && (mpi::ValidType<T> || mpi::ValidContainer<T>))
+    [[nodiscard]]
+    persistent_request recv_init(id_type source, tag_type tag, T&& data) const {
+        owned_data owned(std::move(data));
+        auto r = recv_init(source, tag, owned.template get<std::remove_cv_t<T>>());
+        r.adopt(std::move(owned));
+        return r;
+    }
+
+    template<mpi::ValidType T>
+    void broadcast(id_type source, T& data) const {
+        environment::assert_running();
+        tree_broadcast(source, broadcast_tag, &data, sizeof(T));
+    }
+
+    template<mpi::ValidContainer T>
+    void broadcast(id_type source, T& data) const {
+        environment::assert_running();
+        tree_broadcast(source, broadcast_tag, container_traits<T>::pointer(data), bytes_of(data));
+    }
+
+    template<mpi::MappedType T>
+    void broadcast(id_type source, strided_view<T> data) const {
+        environment::assert_running();
+        std::vector<std::byte> packed = rank() == source ? pack(data) : std::vector<std::byte>(data.size() * sizeof(T));
+        tree_broadcast(source, broadcast_tag, packed.data(), packed.size());
+        if(rank() != source) {
+            unpack_bytes(packed.data(), data);
+        }
+    }
+
+    // The source lends the data to every other rank at once
+    template<mpi::ValidType T>
+    [[nodiscard]]
+    request ibroadcast(id_type source, T& data) const {
+        environment::assert_running();
+        return flat_broadcast(source, &data, sizeof(T));
+    }
+
+    // The container is not resized, so it must already have the size of the message in every rank
+    template<mpi::ValidContainer T>
+    [[nodiscard]]
+    request ibroadcast(id_type source, T& data) const {
+        environment::assert_running();
+        return flat_broadcast(source, container_traits<T>::pointer(data), bytes_of(data));
+    }
+
+    template<mpi::ValidContainer C>
+    void gather(id_type destination, typename container_traits<C>::data data, C& output) const {
+        environment::assert_running();
+        if(rank() != destination) {
+            send_lent(destination, gather_tag, &data, sizeof(data));
+            return;
+        }
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(size()));
+        auto* out = container_traits<C>::pointer(output);
+        out[rank()] = data;
+        place(receive_from_all(gather_tag), out, equal_counts(1));
+    }
+
+    template<mpi::ValidContainer C>
+    void gather(id_type destination, C const& data, C& output) const {
+        environment::assert_running();
+        if(rank() != destination) {
+            send_lent(destination, gather_tag, container_traits<C>::pointer(data), bytes_of(data));
+            return;
+        }
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size * static_cast<std::size_t>(size()));
+        auto* out = container_traits<C>::pointer(output);
+        std::copy_n(container_traits<C>::pointer(data), msg_size, out + static_cast<std::size_t>(rank()) * msg_size);
+        place(receive_from_all(gather_tag), out, equal_counts(msg_size));
+    }
+
+    // In-place gather. In the destination, data holds the messages of all ranks and its own contribution must already
+    // be at its offset, so it is not copied. In the other ranks, data is the message to send.
+    template<mpi::ValidContainer C>
+    void gather(id_type destination, C& data) const {
+        environment::assert_running();
+        if(rank() != destination) {
+            send_lent(destination, gather_tag, container_traits<C>::pointer(data), bytes_of(data));
+            return;
+        }
+        const std::size_t total = container_traits<C>::size(data);
+        assert(total % static_cast<std::size_t>(size()) == 0);
+        place(receive_from_all(gather_tag), container_traits<C>::pointer(data), equal_counts(total / static_cast<std::size_t>(size())));
+    }
+
+    // The output is resized before returning, and filled once the request completes
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igather(id_type destination, typename container_traits<C>::data const& data, C& output) const {
+        environment::assert_running();
+        if(rank() != destination) {
+            return lend(destination, collective_context, igather_tag, &data, sizeof(data));
+        }
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(size()));
+        auto* out = container_traits<C>::pointer(output);
+        out[rank()] = data;
+        return receive_all_request(igather_tag, placer(out, equal_counts(1)));
+    }
+
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igather(id_type destination, C const& data, C& output) const {
+        environment::assert_running();
+        if(rank() != destination) {
+            return lend(destination, collective_context, igather_tag, container_traits<C>::pointer(data), bytes_of(data));
+        }
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size * static_cast<std::size_t>(size()));
+        auto* out = container_traits<C>::pointer(output);
+        std::copy_n(container_traits<C>::pointer(data), msg_size, out + static_cast<std::size_t>(rank()) * msg_size);
+        return receive_all_request(igather_tag, placer(out, equal_counts(msg_size)));
+    }
+
+    // Temporaries would be gone before the request completes, unless they are views of data that outlives them
+    template<typename T, typename C>
+        requires (!std::ranges::borrowed_range<T>)
+    request igather(id_type, T const&&, C&) const = delete;
+
+    // Sends the i-th element of the data in the source rank to rank i
+    template<mpi::ValidContainer C>
+    void scatter(id_type source, C const& data, typename container_traits<C>::data& output) const {
+        environment::assert_running();
+        if(rank() != source) {
+            unpack(receive(collective_context, source, scatter_tag), output);
+            return;
+        }
+        assert(container_traits<C>::size(data) >= static_cast<std::size_t>(size()));
+        lend_slices(scatter_tag, container_traits<C>::pointer(data), equal_counts(1), &output);
+    }
+
+    // Splits the data in the source rank into equally-sized chunks, and sends the i-th chunk to rank i.
+    // The size of the output determines the size of the chunks, so it must be the same in all ranks.
+    template<mpi::ValidContainer C>
+    void scatter(id_type source, C const& data, C& output) const {
+        environment::assert_running();
+        if(rank() != source) {
+            auto m = receive(collective_context, source, scatter_tag);
+            copy_into(m, container_traits<C>::pointer(output), bytes_of(output));
+            return;
+        }
+        const std::size_t msg_size = container_traits<C>::size(output);
+        assert(container_traits<C>::size(data) >= msg_size * static_cast<std::size_t>(size()));
+        lend_slices(scatter_tag, container_traits<C>::pointer(data), equal_counts(msg_size), container_traits<C>::pointer(output));
+    }
+
+    template<mpi::ValidContainer C>
+    void allgather(typename container_traits<C>::data data, C& output) const {
+        environment::assert_running();
+        const auto lent = lend_to_all(allgather_tag, &data, sizeof(data));
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(size()));
+        auto* out = container_traits<C>::pointer(output);
+        out[rank()] = data;
+        place(receive_from_all(allgather_tag), out, equal_counts(1));
+        wait_copied(lent);
+    }
+
+    // All ranks must send containers of the same size
+    template<mpi::ValidContainer C>
+    void allgather(C const& data, C& output) const {
+        environment::assert_running();
+        allgatherv(data, output, equal_counts(container_traits<C>::size(data)));
+    }
+
+    // In-place allgather. Data holds the messages of all ranks, and the contribution of each rank must already be
+    // at its offset. All ranks must pass containers of the same size.
+    template<mpi::ValidContainer C>
+    void allgather(C& data) const {
+        environment::assert_running();
+        const std::size_t total = container_traits<C>::size(data);
+        assert(total % static_cast<std::size_t>(size()) == 0);
+        const std::size_t msg_size = total / static_cast<std::size_t>(size());
+
+        auto* ptr = container_traits<C>::pointer(data);
+        const auto lent = lend_to_all(allgather_tag, ptr + static_cast<std::size_t>(rank()) * msg_size, msg_size * sizeof(*ptr));
+        place(receive_from_all(allgather_tag), ptr, equal_counts(msg_size));
+        wait_copied(lent);
+    }
+
+    // Splits the data into equally-sized chunks, and sends the i-th chunk to rank i.
+    // The output contains the chunks recieved from every rank, in order.
+    template<mpi::ValidContainer C>
+    void alltoall(C const& data, C& output) const {
+        environment::assert_running();
+        const std::size_t total_size = container_traits<C>::size(data);
+        assert(total_size % static_cast<std::size_t>(size()) == 0);
+        const auto counts = equal_counts(total_size / static_cast<std::size_t>(size()));
+        alltoallv(data, output, counts, counts);
+    }
+
+    // Sends send_counts[i] elements to rank i, taken back-to-back from the data.
+    // The output is resized once to fit all recieved messages, whose sizes need not be exchanged beforehand.
+    template<mpi::ValidContainer C>
+    void alltoallv(C const& data, C& output, std::span<const size_type> send_counts) const {
+        environment::assert_running();
+        handoffs lent;
+        auto messages = alltoall_messages(data, send_counts, lent);
+        const auto recv_counts = received_counts<C>(messages, send_counts[static_cast<std::size_t>(rank())]);
+        finish_alltoall(data, output, send_counts, recv_counts, std::move(messages), lent);
+    }
+
+    // Sends send_counts[i] elements to rank i, and recieves recv_counts[i] elements from rank i
+    template<mpi::ValidContainer C>
+    void alltoallv(C const& data, C& output, std::span<const size_type> send_counts, std::span<const size_type> recv_counts) const {
+        environment::assert_running();
+        assert(recv_counts.size() == static_cast<std::size_t>(size()));
+        handoffs lent;
+        auto messages = alltoall_messages(data, send_counts, lent);
+        finish_alltoall(data, output, send_counts, recv_counts, std::move(messages), lent);
+    }
+
+    // Gathers containers of different sizes. The output is resized once to fit all messages, whose sizes need not
+    // be exchanged beforehand.
+    template<mpi::ValidContainer C>
+    void gatherv(id_type destination, C const& data, C& output) const {
+        environment::assert_running();
+        if(rank() != destination) {
+            send_lent(destination, gatherv_tag, container_traits<C>::pointer(data), bytes_of(data));
+            return;
+        }
+        auto messages = receive_from_all(gatherv_tag);
+        const auto counts = received_counts<C>(messages, static_cast<size_type>(container_traits<C>::size(data)));
+        gather_into(data, output, counts, std::move(messages));
+    }
+
+    // Gathers containers of different sizes. Counts are only read at the destination.
+    template<mpi::ValidContainer C>
+    void gatherv(id_type destination, C const& data, C& output, std::span<const size_type> counts) const {
+        environment::assert_running();
+        if(rank() != destination) {
+            send_lent(destination, gatherv_tag, container_traits<C>::pointer(data), bytes_of(data));
+            return;
+        }
+        assert(counts.size() == static_cast<std::size_t>(size()));
+        gather_into(data, output, counts, receive_from_all(gatherv_tag));
+    }
+
+    // Nonblocking gatherv. Message sizes are gathered before returning, so only the data transfer overlaps.
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igatherv(id_type destination, C const& data, C& output) const {
+        environment::assert_running();
+        std::vector<size_type> counts;
+        gather(destination, static_cast<size_type>(container_traits<C>::size(data)), counts);
+        return igatherv(destination, data, output, counts);
+    }
+
+    // Nonblocking gatherv with known message sizes
+    template<mpi::ValidContainer C>
+    [[nodiscard]]
+    request igatherv(id_type destination, C const& data, C& output, std::span<const size_type> counts) const {
+        environment::assert_running();
+        if(rank() != destination) {
+            return lend(destination, collective_context, igatherv_tag, container_traits<C>::pointer(data), bytes_of(data));
+        }
+        assert(counts.size() == static_cast<std::size_t>(size()));
+        const std::vector<size_type> displacements = compute_displacements(counts);
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(displacements.back() + counts.back()));
+        auto* out = container_traits<C>::pointer(output);
+        std::copy_n(container_traits<C>::pointer(data), container_traits<C>::size(data),
+                    out + displacements[static_cast<std::size_t>(rank())]);
+        return receive_all_request(igatherv_tag, placer(out, std::vector<size_type>(counts.begin(), counts.end())));
+    }
+
+    // Gathers containers of different sizes into all ranks. The output is resized once to fit all messages.
+    template<mpi::ValidContainer C>
+    void allgatherv(C const& data, C& output) const {
+        environment::assert_running();
+        const auto lent = lend_to_all(allgatherv_tag, container_traits<C>::pointer(data), bytes_of(data));
+        auto messages = receive_from_all(allgatherv_tag);
+        const auto counts = received_counts<C>(messages, static_cast<size_type>(container_traits<C>::size(data)));
+        gather_into(data, output, counts, std::move(messages));
+        wait_copied(lent);
+    }
+
+    // The message size of every rank must be provided in counts, and be the same in all ranks
+    template<mpi::ValidContainer C>
+    void allgatherv(C const& data, C& output, std::span<const size_type> counts) const {
+        environment::assert_running();
+        assert(counts.size() == static_cast<std::size_t>(size()));
+        const auto lent = lend_to_all(allgatherv_tag, container_traits<C>::pointer(data), bytes_of(data));
+        gather_into(data, output, counts, receive_from_all(allgatherv_tag));
+        wait_copied(lent);
+    }
+
+    // Splits the data in the source rank as evenly as possible among all ranks.
+    // Lower ranks get the extra elements when the size is not divisible by the number of ranks.
+    template<mpi::ValidContainer C>
+    void scatterv(id_type source, C const& data, C& output) const {
+        environment::assert_running();
+        if(rank() != source) {
+            unpack(receive(collective_context, source, scatterv_tag), output);
+            return;
+        }
+        const auto total_size = static_cast<size_type>(container_traits<C>::size(data));
+        std::vector<size_type> counts(static_cast<std::size_t>(size()), total_size / size());
+        std::for_each(counts.begin(), counts.begin() + total_size % size(), [](size_type& c) { ++c; });
+        scatterv(source, data, output, counts);
+    }
+
+    // Splits the data in the source rank, sending counts[i] elements to rank i.
+    // The output is resized to fit the message.
+    template<mpi::ValidContainer C>
+    void scatterv(id_type source, C const& data, C& output, std::span<const size_type> counts) const {
+        environment::assert_running();
+        assert(counts.size() == static_cast<std::size_t>(size()));
+        if(rank() != source) {
+            unpack(receive(collective_context, source, scatterv_tag), output);
+            return;
+        }
+        const auto displacements = compute_displacements(counts);
+        assert(container_traits<C>::size(data) >= static_cast<std::size_t>(displacements.back() + counts.back()));
+
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(counts[static_cast<std::size_t>(rank())]));
+        lend_slices(scatterv_tag, container_traits<C>::pointer(data), std::vector<size_type>(counts.begin(), counts.end()),
+                    container_traits<C>::pointer(output));
+    }
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void reduce(id_type destination, T const& data, T& output, Op op) const {
+        environment::assert_running();
+        reduce_to(destination, &data, 1, &output, op);
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void reduce(id_type destination, C const& data, C& output, Op op) const {
+        environment::assert_running();
+        const std::size_t msg_size = container_traits<C>::size(data);
+        if(rank() == destination) {
+            container_traits<C>::try_resize(output, msg_size);
+        }
+        reduce_to(destination, container_traits<C>::pointer(data), msg_size, container_traits<C>::pointer(output), op);
+    }
+
+    // In-place reduction: the result overwrites the data in the destination, and the data of other ranks is left unmodified
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void reduce(id_type destination, T& data, Op op) const {
+        environment::assert_running();
+        reduce_to(destination, &data, 1, &data, op);
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void reduce(id_type destination, C& data, Op op) const {
+        environment::assert_running();
+        auto* ptr = container_traits<C>::pointer(data);
+        reduce_to(destination, ptr, container_traits<C>::size(data), ptr, op);
+    }
+
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void allreduce(T const& data, T& output, Op op) const {
+        environment::assert_running();
+        reduce_to_all(&data, 1, &output, op);
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void allreduce(C const& data, C& output, Op op) const {
+        environment::assert_running();
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size);
+        reduce_to_all(container_traits<C>::pointer(data), msg_size, container_traits<C>::pointer(output), op);
+    }
+
+    // In-place reduction: the result overwrites the data in every rank, so no second buffer is needed
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void allreduce(T& data, Op op) const {
+        environment::assert_running();
+        reduce_to_all(&data, 1, &data, op);
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void allreduce(C& data, Op op) const {
+        environment::assert_running();
+        auto* ptr = container_traits<C>::pointer(data);
+        reduce_to_all(ptr, container_traits<C>::size(data), ptr, op);
+    }
+
+    // Every rank lends its data to all the others, and combines what it recieves in rank order
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    [[nodiscard]]
+    request iallreduce(T const& data, T& output, Op op) const {
+        environment::assert_running();
+        return flat_allreduce(&data, 1, &output, op);
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    [[nodiscard]]
+    request iallreduce(C const& data, C& output, Op op) const {
+        environment::assert_running();
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size);
+        return flat_allreduce(container_traits<C>::pointer(data), msg_size, container_traits<C>::pointer(output), op);
+    }
+
+    // Temporaries would be gone before the request completes, unless they are views of data that outlives them
+    template<typename T, typename C, typename Op>
+        requires (!std::ranges::borrowed_range<T>)
+    request iallreduce(T const&&, C&, Op) const = delete;
+
+    // Inclusive prefix reduction: rank i obtains the reduction of the data in ranks 0 to i
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void scan(T const& data, T& output, Op op) const {
+        environment::assert_running();
+        prefix_reduce(&data, 1, &output, static_cast<T*>(nullptr), op);
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void scan(C const& data, C& output, Op op) const {
+        environment::assert_running();
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size);
+        auto* out = container_traits<C>::pointer(output);
+        prefix_reduce(container_traits<C>::pointer(data), msg_size, out, static_cast<decltype(out)>(nullptr), op);
+    }
+
+    // Exclusive prefix reduction: rank i obtains the reduction of the data in ranks 0 to i-1.
+    // The output in rank 0 is undefined, as with MPI_Exscan.
+    template<mpi::ValidType T, mpi::ReduceOperation<T> Op>
+    void exscan(T const& data, T& output, Op op) const {
+        environment::assert_running();
+        prefix_reduce(&data, 1, static_cast<T*>(nullptr), &output, op);
+    }
+
+    template<mpi::ValidContainer C, mpi::ReduceOperation<typename container_traits<C>::data> Op>
+    void exscan(C const& data, C& output, Op op) const {
+        environment::assert_running();
+        const std::size_t msg_size = container_traits<C>::size(data);
+        container_traits<C>::try_resize(output, msg_size);
+        auto* out = container_traits<C>::pointer(output);
+        prefix_reduce(container_traits<C>::pointer(data), msg_size, static_cast<decltype(out)>(nullptr), out, op);
+    }
+
+    handle_type handle() const noexcept {
+        return group.get();
+    }
+
+  protected:
+    // Communicator on a group that was just created
+    [[nodiscard]]
+    static basic_communicator adopt(std::shared_ptr<thread_group> g, id_type rank) {
+        basic_communicator comm{std::move(g), rank};
+        comm.is_owning = true;
+        return comm;
+    }
+
+  private:
+    std::shared_ptr<thread_group> group;
+    id_type communicator_rank;
+    bool is_owning = false;
+
+    // Collectives never match point-to-point messages, whatever their tags
+    static constexpr int p2p_context = 0;
+    static constexpr int collective_context = 1;
+
+    enum collective_tag : tag_type {
+        barrier_tag, ibarrier_tag, broadcast_tag, ibroadcast_tag, gather_tag, igather_tag, gatherv_tag, igatherv_tag,
+        scatter_tag, scatterv_tag, allgather_tag, allgatherv_tag, alltoall_tag, reduce_tag, iallreduce_tag, scan_tag,
+        split_tag
+    };
+
+    using handoffs = std::vector<std::shared_ptr<thread_handoff>>;
+
+    // Messages of every other rank, in rank order. The slot of this rank is left empty.
+    using rank_messages = std::vector<std::optional<thread_message>>;
+
+    [[nodiscard]]
+    thread_mailbox& own_mailbox() const noexcept {
+        return group->mailbox(communicator_rank);
+    }
+
+    [[nodiscard]]
+    std::shared_ptr<thread_signal> const& own_signal() const noexcept {
+        return group->signals()[static_cast<std::size_t>(communicator_rank)];
+    }
+
+    [[nodiscard]]
+    thread_signal& signal() const noexcept {
+        return *own_signal();
+    }
+
+    template<ContiguousContainer C>
+    [[nodiscard]]
+    static std::size_t bytes_of(C const& data) noexcept {
+        return container_traits<C>::size(data) * sizeof(typename container_traits<C>::data);
+    }
+
+    [[nodiscard]]
+    std::vector<size_type> equal_counts(std::size_t count) const {
+        return std::vector<size_type>(static_cast<std::size_t>(size()), static_cast<size_type>(count));
+    }
+
+    [[nodiscard]]
+    static std::vector<size_type> compute_displacements(std::span<const size_type> counts) {
+        std::vector<size_type> displacements(counts.size());
+        std::exclusive_scan(counts.begin(), counts.end(), displacements.begin(), size_type{0});
+        return displacements;
+    }
+
+    [[nodiscard]]
+    thread_message header(int context, tag_type tag) const {
+        thread_message m;
+        m.context = context;
+        m.source = communicator_rank;
+        m.tag = tag;
+        return m;
+    }
+
+    void post_owned(id_type destination, int context, tag_type tag, std::vector<std::byte> bytes) const {
+        assert(destination >= 0 && destination < size());
+        auto m = header(context, tag);
+        m.owned = std::move(bytes);
+        m.bytes = m.owned.data();
+        m.size = m.owned.size();
+        group->mailbox(destination).push(std::move(m));
+    }
+
+    // The sender may reuse its buffer as soon as this returns
+    void post_copy(id_type destination, int context, tag_type tag, void const* data, std::size_t bytes) const {
+        auto const* first = static_cast<std::byte const*>(data);
+        post_owned(destination, context, tag, std::vector<std::byte>(first, first + bytes));
+    }
+
+    // The receiver reads the bytes in place, and completes the handoff once it is done with them
+    [[nodiscard]]
+    std::shared_ptr<thread_handoff> post_lent(id_type destination, int context, tag_type tag, void const* data, std::size_t bytes) const {
+        assert(destination >= 0 && destination < size());
+        auto handoff = std::make_shared<thread_handoff>();
+        handoff->sender = own_signal();
+
+        auto m = header(context, tag);
+        m.bytes = static_cast<std::byte const*>(data);
+        m.size = bytes;
+        m.handoff = handoff;
+        group->mailbox(destination).push(std::move(m));
+        return handoff;
+    }
+
+    void post_shared(id_type destination, int context, tag_type tag, std::shared_ptr<void> object, std::type_info const& type,
+                     void const* data, std::size_t bytes) const {
+        assert(destination >= 0 && destination < size());
+        auto m = header(context, tag);
+        m.bytes = static_cast<std::byte const*>(data);
+        m.size = bytes;
+        m.object = std::move(object);
+        m.type = &type;
+        group->mailbox(destination).push(std::move(m));
+    }
+
+    // Elements of a reduction, kept in an array rather than a std::vector, which does not store bools contiguously
+    template<typename T>
+    [[nodiscard]]
+    static std::shared_ptr<T[]> copy_elements(T const* data, std::size_t n) {
+        auto copy = std::make_shared<T[]>(n);
+        std::copy_n(data, n, copy.get());
+        return copy;
+    }
+
+    // The message keeps the elements alive, and they are read in place
+    template<typename T>
+    void post_elements(id_type destination, tag_type tag, std::shared_ptr<T[]> elements, std::size_t n) const {
+        T const* first = elements.get();
+        post_shared(destination, collective_context, tag, std::move(elements), typeid(T[]), first, n * sizeof(T));
+    }
+
+    // The message keeps the container alive, and its bytes are read in place
+    template<ResizableContainer C>
+    void post_object(id_type destination, int context, tag_type tag, C&& data) const {
+        auto object = std::make_shared<std::remove_cvref_t<C>>(std::move(data));
+        auto const* bytes = container_traits<std::remove_cvref_t<C>>::pointer(*object);
+        post_shared(destination, context, tag, object, typeid(std::remove_cvref_t<C>), bytes, bytes_of(*object));
+    }
+
+    [[nodiscard]]
+    request lend(id_type destination, int context, tag_type tag, void const* data, std::size_t bytes) const {
+        return copied_request({post_lent(destination, context, tag, data, bytes)});
+    }
+
+    // Request that completes once every lent buffer has been copied
+    [[nodiscard]]
+    request copied_request(handoffs lent) const {
+        return request::make(own_signal(), [lent = std::move(lent)](status&) {
+            return std::all_of(lent.begin(), lent.end(), [](auto const& h) { return h->copied(); });
+        });
+    }
+
+    // Blocking send of a collective, which waits until the receiver has copied the data
+    void send_lent(id_type destination, tag_type tag, void const* data, std::size_t bytes) const {
+        wait_copied({post_lent(destination, collective_context, tag, data, bytes)});
+    }
+
+    [[nodiscard]]
+    handoffs lend_to_all(tag_type tag, void const* data, std::size_t bytes) const {
+        handoffs lent;
+        for(id_type r=0; r < size(); ++r) {
+            if(r != rank()) {
+                lent.push_back(post_lent(r, collective_context, tag, data, bytes));
+            }
+        }
+        return lent;
+    }
+
+    // Lends counts[i] elements to rank i, and copies the slice of this rank to own
+    template<typename T>
+    void lend_slices(tag_type tag, T const* data, std::vector<size_type> const& counts, T* own) const {
+        const auto displacements = compute_displacements(counts);
+        handoffs lent;
+        for(id_type r=0; r < size(); ++r) {
+            const auto i = static_cast<std::size_t>(r);
+            T const* slice = data + displacements[i];
+            if(r == rank()) {
+                std::copy_n(slice, counts[i], own);
+            } else {
+                lent.push_back(post_lent(r, collective_context, tag, slice, static_cast<std::size_t>(counts[i]) * sizeof(T)));
+            }
+        }
+        wait_copied(lent);
+    }
+
+    void wait_copied(handoffs const& lent) const {
+        signal().wait_until([&] {
+            return std::all_of(lent.begin(), lent.end(), [](auto const& h) { return h->copied(); });
+        });
+    }
+
+    // Blocks until a matching message arrives. Posting the receive first keeps the order of earlier irecv calls.
+    [[nodiscard]]
+    thread_message receive(int context, id_type source, tag_type tag) const {
+        auto posted = own_mailbox().post(context, source, tag);
+        std::optional<thread_message> m;
+        signal().wait_until([&] {
+            if(auto arrived = own_mailbox().collect(*posted)) {
+                m.emplace(std::move(*arrived));
+            }
+            return m.has_value();
+        });
+        return std::move(*m);
+    }
+
+    [[nodiscard]]
+    rank_messages receive_from_all(tag_type tag) const {
+        std::vector<std::shared_ptr<thread_posted_receive>> posted;
+        for(id_type r=0; r < size(); ++r) {
+            posted.push_back(r == rank() ? nullptr : own_mailbox().post(collective_context, r, tag));
+        }
+
+        rank_messages messages(static_cast<std::size_t>(size()));
+        signal().wait_until([&] {
+            bool all = true;
+            for(std::size_t i=0; i < posted.size(); ++i) {
+                if(posted[i] && !messages[i]) {
+                    if(auto arrived = own_mailbox().collect(*posted[i])) {
+                        messages[i].emplace(std::move(*arrived));
+                    }
+                    all = all && messages[i].has_value();
+                }
+            }
+            return all;
+        });
+        return messages;
+    }
+
+    // Request that completes once deliver(message) has been called for a matching message
+    template<typename F>
+    [[nodiscard]]
+    request receive_request(int context, id_type source, tag_type tag, F deliver) const {
+        auto posted = own_mailbox().post(context, source, tag);
+        return request::make(own_signal(), [g = group, r = communicator_rank, posted, deliver](status& s) mutable {
+            auto m = g->mailbox(r).collect(*posted);
+            if(!m) {
+                return false;
+            }
+            fill_status(*m, s);
+            deliver(*m);
+            return true;
+        });
+    }
+
+    // Request that completes once deliver(source, message) has been called for a message of every other rank
+    template<typename F>
+    [[nodiscard]]
+    request receive_all_request(tag_type tag, F deliver) const {
+        std::vector<std::shared_ptr<thread_posted_receive>> posted;
+        for(id_type r=0; r < size(); ++r) {
+            posted.push_back(r == rank() ? nullptr : own_mailbox().post(collective_context, r, tag));
+        }
+        return request::make(own_signal(), [g = group, r = communicator_rank, posted, deliver](status&) mutable {
+            bool all = true;
+            for(std::size_t i=0; i < posted.size(); ++i) {
+                if(!posted[i]) {
+                    continue;
+                }
+                if(auto m = g->mailbox(r).collect(*posted[i])) {
+                    deliver(static_cast<id_type>(i), *m);
+                    posted[i] = nullptr;
+                } else {
+                    all = false;
+                }
+            }
+            return all;
+        });
+    }
+
+    // Copies the message of rank i to output + displacement i
+    template<typename T>
+    [[nodiscard]]
+    static auto placer(T* output, std::vector<size_type> counts) {
+        return [output, counts, displacements = compute_displacements(counts)](id_type source, thread_message& m) {
+            const auto i = static_cast<std::size_t>(source);
+            copy_into(m, output + displacements[i], static_cast<std::size_t>(counts[i]) * sizeof(T));
+        };
+    }
+
+    template<typename T>
+    static void place(rank_messages messages, T* output, std::vector<size_type> const& counts) {
+        auto copy = placer(output, counts);
+        for(std::size_t i=0; i < messages.size(); ++i) {
+            if(messages[i]) {
+                copy(static_cast<id_type>(i), *messages[i]);
+            }
+        }
+    }
+
+    // Message sizes in elements, with own for the slot of this rank
+    template<ContiguousContainer C>
+    [[nodiscard]]
+    static std::vector<size_type> received_counts(rank_messages const& messages, size_type own) {
+        using T = typename container_traits<C>::data;
+        std::vector<size_type> counts;
+        for(auto const& m: messages) {
+            counts.push_back(m ? static_cast<size_type>(m->size / sizeof(T)) : own);
+        }
+        return counts;
+    }
+
+    template<ContiguousContainer C>
+    void gather_into(C const& data, C& output, std::span<const size_type> counts, rank_messages messages) const {
+        const auto displacements = compute_displacements(counts);
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(displacements.back() + counts.back()));
+        auto* out = container_traits<C>::pointer(output);
+        std::copy_n(container_traits<C>::pointer(data), container_traits<C>::size(data),
+                    out + displacements[static_cast<std::size_t>(rank())]);
+        place(std::move(messages), out, std::vector<size_type>(counts.begin(), counts.end()));
+    }
+
+    // Lends send_counts[i] elements to each rank i, and returns the messages of the others once they have arrived.
+    // The lent slices are only copied once the other ranks are done with theirs, so this rank must release its
+    // messages before waiting for them.
+    template<ContiguousContainer C>
+    [[nodiscard]]
+    rank_messages alltoall_messages(C const& data, std::span<const size_type> send_counts, handoffs& lent) const {
+        using T = typename container_traits<C>::data;
+        assert(send_counts.size() == static_cast<std::size_t>(size()));
+        const auto displacements = compute_displacements(send_counts);
+        assert(container_traits<C>::size(data) >= static_cast<std::size_t>(displacements.back() + send_counts.back()));
+
+        for(id_type r=0; r < size(); ++r) {
+            const auto i = static_cast<std::size_t>(r);
+            if(r != rank()) {
+                lent.push_back(post_lent(r, collective_context, alltoall_tag, container_traits<C>::pointer(data) + displacements[i],
+                                         static_cast<std::size_t>(send_counts[i]) * sizeof(T)));
+            }
+        }
+        return receive_from_all(alltoall_tag);
+    }
+
+    template<ContiguousContainer C>
+    void finish_alltoall(C const& data, C& output, std::span<const size_type> send_counts, std::span<const size_type> recv_counts,
+                         rank_messages messages, handoffs const& lent) const {
+        const auto i = static_cast<std::size_t>(rank());
+        const auto send_displacements = compute_displacements(send_counts);
+        const auto recv_displacements = compute_displacements(recv_counts);
+        container_traits<C>::try_resize(output, static_cast<std::size_t>(recv_displacements.back() + recv_counts.back()));
+
+        auto* out = container_traits<C>::pointer(output);
+        assert(send_counts[i] == recv_counts[i]);
+        std::copy_n(container_traits<C>::pointer(data) + send_displacements[i], send_counts[i], out + recv_displacements[i]);
+        place(std::move(messages), out, std::vector<size_type>(recv_counts.begin(), recv_counts.end()));
+        wait_copied(lent);
+    }
+
+    // Binomial tree rooted at the source: each rank receives the data from its parent, and then lends it to its
+    // children at once
+    void tree_broadcast(id_type source, tag_type tag, void* data, std::size_t bytes) const {
+        const id_type n = size();
+        const id_type relative = (rank() - source + n) % n;
+
+        id_type mask = 1;
+        for(; mask < n; mask <<= 1) {
+            if(relative & mask) {
+                auto m = receive(collective_context, (relative - mask + source) % n, tag);
+                copy_into(m, data, bytes);
+                break;
+            }
+        }
+
+        handoffs lent;
+        for(mask >>= 1; mask > 0; mask >>= 1) {
+            if(relative + mask < n) {
+                lent.push_back(post_lent((relative + mask + source) % n, collective_context, tag, data, bytes));
+            }
+        }
+        wait_copied(lent);
+    }
+
+    // Binomial tree towards rank 0. Each partial result covers consecutive ranks, and is combined with the one of
+    // the ranks right after it, so that non-commutative operations are applied in rank order. The result is only
+    // returned in rank 0.
+    template<typename T, typename Op>
+    [[nodiscard]]
+    std::shared_ptr<T[]> tree_reduce(tag_type tag, T const* data, std::size_t n, Op op) const {
+        auto partial = copy_elements(data, n);
+        for(id_type mask = 1; mask < size(); mask <<= 1) {
+            if(rank() & mask) {
+                post_elements(rank() - mask, tag, std::move(partial), n);
+                return nullptr;
+            }
+            if(rank() + mask < size()) {
+                auto m = receive(collective_context, rank() + mask, tag);
+                combine(partial.get(), elements<T>(m, n), n, op);
+            }
+        }
+        return partial;
+    }
+
+    template<typename T, typename Op>
+    void reduce_to(id_type destination, T const* data, std::size_t n, T* output, Op op) const {
+        auto result = tree_reduce(reduce_tag, data, n, op);
+        if(rank() == 0 && destination == 0) {
+            std::copy_n(result.get(), n, output);
+        } else if(rank() == 0) {
+            post_elements(destination, reduce_tag, std::move(result), n);
+        } else if(rank() == destination) {
+            auto m = receive(collective_context, 0, reduce_tag);
+            copy_into(m, output, n * sizeof(T));
+        }
+    }
+
+    template<typename T, typename Op>
+    void reduce_to_all(T const* data, std::size_t n, T* output, Op op) const {
+        auto result = tree_reduce(reduce_tag, data, n, op);
+        if(rank() == 0) {
+            std::copy_n(result.get(), n, output);
+        }
+        tree_broadcast(0, broadcast_tag, output, n * sizeof(T));
+    }
+
+    template<typename T, typename Op>
+    [[nodiscard]]
+    request flat_allreduce(T const* data, std::size_t n, T* output, Op op) const {
+        auto lent = lend_to_all(iallreduce_tag, data, n * sizeof(T));
+        auto arrived = std::make_shared<rank_messages>(static_cast<std::size_t>(size()));
+        const auto store = [arrived](id_type source, thread_message& m) {
+            (*arrived)[static_cast<std::size_t>(source)].emplace(std::move(m));
+        };
+
+        // The messages are combined once all have arrived, as they must be in rank order
+        auto received = receive_all_request(iallreduce_tag, store);
+        return request::make(own_signal(), [received = std::move(received), arrived, lent, data, n, output, op,
+                                            own = static_cast<std::size_t>(rank())](status&) mutable {
+            if(received.active() && !received.test()) {
+                return false;
+            }
+            if(!arrived->empty()) {
+                std::shared_ptr<T[]> result;
+                for(std::size_t i=0; i < arrived->size(); ++i) {
+                    T const* in = i == own ? data : elements<T>(*(*arrived)[i], n);
+                    if(i == 0) {
+                        result = copy_elements(in, n);
+                    } else {
+                        combine(result.get(), in, n, op);
+                    }
+                }
+                std::copy_n(result.get(), n, output);
+                arrived->clear();
+            }
+            return std::all_of(lent.begin(), lent.end(), [](auto const& h) { return h->copied(); });
+        });
+    }
+
+    [[nodiscard]]
+    request flat_broadcast(id_type source, void* data, std::size_t bytes) const {
+        if(rank() == source) {
+            return copied_request(lend_to_all(ibroadcast_tag, data, bytes));
+        }
+        // Nothing is sent to the source, so only its message is waited for
+        return receive_request(collective_context, source, ibroadcast_tag, [data, bytes](thread_message& m) {
+            copy_into(m, data, bytes);
+        });
+    }
+
+    // Recursive doubling: after exchanging with the rank at distance mask, total holds the reduction of an aligned
+    // block of 2 * mask ranks, and the prefixes take in the blocks of lower ranks only
+    template<typename T, typename Op>
+    void prefix_reduce(T const* data, std::size_t n, T* inclusive, T* exclusive, Op op) const {
+        auto total = copy_elements(data, n);
+        auto prefix = copy_elements(data, n);
+        std::shared_ptr<T[]> before;
+
+        for(id_type mask = 1; mask < size(); mask <<= 1) {
+            const id_type partner = rank() ^ mask;
+            if(partner >= size()) {
+                continue;
+            }
+            post_elements(partner, scan_tag, copy_elements(total.get(), n), n);
+            auto m = receive(collective_context, partner, scan_tag);
+            T const* in = elements<T>(m, n);
+
+            if(partner < rank()) {
+                combine_before(prefix.get(), in, n, op);
+                combine_before(total.get(), in, n, op);
+                if(before) {
+                    combine_before(before.get(), in, n, op);
+                } else {
+                    before = copy_elements(in, n);
+                }
+            } else {
+                combine(total.get(), in, n, op);
+            }
+        }
+
+        if(inclusive) {
+            std::copy_n(prefix.get(), n, inclusive);
+        }
+        if(exclusive && before) {
+            std::copy_n(before.get(), n, exclusive);
+        }
+    }
+
+    // acc[i] = op(acc[i], in[i]). Transparent functors such as std::plus<> promote small types, so the result is
+    // converted back.
+    template<typename T, typename Op>
+    static void combine(T* acc, T const* in, std::size_t n, Op op) {
+        for(std::size_t i=0; i < n; ++i) {
+            acc[i] = static_cast<T>(op(acc[i], in[i]));
+        }
+    }
+
+    // acc[i] = op(in[i], acc[i]), for data of lower ranks
+    template<typename T, typename Op>
+    static void combine_before(T* acc, T const* in, std::size_t n, Op op) {
+        for(std::size_t i=0; i < n; ++i) {
+            acc[i] = static_cast<T>(op(in[i], acc[i]));
+        }
+    }
+
+    // Elements of a message sent by a rank of the same collective, which are aligned as they come from a T buffer
+    template<typename T>
+    [[nodiscard]]
+    static T const* elements(thread_message const& m, [[maybe_unused]] std::size_t n) {
+        if(m.size != n * sizeof(T)) {
+            throw std::runtime_error("Message size differs between ranks");
+        }
+        return reinterpret_cast<T const*>(m.bytes);
+    }
+
+    static void fill_status(thread_message const& m, status& s) noexcept {
+        s.count = static_cast<int>(m.size);
+        s.cancelled = 0;
+        s.MPI_SOURCE = m.source;
+        s.MPI_TAG = m.tag;
+        s.MPI_ERROR = 0;
+    }
+
+    template<mpi::MappedType T>
+    [[nodiscard]]
+    static envelope make_envelope(thread_header const& h) noexcept {
+        return {h.source, h.tag, static_cast<size_type>(h.size / sizeof(T))};
+    }
+
+    static void copy_into(thread_message const& m, void* data, std::size_t capacity) {
+        if(m.size > capacity) {
+            throw std::runtime_error("Message larger than the receive buffer");
+        }
+        if(m.size > 0) {
+            std::memcpy(data, m.bytes, m.size);
+        }
+    }
+
+    template<mpi::ValidType T>
+    static void unpack(thread_message const& m, T& data) {
+        copy_into(m, &data, sizeof(T));
+    }
+
+    // Resizable containers take over the storage of a container of their type, or are resized to fit the message
+    template<mpi::ValidContainer C>
+    static void unpack(thread_message const& m, C& data) {
+        if constexpr(ResizableContainer<C>) {
+            if(m.holds<C>()) {
+                data = std::move(*static_cast<C*>(m.object.get()));
+                return;
+            }
+            container_traits<C>::try_resize(data, m.size / sizeof(typename container_traits<C>::data));
+        }
+        copy_into(m, container_traits<C>::pointer(data), bytes_of(data));
+    }
+
+    template<mpi::MappedType T>
+    static void unpack(thread_message const& m, strided_view<T> data) {
+        if(m.size != data.size() * sizeof(T)) {
+            throw std::runtime_error("Message size differs from the strided view");
+        }
+        unpack_bytes(m.bytes, data);
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    static std::vector<std::byte> pack(strided_view<T> data) {
+        std::vector<std::byte> packed(data.size() * sizeof(T));
+        const std::size_t block = data.block_length() * sizeof(T);
+        for(std::size_t b=0; b < data.count(); ++b) {
+            std::memcpy(packed.data() + b * block, data.data() + b * data.stride(), block);
+        }
+        return packed;
+    }
+
+    template<typename T>
+    static void unpack_bytes(std::byte const* packed, strided_view<T> data) {
+        const std::size_t block = data.block_length() * sizeof(T);
+        for(std::size_t b=0; b < data.count(); ++b) {
+            std::memcpy(data.data() + b * data.stride(), packed + b * block, block);
+        }
+    }
+};
+
+// Runs f(communicator) on a thread per rank, each of them a rank of a new world of the given size, and returns once
+// all of them are done. If any rank throws, the ranks waiting for a message are woken up with thread_aborted, and the
+// first exception of a failing rank is rethrown here.
+template<typename F>
+void run_threads(int ranks, F f) {
+    using communicator = basic_communicator<Os::Threads, false>;
+    assert(ranks > 0);
+    basic_environment<Os::Threads, false>::initialize();
+
+    std::vector<std::shared_ptr<thread_signal>> signals;
+    for(int r=0; r < ranks; ++r) {
+        signals.push_back(std::make_shared<thread_signal>());
+    }
+    const auto world = std::make_shared<thread_group>(std::move(signals));
+
+    std::mutex failure_mutex;
+    std::exception_ptr failure;
+    bool failure_is_abort = true;
+    {
+        std::vector<std::jthread> threads;
+        for(int r=0; r < ranks; ++r) {
+            threads.emplace_back([&, r] {
+                current_thread_rank = {world, r};
+                try {
+                    f(communicator::get_default());
+                } catch(thread_aborted const&) {
+                    // The rank that failed reports its own exception, which may arrive after this one
+                    const std::lock_guard lock(failure_mutex);
+                    if(!failure) {
+                        failure = std::current_exception();
+                    }
+                } catch(...) {
+                    {
+                        const std::lock_guard lock(failure_mutex);
+                        if(!failure || failure_is_abort) {
+                            failure = std::current_exception();
+                            failure_is_abort = false;
+                        }
+                    }
+                    world->abort();
+                }
+                current_thread_rank = {};
+            });
+        }
+    }
+
+    if(failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+// One-sided communication and topologies are not implemented by the thread backend, so using them does not compile
+template<mpi::ValidType T>
+class basic_window<Os::Threads, false, T>;
+
+template<typename T>
+class basic_shared_window<Os::Threads, false, T>;
+
+template<>
+class basic_cartesian_communicator<Os::Threads, false>;
+
+template<mpi::ValidType T>
+class basic_halo_exchange<Os::Threads, false, T>;
+
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <mpicxx/common/defines.h>
+#include <mpicxx/common/environment.h>
+
+namespace mpi {
+
+// Ranks are threads of the same process, and any of their threads may communicate at any time
+template<>
+inline threading basic_environment<Os::Threads, false>::initialize_impl(threading){ return threading::multiple; }
+
+template<>
+inline void basic_environment<Os::Threads, false>::finalize_impl(){ }
+
+}
\ No newline at end of file
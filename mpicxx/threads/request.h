@@ -0,0 +1,321 @@
+#pragma once
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <mpicxx/common/extra_type_traits.h>
+#include <mpicxx/common/request.h>
+#include <mpicxx/mock/types.h>
+#include "environment.h"
+#include "world.h"
+
+namespace mpi {
+
+// Nonblocking operation of the thread backend. Test advances it as far as it can without blocking, and the signal
+// of the rank that started it tells when trying again may help.
+class thread_operation {
+  public:
+    explicit thread_operation(std::shared_ptr<thread_signal> signal) noexcept
+        : rank_signal(std::move(signal))
+    {
+    }
+
+    virtual ~thread_operation() = default;
+
+    [[nodiscard]]
+    virtual bool test(basic_status<Os::Threads, false>& status) = 0;
+
+    [[nodiscard]]
+    thread_signal& signal() const noexcept {
+        return *rank_signal;
+    }
+
+  private:
+    std::shared_ptr<thread_signal> rank_signal;
+};
+
+// Operation whose progress is a callable, which returns true once it is complete
+template<typename F>
+class thread_steps final : public thread_operation {
+  public:
+    thread_steps(std::shared_ptr<thread_signal> signal, F step)
+        : thread_operation(std::move(signal))
+        , step(std::move(step))
+    {
+    }
+
+    [[nodiscard]]
+    bool test(basic_status<Os::Threads, false>& status) override {
+        return step(status);
+    }
+
+  private:
+    F step;
+};
+
+template<>
+class basic_request<Os::Threads, false> {
+  public:
+    using status = basic_status<Os::Threads, false>;
+    using environment = basic_environment<Os::Threads, false>;
+    using handle_type = thread_operation*;
+
+    basic_request() noexcept = default;
+
+    explicit basic_request(std::unique_ptr<thread_operation> operation) noexcept
+        : operation(std::move(operation))
+    {
+    }
+
+    template<typename F>
+    [[nodiscard]]
+    static basic_request make(std::shared_ptr<thread_signal> signal, F step) {
+        return basic_request{std::make_unique<thread_steps<F>>(std::move(signal), std::move(step))};
+    }
+
+    basic_request(basic_request const&) = delete;
+    basic_request& operator=(basic_request const&) = delete;
+
+    basic_request(basic_request&&) noexcept = default;
+
+    basic_request& operator=(basic_request&& other) noexcept {
+        if(this != &other) {
+            finish();
+            operation = std::move(other.operation);
+        }
+        return *this;
+    }
+
+    // Pending operations are completed before releasing them, as other ranks may still read the lent buffers
+    ~basic_request() noexcept {
+        finish();
+    }
+
+    [[nodiscard]]
+    bool active() const noexcept {
+        return operation != nullptr;
+    }
+
+    // Throws if another rank failed before the operation completed
+    void wait() {
+        status s;
+        wait(s);
+    }
+
+    void wait(status& status) {
+        if(!active()) {
+            return;
+        }
+        operation->signal().wait_until([&] { return operation->test(status); });
+        operation.reset();
+    }
+
+    [[nodiscard]]
+    bool test() {
+        status s;
+        return test(s);
+    }
+
+    [[nodiscard]]
+    bool test(status& status) {
+        if(active() && operation->test(status)) {
+            operation.reset();
+        }
+        return !active();
+    }
+
+    static void wait_all(std::span<basic_request> requests) {
+        environment::assert_running();
+        for(auto& r: requests) {
+            r.wait();
+        }
+    }
+
+    static std::optional<std::size_t> wait_any(std::span<basic_request> requests) {
+        environment::assert_running();
+        const auto first = first_active(requests);
+        if(!first) {
+            return std::nullopt;
+        }
+
+        std::optional<std::size_t> completed;
+        requests[*first].operation->signal().wait_until([&] {
+            for(std::size_t i=0; i < requests.size() && !completed; ++i) {
+                if(requests[i].active() && requests[i].test()) {
+                    completed = i;
+                }
+            }
+            return completed.has_value();
+        });
+        return completed;
+    }
+
+    static std::vector<std::size_t> wait_some(std::span<basic_request> requests) {
+        environment::assert_running();
+        const auto first = first_active(requests);
+        if(!first) {
+            return {};
+        }
+
+        std::vector<std::size_t> completed;
+        requests[*first].operation->signal().wait_until([&] {
+            completed = test_some(requests);
+            return !completed.empty();
+        });
+        return completed;
+    }
+
+    static std::vector<std::size_t> test_some(std::span<basic_request> requests) {
+        environment::assert_running();
+        std::vector<std::size_t> completed;
+        for(std::size_t i=0; i < requests.size(); ++i) {
+            if(requests[i].active() && requests[i].test()) {
+                completed.push_back(i);
+            }
+        }
+        return completed;
+    }
+
+    [[nodiscard]]
+    handle_type handle() const noexcept {
+        return operation.get();
+    }
+
+  private:
+    std::unique_ptr<thread_operation> operation;
+
+    // After a failure in another rank, the operation is dropped instead, as it will never complete.
+    // A rank that unwinds with the operation pending aborts its world first: the rank that would complete it may be
+    // waiting for something else, which this rank will never send. Catching the exception within the rank does not
+    // undo the abort.
+    void finish() noexcept {
+        if(active() && std::uncaught_exceptions() > 0 && current_thread_rank.world) {
+            current_thread_rank.world->abort();
+        }
+        try {
+            wait();
+        } catch(...) {
+            operation.reset();
+        }
+    }
+
+    [[nodiscard]]
+    static std::optional<std::size_t> first_active(std::span<basic_request> requests) noexcept {
+        for(std::size_t i=0; i < requests.size(); ++i) {
+            if(requests[i].active()) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+};
+
+// Each start sets up the communication again, since the thread backend has nothing to keep between starts
+template<>
+class basic_persistent_request<Os::Threads, false> {
+  public:
+    using status = basic_status<Os::Threads, false>;
+    using environment = basic_environment<Os::Threads, false>;
+    using request = basic_request<Os::Threads, false>;
+    using handle_type = thread_operation*;
+
+    basic_persistent_request() noexcept = default;
+
+    explicit basic_persistent_request(std::function<request()> starter)
+        : starter(std::move(starter))
+    {
+    }
+
+    basic_persistent_request(basic_persistent_request const&) = delete;
+    basic_persistent_request& operator=(basic_persistent_request const&) = delete;
+
+    basic_persistent_request(basic_persistent_request&&) noexcept = default;
+
+    // The started operation completes before the data it reads is replaced
+    basic_persistent_request& operator=(basic_persistent_request&& other) noexcept {
+        if(this != &other) {
+            current = std::move(other.current);
+            starter = std::move(other.starter);
+            owned = std::move(other.owned);
+        }
+        return *this;
+    }
+
+    [[nodiscard]]
+    bool active() const noexcept {
+        return current.active();
+    }
+
+    void start() {
+        environment::assert_running();
+        current.wait();
+        current = starter();
+    }
+
+    void wait() {
+        current.wait();
+    }
+
+    void wait(status& status) {
+        current.wait(status);
+    }
+
+    [[nodiscard]]
+    bool test() {
+        return current.test();
+    }
+
+    static void start_all(std::span<basic_persistent_request> requests) {
+        environment::assert_running();
+        for(auto& r: requests) {
+            r.start();
+        }
+    }
+
+    static void wait_all(std::span<basic_persistent_request> requests) {
+        environment::assert_running();
+        for(auto& r: requests) {
+            r.wait();
+        }
+    }
+
+    // The data is read at every start through the starter
+    template<ContiguousContainer C>
+    constexpr void bind(C const&) noexcept { }
+
+    // Keeps the data the request transfers alive for as long as the request, which completes first
+    void adopt(owned_data data) noexcept {
+        owned = std::move(data);
+    }
+
+    // Data owned by the request, which was given to send_init or recv_init by value. T must be its type.
+    template<typename T>
+    [[nodiscard]]
+    T& data() noexcept {
+        return owned.template get<T>();
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    T const& data() const noexcept {
+        return owned.template get<T>();
+    }
+
+    [[nodiscard]]
+    handle_type handle() const noexcept {
+        return current.handle();
+    }
+
+  private:
+    // Declared first, so that it is destroyed after the operation that reads it
+    owned_data owned;
+    std::function<request()> starter;
+    request current;
+};
+
+}
@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace mpi {
+
+// Thrown in the ranks that were waiting when another rank failed
+class thread_aborted : public std::runtime_error {
+  public:
+    thread_aborted()
+        : std::runtime_error("Another rank failed")
+    {
+    }
+};
+
+// Wakes up the thread of a rank whenever something it may be waiting for happens: a message arrives in one of its
+// mailboxes, or another rank is done with a buffer it lent. Waiters compare generations, so no wake up is lost.
+class thread_signal {
+  public:
+    [[nodiscard]]
+    std::uint64_t generation() const {
+        const std::lock_guard lock(mutex);
+        return count;
+    }
+
+    void notify() {
+        {
+            const std::lock_guard lock(mutex);
+            ++count;
+        }
+        changed.notify_all();
+    }
+
+    // Wakes up every waiter for good, as another rank failed and will never send what they wait for
+    void abort() {
+        {
+            const std::lock_guard lock(mutex);
+            aborted = true;
+        }
+        changed.notify_all();
+    }
+
+    // Blocks until ready() returns true. Throws if another rank failed meanwhile.
+    template<typename F>
+    void wait_until(F&& ready) {
+        while(true) {
+            const std::uint64_t seen = generation();
+            if(ready()) {
+                return;
+            }
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [&] { return count != seen || aborted; });
+            if(aborted) {
+                throw thread_aborted();
+            }
+        }
+    }
+
+  private:
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    std::uint64_t count = 0;
+    bool aborted = false;
+};
+
+// Tells the sender of a lent buffer that the receiver no longer reads it
+struct thread_handoff {
+    std::atomic<bool> done = false;
+    std::shared_ptr<thread_signal> sender;
+
+    [[nodiscard]]
+    bool copied() const noexcept {
+        return done.load(std::memory_order_acquire);
+    }
+
+    void complete() {
+        done.store(true, std::memory_order_release);
+        sender->notify();
+    }
+};
+
+// Message waiting in a mailbox. The bytes are either owned by the message, lent by the sender until the handoff
+// completes, or part of an object the sender gave away, which a receiver of the same type takes over whole.
+struct thread_message {
+    int context = 0;
+    int source = 0;
+    int tag = 0;
+    std::byte const* bytes = nullptr;
+    std::size_t size = 0;
+    std::vector<std::byte> owned;
+    std::shared_ptr<void> object;
+    std::type_info const* type = nullptr;
+    std::shared_ptr<thread_handoff> handoff;
+
+    thread_message() = default;
+
+    thread_message(thread_message&&) noexcept = default;
+    thread_message& operator=(thread_message&&) = delete;
+
+    // The receiver is done with the bytes once the message is gone
+    ~thread_message() {
+        if(handoff) {
+            handoff->complete();
+        }
+    }
+
+    template<typename T>
+    [[nodiscard]]
+    bool holds() const noexcept {
+        return object && type && *type == typeid(T);
+    }
+};
+
+// Receive posted ahead of the message, as irecv does. Messages go to posted receives in the order they were posted.
+struct thread_posted_receive {
+    int context;
+    int source;
+    int tag;
+    std::optional<thread_message> message;
+};
+
+// Source, tag and size in bytes of a message that has arrived but has not been received yet
+struct thread_header {
+    int source;
+    int tag;
+    std::size_t size;
+};
+
+// Messages sent to one rank of a group. A negative source or tag matches any.
+class thread_mailbox {
+  public:
+    explicit thread_mailbox(std::shared_ptr<thread_signal> owner)
+        : owner(std::move(owner))
+    {
+    }
+
+    void push(thread_message message) {
+        {
+            const std::lock_guard lock(mutex);
+            const auto p = std::find_if(posted.begin(), posted.end(), [&](auto const& r) {
+                return matches(*r, message);
+            });
+            if(p != posted.end()) {
+                (*p)->message.emplace(std::move(message));
+                posted.erase(p);
+            } else {
+                messages.push_back(std::move(message));
+            }
+        }
+        owner->notify();
+    }
+
+    // Removes the oldest matching message
+    [[nodiscard]]
+    std::optional<thread_message> take(int context, int source, int tag) {
+        const std::lock_guard lock(mutex);
+        const auto m = find(context, source, tag);
+        if(m == messages.end()) {
+            return std::nullopt;
+        }
+        std::optional<thread_message> found(std::move(*m));
+        messages.erase(m);
+        return found;
+    }
+
+    [[nodiscard]]
+    std::optional<thread_header> peek(int context, int source, int tag) const {
+        const std::lock_guard lock(mutex);
+        for(auto const& m: messages) {
+            if(matches(context, source, tag, m)) {
+                return thread_header{m.source, m.tag, m.size};
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Matches the oldest message that has already arrived, or the next one to arrive
+    [[nodiscard]]
+    std::shared_ptr<thread_posted_receive> post(int context, int source, int tag) {
+        auto receive = std::make_shared<thread_posted_receive>(thread_posted_receive{context, source, tag, std::nullopt});
+        const std::lock_guard lock(mutex);
+        const auto m = find(context, source, tag);
+        if(m != messages.end()) {
+            receive->message.emplace(std::move(*m));
+            messages.erase(m);
+        } else {
+            posted.push_back(receive);
+        }
+        return receive;
+    }
+
+    // The message of a posted receive, once it has been matched
+    [[nodiscard]]
+    std::optional<thread_message> collect(thread_posted_receive& receive) {
+        const std::lock_guard lock(mutex);
+        std::optional<thread_message> found;
+        if(receive.message) {
+            found.emplace(std::move(*receive.message));
+            receive.message.reset();
+        }
+        return found;
+    }
+
+    [[nodiscard]]
+    thread_signal& signal() const noexcept {
+        return *owner;
+    }
+
+  private:
+    std::shared_ptr<thread_signal> owner;
+    mutable std::mutex mutex;
+    std::list<thread_message> messages;
+    std::list<std::shared_ptr<thread_posted_receive>> posted;
+
+    [[nodiscard]]
+    static bool matches(int context, int source, int tag, thread_message const& m) noexcept {
+        return m.context == context && (source < 0 || m.source == source) && (tag < 0 || m.tag == tag);
+    }
+
+    [[nodiscard]]
+    static bool matches(thread_posted_receive const& r, thread_message const& m) noexcept {
+        return matches(r.context, r.source, r.tag, m);
+    }
+
+    [[nodiscard]]
+    std::list<thread_message>::iterator find(int context, int source, int tag) {
+        return std::find_if(messages.begin(), messages.end(), [&](thread_message const& m) {
+            return matches(context, source, tag, m);
+        });
+    }
+};
+
+// Ranks of a communicator of the thread backend. Each group has its own mailboxes, so that messages of different
+// communicators never match, while the signal of each rank is shared by all the groups it belongs to.
+class thread_group {
+  public:
+    explicit thread_group(std::vector<std::shared_ptr<thread_signal>> signals)
+        : rank_signals(std::move(signals))
+    {
+        for(auto const& s: rank_signals) {
+            mailboxes.emplace_back(s);
+        }
+    }
+
+    thread_group(thread_group const&) = delete;
+    thread_group& operator=(thread_group const&) = delete;
+
+    [[nodiscard]]
+    int size() const noexcept {
+        return static_cast<int>(rank_signals.size());
+    }
+
+    [[nodiscard]]
+    thread_mailbox& mailbox(int rank) noexcept {
+        return mailboxes[static_cast<std::size_t>(rank)];
+    }
+
+    [[nodiscard]]
+    std::vector<std::shared_ptr<thread_signal>> const& signals() const noexcept {
+        return rank_signals;
+    }
+
+    void abort() {
+        for(auto const& s: rank_signals) {
+            s->abort();
+        }
+    }
+
+  private:
+    std::vector<std::shared_ptr<thread_signal>> rank_signals;
+    std::deque<thread_mailbox> mailboxes;
+};
+
+// World and rank of the calling thread, set by run_threads
+struct thread_rank {
+    std::shared_ptr<thread_group> world;
+    int rank = 0;
+};
+
+inline thread_local thread_rank current_thread_rank;
+
+}
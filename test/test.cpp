@@ -1,9 +1,35 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
 // Project includes
+#include "test_aggregator.h"
+#include "test_allgather.h"
+#include "test_allocator.h"
+#include "test_alltoall.h"
 #include "test_barrier.h"
 #include "test_broadcast.h"
+#include "test_cartesian.h"
+#include "test_communicator.h"
+#include "test_datatypes.h"
+#include "test_environment.h"
 #include "test_gather.h"
+#include "test_gatherv.h"
+#include "test_in_place.h"
+#include "test_large_count.h"
+#include "test_nonblocking.h"
+#include "test_nonblocking_collectives.h"
+#include "test_persistent.h"
+#include "test_probe.h"
+#include "test_profiler.h"
+#include "test_progress_engine.h"
+#include "test_reduce.h"
+#include "test_scatter.h"
+#include "test_shared_window.h"
+#include "test_task.h"
+#include "test_threads.h"
+#include "test_tracer.h"
+#include "test_views.h"
+#include "test_window.h"
+#include "test_work_queue.h"
 
 // External library includes
 #include <doctest/doctest.h>
\ No newline at end of file
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+TEST_CASE_TEMPLATE("AggregatorDeliversToHandlers", T, int, unsigned, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+    const auto ranks = static_cast<std::size_t>(comm.size());
+
+    // Small slabs, so that they fill up many times, and no timeout, so that only full slabs are sent
+    mpi::aggregator aggregator(comm, 256, std::chrono::hours(1));
+
+    constexpr int n_records = 500;
+    std::vector<int> counts(ranks, 0);
+    std::vector<T> sums(ranks, T{0});
+    std::vector<int> markers(ranks, 0);
+    aggregator.on<T>(1, [&](mpi::id_type source, T const& value) {
+        counts[static_cast<std::size_t>(source)] += 1;
+        sums[static_cast<std::size_t>(source)] += value;
+    });
+    aggregator.on<char>(2, [&](mpi::id_type source, char const& c) {
+        CHECK_EQ(c, 'x');
+        markers[static_cast<std::size_t>(source)] += 1;
+    });
+
+    for(int i=0; i<n_records; ++i) {
+        for(mpi::id_type dest=0; dest<comm.size(); ++dest) {
+            aggregator.send(dest, 1, static_cast<T>(comm.rank() + 1));
+        }
+        aggregator.poll();
+    }
+    for(mpi::id_type dest=0; dest<comm.size(); ++dest) {
+        aggregator.send(dest, 2, 'x');
+    }
+    aggregator.finish();
+
+    for(mpi::id_type source=0; source<comm.size(); ++source) {
+        const auto s = static_cast<std::size_t>(source);
+        CHECK_EQ(counts[s], n_records);
+        CHECK_EQ(sums[s], static_cast<T>(n_records * (source + 1)));
+        CHECK_EQ(markers[s], 1);
+    }
+
+    // Records for other ranks were coalesced into far fewer messages
+    const auto records_to_others = static_cast<std::size_t>(n_records) * (ranks - 1);
+    CHECK_LE(aggregator.messages_sent() * 10, records_to_others);
+}
+
+TEST_CASE("AggregatorHandlersSendMore")
+{
+    auto comm = mpi::communicator::get_default();
+    const mpi::id_type next = (comm.rank() + 1) % comm.size();
+
+    // Each record hops around the ring until its counter reaches zero
+    mpi::aggregator aggregator(comm);
+    std::vector<int> arrived;
+    aggregator.on<int>(3, [&](mpi::id_type, int const& hops) {
+        arrived.push_back(hops);
+        if(hops > 0) {
+            aggregator.send(next, 3, hops - 1);
+        }
+    });
+
+    aggregator.send(next, 3, 3);
+    aggregator.finish();
+
+    CHECK_EQ(arrived, std::vector<int>{3, 2, 1, 0});
+}
+
+TEST_CASE("AggregatorHandlersFillSlabsDuringFinish")
+{
+    auto comm = mpi::communicator::get_default();
+    const mpi::id_type next = (comm.rank() + 1) % comm.size();
+
+    // Two records per slab, so the handlers send full slabs while finish is recieving
+    mpi::aggregator aggregator(comm, 2 * (sizeof(mpi::tag_type) + sizeof(int)), std::chrono::hours(1));
+    int handled = 0;
+    aggregator.on<int>(5, [&](mpi::id_type, int const& hops) {
+        ++handled;
+        if(hops > 0) {
+            for(int i=0; i < 3; ++i) {
+                aggregator.send(next, 5, hops - 1);
+            }
+        }
+    });
+
+    aggregator.send(next, 5, 3);
+    aggregator.finish();
+
+    // 1 + 3 + 9 + 27 records of the trees started by this rank and those before it
+    CHECK_EQ(handled, 40);
+}
+
+TEST_CASE("AggregatorFlushesOnTimeout")
+{
+    auto comm = mpi::communicator::get_default();
+    const mpi::id_type next = (comm.rank() + 1) % comm.size();
+
+    mpi::aggregator aggregator(comm, mpi::aggregator::default_slab_size, std::chrono::milliseconds(0));
+    int recieved = -1;
+    aggregator.on<int>(4, [&](mpi::id_type, int const& value) { recieved = value; });
+
+    // The slab is far from full, so only the timeout sends it
+    aggregator.send(next, 4, comm.rank());
+    while(recieved < 0) {
+        aggregator.poll();
+    }
+    aggregator.finish();
+
+    CHECK_EQ(recieved, (comm.rank() + comm.size() - 1) % comm.size());
+    CHECK_EQ(aggregator.messages_sent(), comm.size() > 1 ? 1u : 0u);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE_TEMPLATE("VectorSingleAllgather", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto send_v = static_cast<T>(comm.rank());
+        std::vector<T> recieved{};
+
+        comm.allgather(send_v, recieved);
+
+        REQUIRE_EQ(recieved.size(), comm.size());
+        for(mpi::size_type i=0; i<comm.size(); ++i) {
+            CHECK_EQ(recieved[static_cast<std::size_t>(i)], static_cast<T>(i));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorVectorAllgather", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto sent_value = static_cast<T>(comm.rank());
+        const std::vector<T> send_v{sent_value, sent_value, sent_value};
+        std::vector<T> recieved{};
+
+        comm.allgather(send_v, recieved);
+
+        REQUIRE_EQ(recieved.size(), comm.size() * 3);
+        // Checking vector looks like [0,0,0,1,1,1,2,2,2,3,3, ...]
+        for(mpi::size_type i=0; i<comm.size(); ++i) {
+            for(auto j: {0, 1, 2}) {
+                const auto idx = static_cast<std::size_t>(3*i + j);
+                CHECK_EQ(recieved[idx], static_cast<T>(i));
+            }
+        }
+    });
+}
+
+TEST_CASE("StringStringAllgather")
+{
+    on_every_backend([](auto comm) {
+        const char letter = static_cast<char>('a' + comm.rank());
+        const std::string send_str{letter, letter};
+        std::string recieved{};
+
+        comm.allgather(send_str, recieved);
+
+        // Checking string looks like "aabbccdd..."
+        std::string expected;
+        for(mpi::size_type i=0; i<comm.size(); ++i) {
+            expected += std::string(2u, static_cast<char>('a' + i));
+        }
+        CHECK_EQ(recieved, expected);
+    });
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+TEST_CASE("AllocatorReusesBlocks")
+{
+    mpi::environment::initialize();
+
+    mpi::allocator<double> alloc;
+    double* first = alloc.allocate(100);
+    alloc.deallocate(first, 100);
+
+    // Same size class, so the block that was just freed is handed out again
+    double* second = alloc.allocate(90);
+    CHECK_EQ(first, second);
+    alloc.deallocate(second, 90);
+}
+
+TEST_CASE("AllocatorRebinds")
+{
+    mpi::environment::initialize();
+
+    mpi::allocator<int> ints;
+    mpi::allocator<char> chars(ints);
+    CHECK(chars == mpi::allocator<char>{});
+
+    char* p = chars.allocate(3);
+    chars.deallocate(p, 3);
+}
+
+TEST_CASE_TEMPLATE("BufferBroadcast", T, int, unsigned, char, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+
+    const mpi::id_type root = 0;
+    mpi::buffer<T> data(6);
+    if (comm.rank() == root) {
+        std::iota(data.begin(), data.end(), static_cast<T>(1));
+    }
+
+    comm.broadcast(root, data);
+
+    std::vector<T> expected(6);
+    std::iota(expected.begin(), expected.end(), static_cast<T>(1));
+    CHECK(std::equal(data.begin(), data.end(), expected.begin(), expected.end()));
+}
+
+TEST_CASE_TEMPLATE("BufferRecvResizes", T, int, unsigned, char, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+
+    if (comm.size() < 2) {
+        return; // Skipping
+    }
+
+    const mpi::id_type sender = comm.size() - 1;
+    const mpi::id_type reciever = 0;
+    const mpi::tag_type tag = 31;
+
+    if (comm.rank() == sender) {
+        mpi::buffer<T> data(1000, static_cast<T>(5));
+        comm.send(reciever, tag, data);
+    }
+    if (comm.rank() == reciever) {
+        mpi::buffer<T> recieved;
+        mpi::status status;
+        comm.recv(sender, tag, recieved, status);
+        CHECK_EQ(recieved.size(), 1000);
+        CHECK(std::all_of(recieved.begin(), recieved.end(), [](T x) { return x == static_cast<T>(5); }));
+    }
+}
+
+TEST_CASE_TEMPLATE("BufferGatherv", T, int, unsigned, char, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+
+    const mpi::id_type root = 0;
+    const mpi::buffer<T> data(static_cast<std::size_t>(comm.rank() + 1), static_cast<T>(comm.rank()));
+    mpi::buffer<T> recieved;
+
+    comm.gatherv(root, data, recieved);
+
+    if (comm.rank() == root) {
+        const auto n = static_cast<std::size_t>(comm.size());
+        CHECK_EQ(recieved.size(), n * (n + 1) / 2);
+        CHECK_EQ(recieved.back(), static_cast<T>(comm.size() - 1));
+    }
+}
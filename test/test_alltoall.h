@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE_TEMPLATE("VectorAlltoall", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto size = static_cast<std::size_t>(comm.size());
+        const auto rank = static_cast<std::size_t>(comm.rank());
+
+        // Rank r sends the pair {r, i} to rank i, encoded as 10*r + i
+        std::vector<T> data{};
+        for(std::size_t i=0; i<size; ++i) {
+            data.insert(data.end(), 2, static_cast<T>(10*rank + i));
+        }
+        std::vector<T> recieved{};
+
+        comm.alltoall(data, recieved);
+
+        REQUIRE_EQ(recieved.size(), 2 * size);
+        for(std::size_t i=0; i<size; ++i) {
+            CHECK_EQ(recieved[2*i],     static_cast<T>(10*i + rank));
+            CHECK_EQ(recieved[2*i + 1], static_cast<T>(10*i + rank));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorAlltoallv", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto size = static_cast<std::size_t>(comm.size());
+        const auto rank = static_cast<std::size_t>(comm.rank());
+
+        // Rank r sends i+1 copies of 10*r + i to rank i
+        std::vector<T> data{};
+        std::vector<mpi::size_type> send_counts{};
+        for(std::size_t i=0; i<size; ++i) {
+            data.insert(data.end(), i + 1, static_cast<T>(10*rank + i));
+            send_counts.push_back(static_cast<mpi::size_type>(i + 1));
+        }
+        std::vector<T> recieved{};
+
+        comm.alltoallv(data, recieved, send_counts);
+
+        // Every rank sends rank+1 elements to this rank
+        REQUIRE_EQ(recieved.size(), size * (rank + 1));
+        for(std::size_t i=0; i<size; ++i) {
+            for(std::size_t j=0; j<rank+1; ++j) {
+                CHECK_EQ(recieved[i*(rank+1) + j], static_cast<T>(10*i + rank));
+            }
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorAlltoallvKnownCounts", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto size = static_cast<std::size_t>(comm.size());
+        const auto rank = static_cast<std::size_t>(comm.rank());
+
+        // Rank r sends r+1 copies of r to every rank
+        const std::vector<T> data(size * (rank + 1), static_cast<T>(rank));
+        const std::vector<mpi::size_type> send_counts(size, static_cast<mpi::size_type>(rank + 1));
+        std::vector<mpi::size_type> recv_counts{};
+        for(std::size_t i=0; i<size; ++i) {
+            recv_counts.push_back(static_cast<mpi::size_type>(i + 1));
+        }
+        std::vector<T> recieved{};
+
+        comm.alltoallv(data, recieved, send_counts, recv_counts);
+
+        // Recieved data looks like [0,1,1,2,2,2, ...]
+        std::vector<T> expected{};
+        for(std::size_t i=0; i<size; ++i) {
+            expected.insert(expected.end(), i + 1, static_cast<T>(i));
+        }
+        CHECK_EQ(recieved, expected);
+    });
+}
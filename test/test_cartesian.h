@@ -0,0 +1,148 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+TEST_CASE("CartesianDimsCreate")
+{
+    auto comm = mpi::communicator::get_default();
+
+    const std::array<int, 2> dims{0, 0};
+    const std::array<bool, 2> periodic{false, false};
+    mpi::cartesian_communicator cart(comm, dims, periodic);
+
+    CHECK(cart.owning());
+    CHECK_EQ(cart.ndims(), 2);
+    CHECK_EQ(cart.size(), comm.size());
+    CHECK_EQ(cart.dims()[0] * cart.dims()[1], comm.size());
+    CHECK_GE(cart.dims()[0], cart.dims()[1]);
+
+    // Coordinates and ranks are consistent
+    auto coords = cart.coords(cart.rank());
+    CHECK_EQ(coords[0], cart.coords()[0]);
+    CHECK_EQ(coords[1], cart.coords()[1]);
+    CHECK_EQ(cart.rank_at(cart.coords()), cart.rank());
+
+    // Collectives of the base class are available
+    int sum = 0;
+    cart.allreduce(1, sum, std::plus<int>{});
+    CHECK_EQ(sum, comm.size());
+}
+
+TEST_CASE("CartesianShiftRing")
+{
+    auto comm = mpi::communicator::get_default();
+
+    const std::array<int, 1> dims{comm.size()};
+    const std::array<bool, 1> periodic{true};
+    mpi::cartesian_communicator ring(comm, dims, periodic, false);
+
+    auto [source, destination] = ring.shift(0, 1);
+    CHECK_EQ(source, (ring.rank() + ring.size() - 1) % ring.size());
+    CHECK_EQ(destination, (ring.rank() + 1) % ring.size());
+
+    const std::array<int, 1> right{1};
+    CHECK_EQ(ring.neighbour(right), destination);
+}
+
+TEST_CASE("CartesianNonPeriodicEdges")
+{
+    auto comm = mpi::communicator::get_default();
+
+    const std::array<int, 1> dims{comm.size()};
+    const std::array<bool, 1> periodic{false};
+    mpi::cartesian_communicator line(comm, dims, periodic, false);
+
+    auto [source, destination] = line.shift(0, 1);
+    if(line.rank() == 0) {
+        CHECK_EQ(source, mpi::cartesian_communicator::null_rank);
+    }
+    if(line.rank() == line.size() - 1) {
+        CHECK_EQ(destination, mpi::cartesian_communicator::null_rank);
+    }
+    const std::array<int, 1> outside{-1};
+    CHECK_EQ(line.rank_at(outside), mpi::cartesian_communicator::null_rank);
+}
+
+// Fills a block with the global coordinates of each element, encoded as row * 1000 + col
+template<typename T>
+std::vector<T> make_block(mpi::cartesian_communicator const& cart, int rows, int cols, int ghost) {
+    const int width = cols + 2 * ghost;
+    std::vector<T> block(static_cast<std::size_t>((rows + 2 * ghost) * width), T{});
+    for(int i=0; i < rows; ++i) {
+        for(int j=0; j < cols; ++j) {
+            const int global_row = cart.coords()[0] * rows + i;
+            const int global_col = cart.coords()[1] * cols + j;
+            block[static_cast<std::size_t>((i + ghost) * width + j + ghost)] = static_cast<T>(global_row * 1000 + global_col);
+        }
+    }
+    return block;
+}
+
+TEST_CASE_TEMPLATE("HaloExchangePeriodic2D", T, int, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+
+    const std::array<int, 2> dims{0, 0};
+    const std::array<bool, 2> periodic{true, true};
+    mpi::cartesian_communicator cart(comm, dims, periodic);
+
+    const int rows = 3, cols = 4, ghost = 1;
+    const std::array<int, 2> interior{rows, cols};
+    mpi::halo_exchange<T> halo(cart, interior, ghost);
+
+    auto block = make_block<T>(cart, rows, cols, ghost);
+    REQUIRE_EQ(block.size(), halo.layout().size());
+    halo.exchange(block);
+
+    // Every element, ghosts and corners included, holds the global coordinates wrapped around the grid
+    const int global_rows = rows * cart.dims()[0];
+    const int global_cols = cols * cart.dims()[1];
+    const int width = cols + 2 * ghost;
+    for(int i=0; i < rows + 2 * ghost; ++i) {
+        for(int j=0; j < cols + 2 * ghost; ++j) {
+            const int global_row = (cart.coords()[0] * rows + i - ghost + global_rows) % global_rows;
+            const int global_col = (cart.coords()[1] * cols + j - ghost + global_cols) % global_cols;
+            CHECK_EQ(block[static_cast<std::size_t>(i * width + j)], static_cast<T>(global_row * 1000 + global_col));
+        }
+    }
+}
+
+TEST_CASE("HaloExchangeNonPeriodicKeepsOuterGhosts")
+{
+    auto comm = mpi::communicator::get_default();
+
+    const std::array<int, 2> dims{0, 0};
+    const std::array<bool, 2> periodic{false, false};
+    mpi::cartesian_communicator cart(comm, dims, periodic);
+
+    const int rows = 2, cols = 2, ghost = 2;
+    const std::array<int, 2> interior{rows, cols};
+    mpi::halo_exchange<int> halo(cart, interior, ghost);
+
+    auto block = make_block<int>(cart, rows, cols, ghost);
+    const int untouched = -7;
+    const int width = cols + 2 * ghost;
+    for(int i=0; i < rows + 2 * ghost; ++i) {
+        for(int j=0; j < cols + 2 * ghost; ++j) {
+            if(i < ghost || i >= rows + ghost || j < ghost || j >= cols + ghost) {
+                block[static_cast<std::size_t>(i * width + j)] = untouched;
+            }
+        }
+    }
+    halo.exchange(block);
+
+    const int global_rows = rows * cart.dims()[0];
+    const int global_cols = cols * cart.dims()[1];
+    for(int i=0; i < rows + 2 * ghost; ++i) {
+        for(int j=0; j < cols + 2 * ghost; ++j) {
+            const int global_row = cart.coords()[0] * rows + i - ghost;
+            const int global_col = cart.coords()[1] * cols + j - ghost;
+            const bool inside = global_row >= 0 && global_row < global_rows && global_col >= 0 && global_col < global_cols;
+            CHECK_EQ(block[static_cast<std::size_t>(i * width + j)], inside ? global_row * 1000 + global_col : untouched);
+        }
+    }
+}
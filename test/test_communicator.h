@@ -0,0 +1,138 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE("CommunicatorDefaultIsNotOwning")
+{
+    on_every_backend([](auto comm) {
+        CHECK_FALSE(comm.owning());
+    });
+}
+
+TEST_CASE("CommunicatorDup")
+{
+    on_every_backend([](auto comm) {
+        auto dup = comm.dup();
+
+        CHECK(dup.owning());
+        CHECK_EQ(dup.rank(), comm.rank());
+        CHECK_EQ(dup.size(), comm.size());
+
+        int data = dup.rank() == 0 ? 5 : 0;
+        dup.broadcast(0, data);
+        CHECK_EQ(data, 5);
+    });
+}
+
+TEST_CASE("CommunicatorOwnership")
+{
+    on_every_backend([](auto comm) {
+        auto owner = comm.dup();
+        REQUIRE(owner.owning());
+
+        // Copies are views
+        auto view = owner;
+        CHECK_FALSE(view.owning());
+        CHECK(owner.owning());
+        CHECK_EQ(view.rank(), owner.rank());
+
+        // Moves transfer ownership
+        auto new_owner = std::move(owner);
+        CHECK(new_owner.owning());
+        CHECK_FALSE(owner.owning());
+
+        new_owner.free();
+        CHECK_FALSE(new_owner.owning());
+    });
+}
+
+TEST_CASE("CommunicatorSplitParity")
+{
+    on_every_backend([](auto comm) {
+        const int color = comm.rank() % 2;
+        auto half = *comm.split(color, comm.rank());
+
+        CHECK(half.owning());
+        CHECK_EQ(half.rank(), comm.rank() / 2);
+        CHECK_EQ(half.size(), (comm.size() + 1 - color) / 2);
+
+        // Broadcasting from the lowest rank of each half
+        int data = half.rank() == 0 ? comm.rank() : -1;
+        half.broadcast(0, data);
+        CHECK_EQ(data, color);
+    });
+}
+
+TEST_CASE("CommunicatorSplitReversed")
+{
+    on_every_backend([](auto comm) {
+        auto reversed = *comm.split(0, comm.size() - comm.rank());
+
+        CHECK_EQ(reversed.size(), comm.size());
+        CHECK_EQ(reversed.rank(), comm.size() - 1 - comm.rank());
+    });
+}
+
+TEST_CASE("CommunicatorSplitUndefined")
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+
+        // The last rank is left out, and the others keep their order
+        const bool left_out = comm.rank() == comm.size() - 1;
+        auto rest = comm.split(left_out ? communicator::undefined : 0, comm.rank());
+
+        CHECK_EQ(rest.has_value(), !left_out);
+        if(rest) {
+            CHECK(rest->owning());
+            CHECK_EQ(rest->rank(), comm.rank());
+            CHECK_EQ(rest->size(), comm.size() - 1);
+
+            int sum = 0;
+            rest->allreduce(1, sum, std::plus<int>{});
+            CHECK_EQ(sum, comm.size() - 1);
+        }
+    });
+}
+
+TEST_CASE("CommunicatorSplitShared")
+{
+    on_every_backend([](auto comm) {
+        auto node = comm.split_shared();
+
+        CHECK(node.owning());
+        CHECK_GE(node.size(), 1);
+        CHECK_LE(node.size(), comm.size());
+
+        // Every rank is in exactly one node
+        int is_node_root = node.rank() == 0 ? 1 : 0;
+        int n_nodes = 0;
+        comm.allreduce(is_node_root, n_nodes, std::plus<int>{});
+        int node_sizes = 0;
+        comm.allreduce(is_node_root * node.size(), node_sizes, std::plus<int>{});
+        CHECK_EQ(node_sizes, comm.size());
+    });
+}
+
+TEST_CASE("CommunicatorVectorOfOwners")
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        std::vector<communicator> owners;
+        for(int i=0; i<3; ++i) {
+            owners.push_back(comm.dup());
+        }
+
+        for(auto& c: owners) {
+            CHECK(c.owning());
+            CHECK_EQ(c.rank(), comm.rank());
+        }
+    });
+}
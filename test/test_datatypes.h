@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <complex>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+// Struct with padding between members and at the end
+struct particle {
+    char tag;
+    double mass;
+    std::array<float, 3> position;
+    int id;
+
+    bool operator==(particle const&) const = default;
+};
+
+template<>
+struct mpi::aggregate_traits<particle> {
+    static constexpr auto members = std::make_tuple(&particle::tag, &particle::mass, &particle::position, &particle::id);
+};
+
+using pixel = std::array<unsigned char, 3>;
+
+static_assert(mpi::ValidType<std::complex<double>>);
+static_assert(mpi::ValidType<particle>);
+static_assert(mpi::ValidContainer<std::vector<particle>>);
+static_assert(mpi::ValidContainer<std::vector<pixel>>);
+static_assert(mpi::ValidContainer<std::array<pixel, 4>>);
+static_assert(mpi::MappedType<std::array<std::array<int, 2>, 3>>);
+static_assert(!mpi::ValidType<std::array<int, 3>>, "Arrays are sent as containers");
+static_assert(!mpi::ValidType<std::vector<int>>);
+
+particle make_particle(mpi::id_type rank) {
+    const auto r = static_cast<float>(rank);
+    return particle{static_cast<char>('a' + rank), 1.5 * rank, {r, 2*r, 3*r}, rank};
+}
+
+TEST_CASE_TEMPLATE("ComplexBroadcastLast", T, float, double, long double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        const std::complex<T> root_v {T{1}, T{-2}};
+
+        std::complex<T> data = comm.rank() == root ? root_v : std::complex<T>{};
+        comm.broadcast(root, data);
+
+        CHECK_EQ(data, root_v);
+    });
+}
+
+TEST_CASE_TEMPLATE("ComplexVectorAllreduceSum", T, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto r = static_cast<T>(comm.rank());
+        const std::vector<std::complex<T>> data {{r, T{1}}, {T{1}, r}};
+        std::vector<std::complex<T>> output{};
+
+        comm.allreduce(data, output, std::plus<>{});
+
+        const auto total = static_cast<T>(comm.size() * (comm.size() - 1) / 2);
+        const auto n = static_cast<T>(comm.size());
+        const std::complex<T> expected_0 {total, n};
+        const std::complex<T> expected_1 {n, total};
+        REQUIRE_EQ(output.size(), 2u);
+        CHECK_EQ(output[0], expected_0);
+        CHECK_EQ(output[1], expected_1);
+    });
+}
+
+TEST_CASE("PixelGatherFirst")
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const auto c = static_cast<unsigned char>(comm.rank());
+        const pixel px {c, static_cast<unsigned char>(c + 1), static_cast<unsigned char>(c + 2)};
+        std::vector<pixel> recieved{};
+
+        comm.gather(root, px, recieved);
+
+        if (comm.rank() == root) {
+            REQUIRE_EQ(recieved.size(), comm.size());
+            for(mpi::id_type i=0; i<comm.size(); ++i) {
+                const auto ci = static_cast<unsigned char>(i);
+                const pixel expected {ci, static_cast<unsigned char>(ci + 1), static_cast<unsigned char>(ci + 2)};
+                CHECK_EQ(recieved[static_cast<std::size_t>(i)], expected);
+            }
+        } else {
+            REQUIRE(recieved.empty());
+        }
+    });
+}
+
+TEST_CASE("NestedArrayAllgather")
+{
+    on_every_backend([](auto comm) {
+        using block = std::array<std::array<short, 2>, 2>;
+        const auto r = static_cast<short>(comm.rank());
+        const std::vector<block> data {block{{{r, r}, {r, r}}}};
+        std::vector<block> recieved{};
+
+        comm.allgather(data, recieved);
+
+        REQUIRE_EQ(recieved.size(), comm.size());
+        for(mpi::id_type i=0; i<comm.size(); ++i) {
+            const auto s = static_cast<short>(i);
+            const block expected {{{s, s}, {s, s}}};
+            CHECK_EQ(recieved[static_cast<std::size_t>(i)], expected);
+        }
+    });
+}
+
+TEST_CASE("AggregateBroadcastMiddle")
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() / 2;
+        particle data = comm.rank() == root ? make_particle(root) : particle{};
+
+        comm.broadcast(root, data);
+
+        CHECK_EQ(data, make_particle(root));
+    });
+}
+
+TEST_CASE("AggregateVectorGatherLast")
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        const std::vector<particle> data {make_particle(comm.rank()), make_particle(comm.rank())};
+        std::vector<particle> recieved{};
+
+        comm.gather(root, data, recieved);
+
+        if (comm.rank() == root) {
+            REQUIRE_EQ(recieved.size(), 2 * comm.size());
+            for(mpi::id_type i=0; i<comm.size(); ++i) {
+                CHECK_EQ(recieved[static_cast<std::size_t>(2*i)], make_particle(i));
+                CHECK_EQ(recieved[static_cast<std::size_t>(2*i + 1)], make_particle(i));
+            }
+        } else {
+            REQUIRE(recieved.empty());
+        }
+    });
+}
+
+TEST_CASE("AggregateSendRecv")
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type sender = 0;
+        const mpi::id_type reciever = comm.size() - 1;
+        const mpi::tag_type tag = 11;
+
+        if (comm.rank() == sender) {
+            particle data = make_particle(42);
+            comm.send(reciever, tag, data);
+        }
+        if (comm.rank() == reciever) {
+            particle data{};
+            typename communicator::status status;
+            comm.recv(sender, tag, data, status);
+            CHECK_EQ(data, make_particle(42));
+        }
+    });
+}
+
+TEST_CASE("AggregateAllreduceUserDefined")
+{
+    on_every_backend([](auto comm) {
+        auto heaviest = [](particle const& lhs, particle const& rhs) {
+            return lhs.mass < rhs.mass ? rhs : lhs;
+        };
+        particle output{};
+
+        comm.allreduce(make_particle(comm.rank()), output, heaviest);
+
+        CHECK_EQ(output, make_particle(comm.size() - 1));
+    });
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+TEST_CASE("EnvironmentRunning")
+{
+    mpi::environment::initialize();
+
+    CHECK_EQ(mpi::environment::stage(), mpi::environment::stages::running);
+    CHECK_NOTHROW(mpi::environment::assert_running());
+}
+
+TEST_CASE("EnvironmentThreading")
+{
+    mpi::environment::initialize();
+
+    // Initializing again has no effect on the provided level
+    const auto provided = mpi::environment::provided_threading();
+    mpi::environment::initialize(mpi::threading::multiple);
+    CHECK_EQ(mpi::environment::provided_threading(), provided);
+}
+
+TEST_CASE("EnvironmentThreadMayCall")
+{
+    mpi::environment::initialize();
+
+    // The main thread initialized the environment, and other threads depend on the provided level
+    CHECK(mpi::environment::thread_may_call());
+
+    bool other = false;
+    std::thread([&]() { other = mpi::environment::thread_may_call(); }).join();
+    CHECK_EQ(other, mpi::environment::provided_threading() >= mpi::threading::serialized);
+}
+
+TEST_CASE("EnvironmentThreadingMultiple")
+{
+    auto comm = mpi::communicator::get_default();
+
+    if (mpi::environment::provided_threading() != mpi::threading::multiple || comm.size() < 2) {
+        return; // Skipping
+    }
+
+    // Every thread exchanges a message with the same thread in the neighbouring ranks
+    constexpr int n_threads = 4;
+    const mpi::id_type next = (comm.rank() + 1) % comm.size();
+    const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+    std::vector<int> recieved(n_threads, -1);
+    std::vector<std::thread> threads;
+    for(int t=0; t<n_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            auto r = comm.irecv(prev, t, recieved[static_cast<std::size_t>(t)]);
+            const int message = prev * n_threads + t;
+            comm.isend(next, t, message).wait();
+            r.wait();
+        });
+    }
+    for(auto& t: threads) {
+        t.join();
+    }
+
+    for(int t=0; t<n_threads; ++t) {
+        CHECK_EQ(recieved[static_cast<std::size_t>(t)], (comm.rank() + comm.size() - 2) % comm.size() * n_threads + t);
+    }
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+// Rank i contributes i+1 copies of the value i
+template<typename T>
+std::vector<T> SetupContainerGatherv(mpi::id_type rank)
+{
+    return std::vector<T>(static_cast<std::size_t>(rank + 1), static_cast<T>(rank));
+}
+
+// Expected result of gathering SetupContainerGatherv from every rank: [0, 1, 1, 2, 2, 2, ...]
+template<typename T>
+std::vector<T> ExpectedGatherv(mpi::size_type size)
+{
+    std::vector<T> expected;
+    for(mpi::id_type i=0; i<size; ++i) {
+        const auto partial = SetupContainerGatherv<T>(i);
+        expected.insert(expected.end(), partial.begin(), partial.end());
+    }
+    return expected;
+}
+
+TEST_CASE_TEMPLATE("VectorGathervFirst", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const auto data = SetupContainerGatherv<T>(comm.rank());
+        std::vector<T> recieved{};
+
+        comm.gatherv(root, data, recieved);
+
+        if (comm.rank() == root) {
+            CHECK_EQ(recieved, ExpectedGatherv<T>(comm.size()));
+        } else {
+            REQUIRE(recieved.empty());
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorGathervLast", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        const auto data = SetupContainerGatherv<T>(comm.rank());
+        std::vector<T> recieved{};
+
+        comm.gatherv(root, data, recieved);
+
+        if (comm.rank() == root) {
+            CHECK_EQ(recieved, ExpectedGatherv<T>(comm.size()));
+        } else {
+            REQUIRE(recieved.empty());
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorGathervKnownCounts", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const auto data = SetupContainerGatherv<T>(comm.rank());
+        std::vector<T> recieved{};
+
+        std::vector<mpi::size_type> counts(static_cast<std::size_t>(comm.size()));
+        std::iota(counts.begin(), counts.end(), 1);
+
+        comm.gatherv(root, data, recieved, counts);
+
+        if (comm.rank() == root) {
+            CHECK_EQ(recieved, ExpectedGatherv<T>(comm.size()));
+        } else {
+            REQUIRE(recieved.empty());
+        }
+    });
+}
+
+TEST_CASE("StringGathervFirst")
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const std::string data(static_cast<std::size_t>(comm.rank() + 1), static_cast<char>('a' + comm.rank()));
+        std::string recieved{};
+
+        comm.gatherv(root, data, recieved);
+
+        if (comm.rank() == root) {
+            // Checking string looks like "abbcccdddd..."
+            std::string expected;
+            for(mpi::id_type i=0; i<comm.size(); ++i) {
+                expected += std::string(static_cast<std::size_t>(i + 1), static_cast<char>('a' + i));
+            }
+            CHECK_EQ(recieved, expected);
+        } else {
+            REQUIRE(recieved.empty());
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorAllgatherv", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto data = SetupContainerGatherv<T>(comm.rank());
+        std::vector<T> recieved{};
+
+        comm.allgatherv(data, recieved);
+
+        CHECK_EQ(recieved, ExpectedGatherv<T>(comm.size()));
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorAllgathervKnownCounts", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto data = SetupContainerGatherv<T>(comm.rank());
+        std::vector<T> recieved{};
+
+        std::vector<mpi::size_type> counts(static_cast<std::size_t>(comm.size()));
+        std::iota(counts.begin(), counts.end(), 1);
+
+        comm.allgatherv(data, recieved, counts);
+
+        CHECK_EQ(recieved, ExpectedGatherv<T>(comm.size()));
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorScattervEven", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const auto size = static_cast<std::size_t>(comm.size());
+
+        // One element more than a multiple of the number of ranks
+        std::vector<T> data{};
+        if (comm.rank() == root) {
+            data.resize(2 * size + 1);
+            std::iota(data.begin(), data.end(), T{0});
+        }
+        std::vector<T> recieved{};
+
+        comm.scatterv(root, data, recieved);
+
+        const auto rank = static_cast<std::size_t>(comm.rank());
+        const std::size_t expected_size = rank == 0 ? 3 : 2;
+        const std::size_t expected_first = rank == 0 ? 0 : 2*rank + 1;
+
+        REQUIRE_EQ(recieved.size(), expected_size);
+        for(std::size_t i=0; i < expected_size; ++i) {
+            CHECK_EQ(recieved[i], static_cast<T>(expected_first + i));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorScattervKnownCounts", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        std::vector<T> data{};
+        if (comm.rank() == root) {
+            data = ExpectedGatherv<T>(comm.size());
+        }
+        std::vector<T> recieved{};
+
+        std::vector<mpi::size_type> counts(static_cast<std::size_t>(comm.size()));
+        std::iota(counts.begin(), counts.end(), 1);
+
+        comm.scatterv(root, data, recieved, counts);
+
+        CHECK_EQ(recieved, SetupContainerGatherv<T>(comm.rank()));
+    });
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE_TEMPLATE("InPlaceGather", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        const std::size_t n = 3;
+        const auto ranks = static_cast<std::size_t>(comm.size());
+        const auto rank = static_cast<std::size_t>(comm.rank());
+
+        if (comm.rank() == root) {
+            // The contribution of the root is already in place
+            std::vector<T> data(n * ranks, T{});
+            for(std::size_t i=0; i<n; ++i) {
+                data[rank * n + i] = static_cast<T>(rank * n + i);
+            }
+
+            comm.gather(root, data);
+
+            for(std::size_t i=0; i<data.size(); ++i) {
+                CHECK_EQ(data[i], static_cast<T>(i));
+            }
+        } else {
+            std::vector<T> data(n);
+            for(std::size_t i=0; i<n; ++i) {
+                data[i] = static_cast<T>(rank * n + i);
+            }
+            const auto sent = data;
+
+            comm.gather(root, data);
+
+            CHECK_EQ(data, sent);
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("InPlaceAllgather", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const std::size_t n = 2;
+        const auto rank = static_cast<std::size_t>(comm.rank());
+
+        std::vector<T> data(n * static_cast<std::size_t>(comm.size()), T{});
+        for(std::size_t i=0; i<n; ++i) {
+            data[rank * n + i] = static_cast<T>(rank * n + i);
+        }
+
+        comm.allgather(data);
+
+        for(std::size_t i=0; i<data.size(); ++i) {
+            CHECK_EQ(data[i], static_cast<T>(i));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("InPlaceReduce", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        auto data = static_cast<T>(comm.rank());
+
+        comm.reduce(root, data, std::plus<>{});
+
+        if (comm.rank() == root) {
+            CHECK_EQ(data, static_cast<T>(comm.size() * (comm.size() - 1) / 2));
+        } else {
+            CHECK_EQ(data, static_cast<T>(comm.rank()));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorInPlaceReduce", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        const auto r = static_cast<T>(comm.rank());
+        const std::vector<T> sent {r, static_cast<T>(2*r)};
+        auto data = sent;
+
+        comm.reduce(root, data, mpi::max<T>{});
+
+        if (comm.rank() == root) {
+            const auto last = static_cast<T>(comm.size() - 1);
+            const std::vector<T> expected {last, static_cast<T>(2*last)};
+            CHECK_EQ(data, expected);
+        } else {
+            CHECK_EQ(data, sent);
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("InPlaceAllreduce", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        auto data = static_cast<T>(comm.rank());
+
+        comm.allreduce(data, std::plus<>{});
+
+        CHECK_EQ(data, static_cast<T>(comm.size() * (comm.size() - 1) / 2));
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorInPlaceAllreduce", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto r = static_cast<T>(comm.rank());
+        std::vector<T> data {r, T{1}, static_cast<T>(r + 1)};
+
+        comm.allreduce(data, mpi::min<T>{});
+
+        const std::vector<T> expected {T{0}, T{1}, T{1}};
+        CHECK_EQ(data, expected);
+    });
+}
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+// The tests are built with a lowered mpi::max_count, so that these sizes take the large-count paths:
+// several whole blocks with a remainder, and an exact multiple of the block size
+template<typename T>
+std::vector<T> SetupLargeCount(std::size_t n)
+{
+    std::vector<T> data(n);
+    for(std::size_t i=0; i<n; ++i) {
+        data[i] = static_cast<T>(i % 100);
+    }
+    return data;
+}
+
+TEST_CASE("SizeTypeIsWide")
+{
+    mpi::environment::initialize();
+
+    CHECK(sizeof(mpi::size_type) == 8);
+    CHECK(mpi::max_count > 0);
+}
+
+TEST_CASE_TEMPLATE("LargeCountSendRecv", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type sender = 0;
+        const mpi::id_type reciever = comm.size() - 1;
+        const mpi::tag_type tag = 41;
+        const auto n = static_cast<std::size_t>(2 * mpi::max_count + 17);
+        const auto expected = SetupLargeCount<T>(n);
+
+        if (comm.rank() == sender) {
+            auto data = expected;
+            comm.send(reciever, tag, data);
+            comm.send(reciever, tag, data);
+        }
+        if (comm.rank() == reciever) {
+            typename communicator::status status;
+
+            // Known size, received into an array that is not resized
+            std::vector<T> presized(n);
+            auto r = comm.irecv(sender, tag, presized);
+            r.wait();
+            CHECK_EQ(presized, expected);
+
+            // Unknown size, probed before receiving
+            std::vector<T> resized;
+            comm.recv(sender, tag, resized, status);
+            CHECK_EQ(resized, expected);
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("LargeCountBroadcast", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const auto n = static_cast<std::size_t>(3 * mpi::max_count);
+        const auto expected = SetupLargeCount<T>(n);
+        std::vector<T> data = comm.rank() == root ? expected : std::vector<T>(n);
+
+        comm.broadcast(root, data);
+
+        CHECK_EQ(data, expected);
+    });
+}
+
+TEST_CASE_TEMPLATE("LargeCountAllgather", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto n = static_cast<std::size_t>(mpi::max_count + 3);
+        const auto data = SetupLargeCount<T>(n);
+        std::vector<T> recieved;
+
+        comm.allgather(data, recieved);
+
+        REQUIRE_EQ(recieved.size(), n * static_cast<std::size_t>(comm.size()));
+        for(std::size_t r=0; r<static_cast<std::size_t>(comm.size()); ++r) {
+            CHECK(std::equal(data.begin(), data.end(), recieved.begin() + static_cast<std::ptrdiff_t>(r * n)));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("LargeCountAllreduce", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto n = static_cast<std::size_t>(2 * mpi::max_count + 5);
+        const auto data = SetupLargeCount<T>(n);
+        std::vector<T> output;
+
+        comm.allreduce(data, output, std::plus<>{});
+
+        std::vector<T> expected(n);
+        std::transform(data.begin(), data.end(), expected.begin(), [&](T x) { return static_cast<T>(comm.size()) * x; });
+        CHECK_EQ(output, expected);
+    });
+}
+
+TEST_CASE_TEMPLATE("LargeCountInPlaceAllreduce", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto n = static_cast<std::size_t>(2 * mpi::max_count + 5);
+        const auto data = SetupLargeCount<T>(n);
+        auto output = data;
+
+        comm.allreduce(output, std::plus<>{});
+
+        std::vector<T> expected(n);
+        std::transform(data.begin(), data.end(), expected.begin(), [&](T x) { return static_cast<T>(comm.size()) * x; });
+        CHECK_EQ(output, expected);
+    });
+}
+
+TEST_CASE("LargeCountNonblockingAllreduceThrows")
+{
+    auto comm = mpi::communicator::get_default();
+
+    // With MPI, a single request cannot take more than max_count elements, and nothing may be truncated
+    if constexpr(mpi::mpi_enabled()) {
+        const auto data = SetupLargeCount<int>(static_cast<std::size_t>(mpi::max_count + 1));
+        std::vector<int> output;
+        CHECK_THROWS_AS(static_cast<void>(comm.iallreduce(data, output, std::plus<>{})), std::overflow_error);
+    }
+}
+
+TEST_CASE_TEMPLATE("LargeCountInPlaceAllgather", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto n = static_cast<std::size_t>(mpi::max_count + 3);
+        const auto data = SetupLargeCount<T>(n);
+        const auto offset = static_cast<std::ptrdiff_t>(n * static_cast<std::size_t>(comm.rank()));
+        std::vector<T> recieved(n * static_cast<std::size_t>(comm.size()));
+        std::copy(data.begin(), data.end(), recieved.begin() + offset);
+
+        comm.allgather(recieved);
+
+        for(std::size_t r=0; r<static_cast<std::size_t>(comm.size()); ++r) {
+            CHECK(std::equal(data.begin(), data.end(), recieved.begin() + static_cast<std::ptrdiff_t>(r * n)));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("LargeCountWindowPutGet", T, int, unsigned, char, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+
+    const auto n = static_cast<std::size_t>(mpi::max_count + 100);
+    const auto expected = SetupLargeCount<T>(n);
+    mpi::window<T> w(comm, static_cast<mpi::size_type>(n));
+
+    const mpi::id_type target = (comm.rank() + 1) % comm.size();
+    {
+        auto epoch = w.fence_epoch();
+        w.put(expected, target, 0);
+    }
+
+    std::vector<T> recieved(n);
+    {
+        auto epoch = w.fence_epoch();
+        w.get(recieved, target, 0);
+    }
+    CHECK_EQ(recieved, expected);
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <functional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+// Nonblocking operations reject temporaries, which would be gone before the request completes
+template<typename Communicator>
+constexpr bool rejects_temporaries = requires(Communicator const& comm, int& value, std::vector<int>& output) {
+    comm.isend(0, 0, value);
+    comm.igather(0, value, output);
+    comm.iallreduce(value, value, std::plus<>{});
+    comm.ibroadcast(0, value);
+} && !requires(Communicator const& comm) {
+    comm.isend(0, 0, 1);
+} && !requires(Communicator const& comm) {
+    comm.isend(0, 0, std::vector<int>{});
+} && !requires(Communicator const& comm, std::vector<int>& output) {
+    comm.igather(0, 1, output);
+} && !requires(Communicator const& comm, std::vector<int>& output) {
+    comm.igather(0, std::vector<int>{}, output);
+} && !requires(Communicator const& comm, int& value) {
+    comm.iallreduce(1, value, std::plus<>{});
+} && !requires(Communicator const& comm, std::vector<int>& output) {
+    comm.iallreduce(std::vector<int>{}, output, std::plus<>{});
+} && !requires(Communicator const& comm) {
+    comm.ibroadcast(0, std::vector<int>{});
+};
+static_assert(rejects_temporaries<mpi::communicator>);
+static_assert(rejects_temporaries<mpi::thread_communicator>);
+
+// Temporary views are fine, as the data they refer to outlives them
+template<typename Communicator>
+constexpr bool accepts_temporary_views = requires(Communicator const& comm, std::vector<int>& data, std::span<int>& output) {
+    comm.isend(0, 0, std::span<const int>(data).subspan(1));
+    comm.igather(0, std::span<int>(data), output);
+    comm.iallreduce(std::span<int>(data), output, std::plus<>{});
+};
+static_assert(accepts_temporary_views<mpi::communicator>);
+static_assert(accepts_temporary_views<mpi::thread_communicator>);
+
+TEST_CASE("RequestDefaultIsInactive")
+{
+    mpi::environment::initialize();
+
+    mpi::request r;
+    CHECK_FALSE(r.active());
+    CHECK(r.test());
+    r.wait();
+
+    std::vector<mpi::request> requests(3);
+    mpi::request::wait_all(requests);
+    CHECK_FALSE(mpi::request::wait_any(requests).has_value());
+    CHECK(mpi::request::wait_some(requests).empty());
+}
+
+TEST_CASE_TEMPLATE("IsendIrecvRing", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+        const mpi::tag_type tag = 7;
+
+        const auto sent = static_cast<T>(comm.rank());
+        T recieved{};
+
+        auto r_recv = comm.irecv(prev, tag, recieved);
+        auto r_send = comm.isend(next, tag, sent);
+        CHECK(r_recv.active());
+
+        typename communicator::status s;
+        r_recv.wait(s);
+        r_send.wait();
+
+        CHECK_FALSE(r_recv.active());
+        CHECK_FALSE(r_send.active());
+        CHECK_EQ(recieved, static_cast<T>(prev));
+        CHECK_EQ(s.MPI_SOURCE, prev);
+        CHECK_EQ(s.MPI_TAG, tag);
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorIsendIrecvWaitAll", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+        const auto sent_value = static_cast<T>(comm.rank());
+        const std::vector<T> sent {sent_value, sent_value, sent_value};
+        std::vector<T> recieved(3u);
+
+        std::vector<typename communicator::request> requests;
+        requests.push_back(comm.irecv(prev, 3, recieved));
+        requests.push_back(comm.isend(next, 3, sent));
+
+        communicator::request::wait_all(requests);
+
+        for(auto& r: requests) {
+            CHECK_FALSE(r.active());
+        }
+        for(auto& r: recieved) {
+            CHECK_EQ(r, static_cast<T>(prev));
+        }
+    });
+}
+
+TEST_CASE("IsendTemporarySpan")
+{
+    on_every_backend([](auto comm) {
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+        const std::vector<int> sent {-1, -1, static_cast<int>(comm.rank()), 1, 2, -1};
+        std::vector<int> recieved(3u);
+
+        auto r_recv = comm.irecv(prev, 5, recieved);
+        auto r_send = comm.isend(next, 5, std::span<const int>(sent).subspan(2, 3));
+        r_recv.wait();
+        r_send.wait();
+
+        CHECK_EQ(recieved, std::vector<int>{static_cast<int>(prev), 1, 2});
+    });
+}
+
+TEST_CASE("IsendIrecvWaitAnySome")
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+        std::vector<int> recieved(4u, -1);
+        std::vector<typename communicator::request> requests;
+        for(int i=0; i<4; ++i) {
+            requests.push_back(comm.irecv(prev, i, recieved[static_cast<std::size_t>(i)]));
+        }
+
+        const std::vector<int> sent {0, 1, 2, 3};
+        std::vector<typename communicator::request> send_requests;
+        for(int i=0; i<4; ++i) {
+            send_requests.push_back(comm.isend(next, i, sent[static_cast<std::size_t>(i)]));
+        }
+
+        std::size_t completed = 0;
+        const auto first = communicator::request::wait_any(requests);
+        REQUIRE(first.has_value());
+        CHECK_FALSE(requests[*first].active());
+        ++completed;
+
+        while(completed < requests.size()) {
+            const auto indices = communicator::request::wait_some(requests);
+            REQUIRE_FALSE(indices.empty());
+            completed += indices.size();
+        }
+
+        CHECK_FALSE(communicator::request::wait_any(requests).has_value());
+        communicator::request::wait_all(send_requests);
+        CHECK_EQ(recieved, sent);
+    });
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE("Ibarrier")
+{
+    on_every_backend([](auto comm) {
+        auto r = comm.ibarrier();
+        r.wait();
+        CHECK_FALSE(r.active());
+    });
+}
+
+TEST_CASE_TEMPLATE("Ibroadcast", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        T value = comm.rank() == root ? static_cast<T>(42) : T{};
+
+        auto r = comm.ibroadcast(root, value);
+        r.wait();
+
+        CHECK_EQ(value, static_cast<T>(42));
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorIbroadcast", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        std::vector<T> data(5);
+        if (comm.rank() == root) {
+            std::iota(data.begin(), data.end(), static_cast<T>(1));
+        }
+
+        auto r = comm.ibroadcast(root, data);
+        r.wait();
+
+        std::vector<T> expected(5);
+        std::iota(expected.begin(), expected.end(), static_cast<T>(1));
+        CHECK_EQ(data, expected);
+    });
+}
+
+TEST_CASE_TEMPLATE("Igather", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const auto data = static_cast<T>(comm.rank());
+        std::vector<T> recieved{};
+
+        auto r = comm.igather(root, data, recieved);
+        r.wait();
+
+        if (comm.rank() == root) {
+            std::vector<T> expected(static_cast<std::size_t>(comm.size()));
+            std::iota(expected.begin(), expected.end(), T{});
+            CHECK_EQ(recieved, expected);
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorIgather", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const std::vector<T> data(3, static_cast<T>(comm.rank()));
+        std::vector<T> recieved{};
+
+        auto r = comm.igather(root, data, recieved);
+        r.wait();
+
+        if (comm.rank() == root) {
+            std::vector<T> expected;
+            for(mpi::id_type i=0; i<comm.size(); ++i) {
+                expected.insert(expected.end(), 3, static_cast<T>(i));
+            }
+            CHECK_EQ(recieved, expected);
+        }
+    });
+}
+
+// Rank i contributes i+1 copies of the value i
+TEST_CASE_TEMPLATE("VectorIgatherv", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const std::vector<T> data(static_cast<std::size_t>(comm.rank() + 1), static_cast<T>(comm.rank()));
+        std::vector<T> recieved{};
+
+        auto r = comm.igatherv(root, data, recieved);
+        r.wait();
+
+        if (comm.rank() == root) {
+            std::vector<T> expected;
+            for(mpi::id_type i=0; i<comm.size(); ++i) {
+                expected.insert(expected.end(), static_cast<std::size_t>(i + 1), static_cast<T>(i));
+            }
+            CHECK_EQ(recieved, expected);
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorIgathervCounts", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        const std::vector<T> data(static_cast<std::size_t>(comm.rank() + 1), static_cast<T>(comm.rank()));
+        std::vector<mpi::size_type> counts(static_cast<std::size_t>(comm.size()));
+        std::iota(counts.begin(), counts.end(), 1);
+        std::vector<T> recieved{};
+
+        auto r = comm.igatherv(root, data, recieved, counts);
+        r.wait();
+
+        if (comm.rank() == root) {
+            std::vector<T> expected;
+            for(mpi::id_type i=0; i<comm.size(); ++i) {
+                expected.insert(expected.end(), static_cast<std::size_t>(i + 1), static_cast<T>(i));
+            }
+            CHECK_EQ(recieved, expected);
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("Iallreduce", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto data = static_cast<T>(comm.rank());
+        T result{};
+
+        auto r = comm.iallreduce(data, result, std::plus<>{});
+        r.wait();
+
+        CHECK_EQ(result, static_cast<T>(comm.size() * (comm.size() - 1) / 2));
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorIallreduce", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const std::vector<T> data{static_cast<T>(comm.rank()), static_cast<T>(1)};
+        std::vector<T> result{};
+
+        auto r = comm.iallreduce(data, result, std::plus<>{});
+        r.wait();
+
+        const std::vector<T> expected{static_cast<T>(comm.size() * (comm.size() - 1) / 2), static_cast<T>(comm.size())};
+        CHECK_EQ(result, expected);
+    });
+}
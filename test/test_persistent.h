@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE("PersistentRequestDefaultIsInactive")
+{
+    mpi::environment::initialize();
+
+    mpi::persistent_request r;
+    CHECK_FALSE(r.active());
+    CHECK(r.test());
+    r.wait();
+
+    std::vector<mpi::persistent_request> requests(3);
+    mpi::persistent_request::wait_all(requests);
+}
+
+TEST_CASE_TEMPLATE("PersistentRing", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+        const mpi::tag_type tag = 3;
+
+        T sent{};
+        T recieved{};
+        auto r_recv = comm.recv_init(prev, tag, recieved);
+        auto r_send = comm.send_init(next, tag, sent);
+        CHECK_FALSE(r_recv.active());
+
+        // The same requests are reused with new data at every iteration
+        for(int i=0; i < 10; ++i) {
+            sent = static_cast<T>(comm.rank() + i);
+            r_recv.start();
+            r_send.start();
+            CHECK(r_recv.active());
+            r_recv.wait();
+            r_send.wait();
+
+            CHECK_FALSE(r_recv.active());
+            CHECK_EQ(recieved, static_cast<T>(prev + i));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("PersistentStartAll", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+        std::vector<T> sent(5);
+        std::array<T, 5> recieved{};
+
+        std::vector<typename communicator::persistent_request> requests;
+        requests.push_back(comm.recv_init(prev, 0, recieved));
+        requests.push_back(comm.send_init(next, 0, sent));
+
+        for(int i=0; i < 10; ++i) {
+            for(std::size_t j=0; j < sent.size(); ++j) {
+                sent[j] = static_cast<T>(comm.rank() + i + static_cast<int>(j));
+            }
+            communicator::persistent_request::start_all(requests);
+            communicator::persistent_request::wait_all(requests);
+
+            CHECK_FALSE(requests[0].active());
+            for(std::size_t j=0; j < recieved.size(); ++j) {
+                CHECK_EQ(recieved[j], static_cast<T>(prev + i + static_cast<int>(j)));
+            }
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("PersistentOwnedRing", T, int, double)
+{
+    on_every_backend([](auto comm) {
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+        // The requests own their buffers, which stay put when the requests are moved
+        auto r_recv = comm.recv_init(prev, 0, std::vector<T>(4));
+        auto r_send = comm.send_init(next, 0, std::vector<T>(4));
+        auto moved = std::move(r_send);
+
+        for(int i=0; i < 5; ++i) {
+            auto& sent = moved.template data<std::vector<T>>();
+            std::fill(sent.begin(), sent.end(), static_cast<T>(comm.rank() + i));
+            r_recv.start();
+            moved.start();
+            r_recv.wait();
+            moved.wait();
+
+            const auto& recieved = r_recv.template data<std::vector<T>>();
+            CHECK_EQ(recieved, std::vector<T>(4, static_cast<T>(prev + i)));
+        }
+
+        // Scalars are owned the same way
+        auto s_recv = comm.recv_init(prev, 1, T{});
+        auto s_send = comm.send_init(next, 1, static_cast<T>(comm.rank()));
+        s_recv.start();
+        s_send.start();
+        s_recv.wait();
+        s_send.wait();
+        CHECK_EQ(s_recv.template data<T>(), static_cast<T>(prev));
+    });
+}
+
+TEST_CASE("PersistentTestUntilComplete")
+{
+    on_every_backend([](auto comm) {
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+        const double sent = 1.5 * comm.rank();
+        double recieved = 0;
+        auto r_recv = comm.recv_init(prev, 0, recieved);
+        auto r_send = comm.send_init(next, 0, sent);
+
+        r_recv.start();
+        r_send.start();
+        while(!r_recv.test()) { }
+        while(!r_send.test()) { }
+
+        CHECK_FALSE(r_recv.active());
+        CHECK_EQ(recieved, 1.5 * prev);
+
+        // Moving a request keeps it usable
+        auto moved = std::move(r_recv);
+        moved.start();
+        r_send.start();
+        moved.wait();
+        r_send.wait();
+        CHECK_EQ(recieved, 1.5 * prev);
+    });
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE_TEMPLATE("VectorRecvResizes", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type sender = 0;
+        const mpi::id_type reciever = comm.size() - 1;
+        const mpi::tag_type tag = 21;
+
+        std::vector<T> expected(7);
+        std::iota(expected.begin(), expected.end(), static_cast<T>(1));
+
+        if (comm.rank() == sender) {
+            comm.send(reciever, tag, expected);
+        }
+        if (comm.rank() == reciever) {
+            std::vector<T> recieved(2);
+            typename communicator::status status;
+            comm.recv(sender, tag, recieved, status);
+            CHECK_EQ(recieved, expected);
+            CHECK_EQ(status.MPI_SOURCE, sender);
+            CHECK_EQ(status.MPI_TAG, tag);
+        }
+    });
+}
+
+TEST_CASE("StringRecvAnySource")
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type root = 0;
+        const mpi::tag_type tag = 22;
+
+        if (comm.rank() != root) {
+            std::string message(static_cast<std::size_t>(comm.rank()), 'a');
+            comm.send(root, tag, message);
+            return;
+        }
+
+        std::vector<mpi::id_type> sources;
+        for (mpi::id_type i=1; i<comm.size(); ++i) {
+            std::string recieved;
+            typename communicator::status status;
+            comm.recv(communicator::any_source, tag, recieved, status);
+            CHECK_EQ(recieved, std::string(static_cast<std::size_t>(status.MPI_SOURCE), 'a'));
+            sources.push_back(status.MPI_SOURCE);
+        }
+
+        std::sort(sources.begin(), sources.end());
+        std::vector<mpi::id_type> expected(static_cast<std::size_t>(comm.size() - 1));
+        std::iota(expected.begin(), expected.end(), 1);
+        CHECK_EQ(sources, expected);
+    });
+}
+
+TEST_CASE_TEMPLATE("ProbeEnvelope", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type sender = comm.size() - 1;
+        const mpi::id_type reciever = 0;
+        const mpi::tag_type tag = 23;
+
+        if (comm.rank() == sender) {
+            std::vector<T> data(5, static_cast<T>(3));
+            comm.send(reciever, tag, data);
+        }
+        if (comm.rank() == reciever) {
+            const typename communicator::envelope e = comm.template probe<T>(communicator::any_source, communicator::any_tag);
+            CHECK_EQ(e.source, sender);
+            CHECK_EQ(e.tag, tag);
+            CHECK_EQ(e.count, 5);
+
+            std::vector<T> recieved(static_cast<std::size_t>(e.count));
+            typename communicator::status status;
+            comm.recv(e.source, e.tag, recieved, status);
+            CHECK_EQ(recieved, std::vector<T>(5, static_cast<T>(3)));
+        }
+    });
+}
+
+TEST_CASE("IprobeWithoutMessage")
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        const mpi::tag_type unused_tag = 24;
+        CHECK_FALSE(comm.template iprobe<int>(communicator::any_source, unused_tag).has_value());
+        comm.barrier();
+    });
+}
+
+TEST_CASE("IprobeUntilArrival")
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type sender = 0;
+        const mpi::id_type reciever = 1;
+        const mpi::tag_type tag = 25;
+
+        if (comm.rank() == sender) {
+            double value = 2.5;
+            comm.send(reciever, tag, value);
+        }
+        if (comm.rank() == reciever) {
+            std::optional<typename communicator::envelope> e;
+            while (!e.has_value()) {
+                e = comm.template iprobe<double>(sender, tag);
+            }
+            CHECK_EQ(e->count, 1);
+
+            double recieved{};
+            typename communicator::status status;
+            comm.recv(sender, tag, recieved, status);
+            CHECK_EQ(recieved, 2.5);
+        }
+    });
+}
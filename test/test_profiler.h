@@ -0,0 +1,190 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+// Without profiling or tracing, the scope in every call is an empty object that does nothing
+static_assert(mpi::profiler::enabled || mpi::tracer::enabled || std::is_empty_v<mpi::profiler::scope>);
+
+TEST_CASE("ProfilerHistogramBuckets")
+{
+    using namespace std::chrono_literals;
+    using stats = mpi::operation_stats;
+
+    CHECK_EQ(stats::bucket(0ns), 0u);
+    CHECK_EQ(stats::bucket(1ns), 1u);
+    CHECK_EQ(stats::bucket(1000ns), 10u);
+    CHECK_EQ(stats::bucket(1024ns), 11u);
+    CHECK_EQ(stats::bucket(1h), stats::buckets - 1);
+}
+
+TEST_CASE("ProfilerRecordsAndReports")
+{
+    using namespace std::chrono_literals;
+    auto comm = mpi::communicator::get_default();
+
+    mpi::profiler::reset();
+    mpi::profiler::record(mpi::profiled_operation::send, 0, 100, 1500ns);
+    mpi::profiler::record(mpi::profiled_operation::send, 0, 50, 3us);
+    mpi::profiler::record(mpi::profiled_operation::barrier, mpi::profiler::no_peer, 0, 10us);
+
+    const auto send = mpi::profiler::stats(mpi::profiled_operation::send);
+    CHECK_EQ(send.calls, 2u);
+    CHECK_EQ(send.bytes, 150u);
+    CHECK_EQ(send.nanoseconds, 4500u);
+    CHECK_EQ(send.histogram[mpi::operation_stats::bucket(1500ns)], 1u);
+    CHECK_EQ(send.histogram[mpi::operation_stats::bucket(3us)], 1u);
+
+    CHECK_EQ(mpi::profiler::peer(0).calls, 2u);
+    CHECK_EQ(mpi::profiler::peer(0).bytes, 150u);
+    CHECK_EQ(mpi::profiler::peer(1).calls, 0u);
+
+    const auto path = std::filesystem::temp_directory_path() / "mpicxx_profile_test.txt";
+    mpi::profiler::write_report(comm, path.string());
+    mpi::profiler::reset();
+
+    if(comm.rank() != 0) {
+        return;
+    }
+
+    std::ifstream file(path);
+    std::stringstream report;
+    report << file.rdbuf();
+    const std::string text = report.str();
+    std::filesystem::remove(path);
+
+    CHECK_NE(text.find("== All " + std::to_string(comm.size()) + " ranks =="), std::string::npos);
+    CHECK_NE(text.find("== Rank " + std::to_string(comm.size() - 1) + " =="), std::string::npos);
+    CHECK_NE(text.find("send"), std::string::npos);
+    CHECK_NE(text.find("barrier"), std::string::npos);
+    CHECK_EQ(text.find("allreduce"), std::string::npos);
+}
+
+TEST_CASE("ProfilerRecordsCalls")
+{
+    // Only the MPI backend is instrumented
+    if constexpr(mpi::profiler::enabled && mpi::mpi_enabled()) {
+        auto comm = mpi::communicator::get_default();
+        const auto rank = static_cast<std::size_t>(comm.rank());
+
+        // The size exchange and the gatherv with known counts inside gatherv fold into a single call
+        mpi::profiler::reset();
+        const std::vector<int> data(rank + 1, comm.rank());
+        std::vector<int> output;
+        comm.gatherv(0, data, output);
+
+        const auto gatherv = mpi::profiler::stats(mpi::profiled_operation::gatherv);
+        CHECK_EQ(gatherv.calls, 1u);
+        CHECK_EQ(gatherv.bytes, (rank + 1) * sizeof(int));
+        CHECK_EQ(mpi::profiler::stats(mpi::profiled_operation::gather).calls, 0u);
+        CHECK_EQ(mpi::profiler::peer(0).calls, 0u);
+
+        // Receives are counted with the rank that sent the message, and with the size of what arrived
+        mpi::profiler::reset();
+        if(comm.size() >= 2) {
+            std::vector<double> message(3, 1.0);
+            if(comm.rank() == 0) {
+                comm.send(1, 0, message);
+                comm.send(1, 0, message);
+            } else if(comm.rank() == 1) {
+                std::vector<double> recieved;
+                mpi::status status;
+                comm.recv(mpi::communicator::any_source, 0, recieved, status);
+                comm.recv(0, 0, recieved, status);
+            }
+
+            if(comm.rank() == 0) {
+                const auto send = mpi::profiler::stats(mpi::profiled_operation::send);
+                CHECK_EQ(send.calls, 2u);
+                CHECK_EQ(send.bytes, 6 * sizeof(double));
+                CHECK_EQ(mpi::profiler::peer(1).calls, 2u);
+                CHECK_EQ(mpi::profiler::peer(1).bytes, 6 * sizeof(double));
+            } else if(comm.rank() == 1) {
+                const auto recv = mpi::profiler::stats(mpi::profiled_operation::recv);
+                CHECK_EQ(recv.calls, 2u);
+                CHECK_EQ(recv.bytes, 6 * sizeof(double));
+                CHECK_EQ(mpi::profiler::peer(0).calls, 2u);
+                CHECK_EQ(mpi::profiler::peer(0).bytes, 6 * sizeof(double));
+            }
+        }
+
+        // Peers are counted by their world rank, even on a communicator that numbers the ranks the other way around
+        mpi::profiler::reset();
+        if(comm.size() >= 2) {
+            auto reversed = *comm.split(0, comm.size() - comm.rank());
+            const mpi::id_type last = comm.size() - 1;
+            int message = 7;
+            if(reversed.rank() == 0) {
+                reversed.send(1, 0, message);
+            } else if(reversed.rank() == 1) {
+                mpi::status status;
+                reversed.recv(0, 0, message, status);
+            }
+
+            if(comm.rank() == last) {
+                CHECK_EQ(mpi::profiler::peer(last - 1).calls, 1u);
+                if(last - 1 != 1) {
+                    CHECK_EQ(mpi::profiler::peer(1).calls, 0u);
+                }
+            } else if(comm.rank() == last - 1) {
+                CHECK_EQ(mpi::profiler::peer(last).calls, 1u);
+                CHECK_EQ(mpi::profiler::peer(0).calls, 0u);
+            }
+        }
+
+        // Blocking on requests and one-sided operations are recorded too
+        mpi::profiler::reset();
+        {
+            int value = comm.rank();
+            int recieved;
+            auto r_recv = comm.irecv(comm.rank(), 0, recieved);
+            auto r_send = comm.isend(comm.rank(), 0, value);
+            r_send.wait();
+            r_recv.wait();
+            CHECK_EQ(mpi::profiler::stats(mpi::profiled_operation::wait).calls, 2u);
+
+            mpi::window<int> window(comm, 1);
+            {
+                auto epoch = window.lock(comm.rank());
+                window.put(value, comm.rank(), 0);
+                window.flush(comm.rank());
+            }
+            CHECK_EQ(mpi::profiler::stats(mpi::profiled_operation::put).calls, 1u);
+            CHECK_EQ(mpi::profiler::stats(mpi::profiled_operation::put).bytes, sizeof(int));
+            CHECK_EQ(mpi::profiler::stats(mpi::profiled_operation::flush).calls, 1u);
+            CHECK_EQ(mpi::profiler::stats(mpi::profiled_operation::epoch_close).calls, 1u);
+        }
+
+        // Every start of a persistent request is recorded like the nonblocking call it repeats
+        mpi::profiler::reset();
+        {
+            const std::vector<double> message(4, 1.0);
+            std::vector<double> recieved(4);
+            std::vector<mpi::persistent_request> requests;
+            requests.push_back(comm.recv_init(comm.rank(), 0, recieved));
+            requests.push_back(comm.send_init(comm.rank(), 0, message));
+            mpi::persistent_request::start_all(requests);
+            mpi::persistent_request::wait_all(requests);
+            requests[0].start();
+            requests[1].start();
+            mpi::persistent_request::wait_all(requests);
+
+            const auto isend = mpi::profiler::stats(mpi::profiled_operation::isend);
+            const auto irecv = mpi::profiler::stats(mpi::profiled_operation::irecv);
+            CHECK_EQ(isend.calls, 2u);
+            CHECK_EQ(isend.bytes, 8 * sizeof(double));
+            CHECK_EQ(irecv.calls, 2u);
+            CHECK_EQ(irecv.bytes, 8 * sizeof(double));
+            CHECK_EQ(mpi::profiler::peer(comm.rank()).calls, 4u);
+        }
+        mpi::profiler::reset();
+    }
+}
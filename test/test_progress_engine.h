@@ -0,0 +1,156 @@
+#pragma once
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+namespace {
+
+struct queued_value {
+    queued_value* next = nullptr;
+    int producer;
+    int value;
+};
+
+}
+
+TEST_CASE("MpscQueueKeepsOrderOfEachProducer")
+{
+    constexpr int n_producers = 4;
+    constexpr int n_values = 2000;
+
+    mpi::mpsc_queue<queued_value> queue;
+    std::vector<int> last(n_producers, -1);
+    int drained = 0;
+
+    std::vector<std::thread> producers;
+    for(int p=0; p<n_producers; ++p) {
+        producers.emplace_back([&, p]() {
+            for(int v=0; v<n_values; ++v) {
+                queue.push(std::make_unique<queued_value>(queued_value{nullptr, p, v}));
+            }
+        });
+    }
+
+    while(drained < n_producers * n_values) {
+        queue.drain([&](std::unique_ptr<queued_value> node) {
+            auto& previous = last[static_cast<std::size_t>(node->producer)];
+            CHECK_EQ(node->value, previous + 1);
+            previous = node->value;
+            ++drained;
+        });
+    }
+
+    for(auto& t: producers) {
+        t.join();
+    }
+    CHECK(queue.empty());
+}
+
+TEST_CASE("ProgressEngineRequiresSerialized")
+{
+    auto comm = mpi::communicator::get_default();
+
+    if (mpi::environment::provided_threading() >= mpi::threading::serialized) {
+        return; // Skipping
+    }
+
+    CHECK_THROWS_AS(mpi::progress_engine{comm}, std::runtime_error);
+}
+
+TEST_CASE_TEMPLATE("ProgressEngineRingFromManyThreads", T, int, unsigned, char, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+
+    if (mpi::environment::provided_threading() < mpi::threading::serialized || comm.size() < 2) {
+        return; // Skipping
+    }
+
+    // Every thread exchanges a message with the same thread in the neighbouring ranks, without calling MPI itself
+    constexpr int n_threads = 4;
+    const mpi::id_type next = (comm.rank() + 1) % comm.size();
+    const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+    std::vector<T> recieved(n_threads);
+    {
+        mpi::progress_engine engine(comm);
+
+        std::vector<std::thread> threads;
+        for(int t=0; t<n_threads; ++t) {
+            threads.emplace_back([&, t]() {
+                auto r = engine.recv<T>(prev, t);
+                auto s = engine.send(next, t, static_cast<T>(comm.rank() * n_threads + t));
+                recieved[static_cast<std::size_t>(t)] = r.get();
+                s.get();
+            });
+        }
+        for(auto& t: threads) {
+            t.join();
+        }
+    }
+
+    for(int t=0; t<n_threads; ++t) {
+        CHECK_EQ(recieved[static_cast<std::size_t>(t)], static_cast<T>(prev * n_threads + t));
+    }
+}
+
+TEST_CASE("ProgressEngineCallbacks")
+{
+    auto comm = mpi::communicator::get_default();
+
+    if (mpi::environment::provided_threading() < mpi::threading::serialized || comm.size() < 2) {
+        return; // Skipping
+    }
+
+    const mpi::id_type next = (comm.rank() + 1) % comm.size();
+    const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+    // The receiver does not know the size in advance
+    const std::vector<double> sent(static_cast<std::size_t>(comm.rank() + 3), 0.5 * comm.rank());
+    std::vector<double> recieved;
+    std::atomic<int> sends = 0;
+
+    mpi::progress_engine engine(comm);
+    engine.recv<std::vector<double>>(prev, 5, [&](std::vector<double>&& data) { recieved = std::move(data); });
+    engine.send(next, 5, sent, [&]() { ++sends; });
+    engine.flush();
+
+    CHECK_EQ(sends.load(), 1);
+    CHECK_EQ(recieved, std::vector<double>(static_cast<std::size_t>(prev + 3), 0.5 * prev));
+
+    // Errors of callbacks are rethrown by flush
+    engine.send(next, 6, 1, [&]() { throw std::runtime_error("Thrown from a callback"); });
+    engine.recv<int>(prev, 6, [](int&&) { });
+    CHECK_THROWS_AS(engine.flush(), std::runtime_error);
+    CHECK_NOTHROW(engine.flush());
+}
+
+TEST_CASE("ProgressEngineReceivesMatchInPostingOrder")
+{
+    auto comm = mpi::communicator::get_default();
+
+    if (mpi::environment::provided_threading() < mpi::threading::serialized || comm.size() < 2) {
+        return; // Skipping
+    }
+
+    const mpi::id_type next = (comm.rank() + 1) % comm.size();
+    const mpi::id_type prev = (comm.rank() + comm.size() - 1) % comm.size();
+
+    // The first receive waits for its message to know its size, and the second must not take that message meanwhile
+    mpi::progress_engine engine(comm);
+    auto first = engine.recv<std::vector<int>>(prev, 7);
+    auto second = engine.recv<int>(prev, 7);
+    auto sent_first = engine.send(next, 7, std::vector<int>{1, 2, 3});
+    auto sent_second = engine.send(next, 7, 4);
+
+    CHECK_EQ(first.get(), std::vector<int>{1, 2, 3});
+    CHECK_EQ(second.get(), 4);
+    sent_first.get();
+    sent_second.get();
+}
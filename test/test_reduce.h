@@ -0,0 +1,197 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+// Sum of 0 + 1 + ... + (n-1)
+template<typename T>
+constexpr T triangular(mpi::size_type n) {
+    return static_cast<T>(n * (n - 1) / 2);
+}
+
+TEST_CASE_TEMPLATE("ReduceSumFirst", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const auto data = static_cast<T>(comm.rank());
+        T output{};
+
+        comm.reduce(root, data, output, std::plus<T>{});
+
+        if (comm.rank() == root) {
+            CHECK_EQ(output, triangular<T>(comm.size()));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("ReduceSumLast", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        const auto data = static_cast<T>(comm.rank());
+        T output{};
+
+        comm.reduce(root, data, output, std::plus<>{});
+
+        if (comm.rank() == root) {
+            CHECK_EQ(output, triangular<T>(comm.size()));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorReduceMaxFirst", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        const auto r = static_cast<T>(comm.rank());
+        const std::vector<T> data {r, static_cast<T>(2*r), static_cast<T>(3*r)};
+        std::vector<T> output{};
+
+        comm.reduce(root, data, output, mpi::max<T>{});
+
+        if (comm.rank() == root) {
+            const auto last = static_cast<T>(comm.size() - 1);
+            REQUIRE_EQ(output.size(), 3u);
+            CHECK_EQ(output[0], last);
+            CHECK_EQ(output[1], static_cast<T>(2*last));
+            CHECK_EQ(output[2], static_cast<T>(3*last));
+        } else {
+            REQUIRE(output.empty());
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("AllreduceMin", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto data = static_cast<T>(comm.rank() + 5);
+        T output{};
+
+        comm.allreduce(data, output, mpi::min<>{});
+
+        CHECK_EQ(output, static_cast<T>(5));
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorAllreduceProduct", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const std::vector<T> data {T{1}, T{2}, T{1}};
+        std::vector<T> output{};
+
+        comm.allreduce(data, output, std::multiplies<T>{});
+
+        REQUIRE_EQ(output.size(), 3u);
+        CHECK_EQ(output[0], T{1});
+        CHECK_EQ(output[1], static_cast<T>(1ull << comm.size()));
+        CHECK_EQ(output[2], T{1});
+    });
+}
+
+TEST_CASE("AllreduceLogical")
+{
+    on_every_backend([](auto comm) {
+        const bool is_root = comm.rank() == 0;
+        bool any = false;
+        bool all = false;
+
+        comm.allreduce(is_root, any, std::logical_or<>{});
+        comm.allreduce(is_root, all, std::logical_and<bool>{});
+
+        CHECK(any);
+        CHECK_EQ(all, comm.size() == 1);
+    });
+}
+
+TEST_CASE_TEMPLATE("ScanSum", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto data = static_cast<T>(comm.rank());
+        T output{};
+
+        comm.scan(data, output, std::plus<T>{});
+
+        CHECK_EQ(output, triangular<T>(comm.rank() + 1));
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorExscanSum", T, int, unsigned, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const auto r = static_cast<T>(comm.rank());
+        const std::vector<T> data {r, r};
+        std::vector<T> output{};
+
+        comm.exscan(data, output, std::plus<T>{});
+
+        REQUIRE_EQ(output.size(), 2u);
+        if (comm.rank() != 0) {
+            CHECK_EQ(output[0], triangular<T>(comm.rank()));
+            CHECK_EQ(output[1], triangular<T>(comm.rank()));
+        }
+    });
+}
+
+TEST_CASE("AllreduceUserDefined")
+{
+    on_every_backend([](auto comm) {
+        // Lambdas have no predefined equivalent, so an operation is created for them
+        auto add = [](double a, double b) { return a + b; };
+        const double data = static_cast<double>(comm.rank() * comm.rank());
+        double output = 0;
+
+        comm.allreduce(data, output, add);
+        comm.allreduce(data, output, add); // Reuses the cached operation
+
+        double expected = 0;
+        for(mpi::size_type i=0; i < comm.size(); ++i) {
+            expected += static_cast<double>(i*i);
+        }
+        CHECK_EQ(output, expected);
+    });
+}
+
+TEST_CASE("AllreduceCharUserDefined")
+{
+    on_every_backend([](auto comm) {
+        // char is not accepted by the predefined MPI_SUM, so std::plus must fall back to a user-defined operation
+        const char data = 1;
+        char output = 0;
+
+        comm.allreduce(data, output, std::plus<char>{});
+
+        CHECK_EQ(output, static_cast<char>(comm.size()));
+    });
+}
+
+TEST_CASE("ScanNonCommutative")
+{
+    on_every_backend([](auto comm) {
+        // Composition of affine maps x -> a*x + b, stored as {a, b}, is associative but not commutative.
+        // Encoding each pair into a single integer keeps the payload a ValidType.
+        constexpr long long base = 1 << 20;
+        auto compose = mpi::non_commutative{[](long long lhs, long long rhs) {
+            // Apply lhs first, then rhs
+            const long long a1 = lhs / base, b1 = lhs % base;
+            const long long a2 = rhs / base, b2 = rhs % base;
+            return (a2 * a1) * base + (a2 * b1 + b2);
+        }};
+
+        // Rank r contributes x -> 2x + r
+        const long long data = 2 * base + comm.rank();
+        long long output = 0;
+
+        comm.scan(data, output, compose);
+
+        long long expected = 1 * base + 0;
+        for(mpi::id_type r=0; r <= comm.rank(); ++r) {
+            expected = compose(expected, 2 * base + r);
+        }
+        CHECK_EQ(output, expected);
+    });
+}
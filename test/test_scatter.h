@@ -0,0 +1,84 @@
+#pragma once
+
+#include <numeric>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE_TEMPLATE("VectorSingleScatterFirst", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        std::vector<T> data{};
+        if (comm.rank() == root) {
+            data.resize(static_cast<std::size_t>(comm.size()));
+            std::iota(data.begin(), data.end(), T{0});
+        }
+        T recieved{};
+
+        comm.scatter(root, data, recieved);
+
+        CHECK_EQ(recieved, static_cast<T>(comm.rank()));
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorSingleScatterLast", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        std::vector<T> data{};
+        if (comm.rank() == root) {
+            data.resize(static_cast<std::size_t>(comm.size()));
+            std::iota(data.begin(), data.end(), T{0});
+        }
+        T recieved{};
+
+        comm.scatter(root, data, recieved);
+
+        CHECK_EQ(recieved, static_cast<T>(comm.rank()));
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorVectorScatterFirst", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        std::vector<T> data{};
+        if (comm.rank() == root) {
+            // Data looks like [0,0,0,1,1,1,2,2,2,3,3, ...]
+            for(mpi::id_type i=0; i<comm.size(); ++i) {
+                data.insert(data.end(), 3, static_cast<T>(i));
+            }
+        }
+        std::vector<T> recieved(3u);
+
+        comm.scatter(root, data, recieved);
+
+        REQUIRE_EQ(recieved.size(), 3u);
+        for(auto& r: recieved) {
+            CHECK_EQ(r, static_cast<T>(comm.rank()));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("VectorVectorScatterLast", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = comm.size() - 1;
+        std::vector<T> data{};
+        if (comm.rank() == root) {
+            data.resize(2 * static_cast<std::size_t>(comm.size()));
+            std::iota(data.begin(), data.end(), T{0});
+        }
+        std::vector<T> recieved(2u);
+
+        comm.scatter(root, data, recieved);
+
+        REQUIRE_EQ(recieved.size(), 2u);
+        CHECK_EQ(recieved[0], static_cast<T>(2*comm.rank()));
+        CHECK_EQ(recieved[1], static_cast<T>(2*comm.rank() + 1));
+    });
+}
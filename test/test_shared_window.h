@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+TEST_CASE_TEMPLATE("SharedWindowSegments", T, int, unsigned, char, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+    auto node = comm.split_shared();
+
+    mpi::shared_window<T> window(node, node.rank() + 1);
+
+    CHECK_EQ(window.size(), node.size());
+    REQUIRE_EQ(window.local().size(), static_cast<std::size_t>(node.rank() + 1));
+
+    std::fill(window.local().begin(), window.local().end(), static_cast<T>(node.rank()));
+    window.fence();
+
+    for(int r=0; r < node.size(); ++r) {
+        auto segment = window.segment(r);
+        REQUIRE_EQ(segment.size(), static_cast<std::size_t>(r + 1));
+        CHECK(std::all_of(segment.begin(), segment.end(), [r](T x){ return x == static_cast<T>(r); }));
+    }
+    window.fence();
+}
+
+TEST_CASE("SharedWindowSingleCopy")
+{
+    auto comm = mpi::communicator::get_default();
+    auto node = comm.split_shared();
+
+    // Only the node root holds the table, everybody else reads from it
+    const int n = 64;
+    mpi::shared_window<double> window(node, node.rank() == 0 ? n : 0);
+    CHECK_EQ(window.local().size(), node.rank() == 0 ? std::size_t{n} : std::size_t{0});
+
+    if(node.rank() == 0) {
+        std::iota(window.local().begin(), window.local().end(), 0.0);
+    }
+    window.fence();
+
+    auto table = window.segment(0);
+    REQUIRE_EQ(table.size(), std::size_t{n});
+    CHECK_EQ(table[0], 0.0);
+    CHECK_EQ(table[n-1], static_cast<double>(n-1));
+    window.fence();
+}
+
+TEST_CASE("SharedWindowLockAll")
+{
+    auto comm = mpi::communicator::get_default();
+    auto node = comm.split_shared();
+
+    mpi::shared_window<int> window(node, 1);
+    auto epoch = window.lock_all();
+
+    window.local()[0] = node.rank() * 10;
+    window.sync();
+    node.barrier();
+    window.sync();
+
+    const int next = (node.rank() + 1) % node.size();
+    CHECK_EQ(window.segment(next)[0], next * 10);
+}
+
+TEST_CASE("SharedWindowLock")
+{
+    auto comm = mpi::communicator::get_default();
+    auto node = comm.split_shared();
+
+    mpi::shared_window<int> window(node, 1);
+    {
+        auto epoch = window.lock(node.rank());
+        window.local()[0] = node.rank() + 1;
+    }
+    node.barrier();
+
+    auto epoch = window.lock(0);
+    CHECK_EQ(window.segment(0)[0], 1);
+    epoch.close();
+    epoch.close();
+}
+
+TEST_CASE("SharedWindowMove")
+{
+    auto comm = mpi::communicator::get_default();
+    auto node = comm.split_shared();
+
+    mpi::shared_window<int> window(node, 4);
+    auto data = window.local().data();
+
+    auto moved = std::move(window);
+    CHECK_EQ(moved.local().data(), data);
+    CHECK_EQ(moved.local().size(), std::size_t{4});
+}
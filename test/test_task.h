@@ -0,0 +1,128 @@
+#pragma once
+
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+namespace {
+
+mpi::task<int> Answer()
+{
+    co_return 42;
+}
+
+mpi::task<int> AddToAnswer(int x)
+{
+    const int answer = co_await Answer();
+    co_return answer + x;
+}
+
+mpi::task<void> Throw()
+{
+    co_await mpi::scheduler::yield();
+    throw std::runtime_error("Thrown from a task");
+}
+
+// Sends to the next rank and recieves from the previous one, with both messages in flight at once
+template<typename T>
+mpi::task<T> RingShift(mpi::communicator comm, T value, mpi::tag_type tag)
+{
+    const auto next = (comm.rank() + 1) % comm.size();
+    const auto previous = (comm.rank() + comm.size() - 1) % comm.size();
+
+    T recieved{};
+    auto r = comm.irecv(previous, tag, recieved);
+    co_await comm.isend(next, tag, value);
+    co_await r;
+    co_return recieved;
+}
+
+template<typename T>
+mpi::task<std::vector<T>> Sum(mpi::communicator comm, std::vector<T> data)
+{
+    std::vector<T> output;
+    co_await comm.iallreduce(data, output, std::plus<>{});
+    co_return output;
+}
+
+}
+
+TEST_CASE("TaskReturnsValue")
+{
+    mpi::environment::initialize();
+    mpi::scheduler scheduler;
+
+    CHECK_EQ(scheduler.run_until_complete(Answer()), 42);
+    CHECK_EQ(scheduler.run_until_complete(AddToAnswer(8)), 50);
+}
+
+TEST_CASE("TaskRethrows")
+{
+    mpi::environment::initialize();
+    mpi::scheduler scheduler;
+
+    CHECK_THROWS_AS(scheduler.run_until_complete(Throw()), std::runtime_error);
+
+    std::vector<mpi::task<void>> tasks;
+    tasks.push_back(Throw());
+    tasks.push_back(Throw());
+    CHECK_THROWS_AS(scheduler.run_until_complete(mpi::scheduler::when_all(std::move(tasks))), std::runtime_error);
+}
+
+TEST_CASE_TEMPLATE("TaskAwaitsCollective", T, int, unsigned, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+    mpi::scheduler scheduler;
+
+    const std::vector<T> data{T{1}, T{2}, T{3}};
+    const auto output = scheduler.run_until_complete(Sum(comm, data));
+
+    const auto ranks = static_cast<T>(comm.size());
+    const std::vector<T> expected{ranks, static_cast<T>(2 * ranks), static_cast<T>(3 * ranks)};
+    CHECK_EQ(output, expected);
+    CHECK_EQ(scheduler.waiting(), 0u);
+}
+
+TEST_CASE_TEMPLATE("TaskRingShift", T, int, unsigned, char, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+
+    if (comm.size() < 2) {
+        return; // Skipping
+    }
+
+    mpi::scheduler scheduler;
+    const auto previous = (comm.rank() + comm.size() - 1) % comm.size();
+
+    const T recieved = scheduler.run_until_complete(RingShift(comm, static_cast<T>(comm.rank()), 61));
+
+    CHECK_EQ(recieved, static_cast<T>(previous));
+}
+
+TEST_CASE("TaskWhenAllPipeline")
+{
+    auto comm = mpi::communicator::get_default();
+
+    if (comm.size() < 2) {
+        return; // Skipping
+    }
+
+    // Many shifts in flight at once, each on its own tag, finishing in any order
+    mpi::scheduler scheduler;
+    const int stages = 16;
+    std::vector<mpi::task<int>> tasks;
+    for(int i=0; i<stages; ++i) {
+        tasks.push_back(RingShift(comm, comm.rank() * stages + i, 100 + i));
+    }
+
+    const auto recieved = scheduler.run_until_complete(mpi::scheduler::when_all(std::move(tasks)));
+
+    const auto previous = (comm.rank() + comm.size() - 1) % comm.size();
+    REQUIRE_EQ(recieved.size(), static_cast<std::size_t>(stages));
+    for(int i=0; i<stages; ++i) {
+        CHECK_EQ(recieved[static_cast<std::size_t>(i)], previous * stages + i);
+    }
+}
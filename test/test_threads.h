@@ -0,0 +1,365 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE("ThreadsDefaultIsSingleRank")
+{
+    const auto comm = mpi::thread_communicator::get_default();
+    CHECK_EQ(comm.size(), 1);
+    CHECK_EQ(comm.rank(), 0);
+}
+
+TEST_CASE("ThreadsSendRecvRing")
+{
+    mpi::run_threads(thread_ranks, [](mpi::thread_communicator comm) {
+        CHECK_EQ(comm.size(), thread_ranks);
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type previous = (comm.rank() + comm.size() - 1) % comm.size();
+
+        comm.send(next, 3, comm.rank());
+        int received = -1;
+        mpi::thread_status status;
+        comm.recv(mpi::thread_communicator::any_source, 3, received, status);
+
+        CHECK_EQ(received, previous);
+        CHECK_EQ(status.MPI_SOURCE, previous);
+        CHECK_EQ(status.MPI_TAG, 3);
+    });
+}
+
+TEST_CASE("ThreadsMovedContainerIsHandedOver")
+{
+    std::atomic<int const*> sent = nullptr;
+    mpi::run_threads(2, [&](mpi::thread_communicator comm) {
+        mpi::thread_status status;
+        if(comm.rank() == 0) {
+            std::vector<int> data{1, 2, 3, 4};
+            sent = data.data();
+            comm.send(1, 0, std::move(data));
+            return;
+        }
+
+        std::vector<int> data;
+        comm.recv(0, 0, data, status);
+        CHECK_EQ(data, std::vector<int>{1, 2, 3, 4});
+        CHECK_EQ(data.data(), sent.load());
+        CHECK_EQ(status.count, static_cast<int>(4 * sizeof(int)));
+    });
+}
+
+TEST_CASE("ThreadsReceivesMatchInPostingOrder")
+{
+    mpi::run_threads(2, [](mpi::thread_communicator comm) {
+        if(comm.rank() == 0) {
+            comm.send(1, 5, 1);
+            comm.send(1, 5, 2);
+            const std::vector<double> data{0.5, 1.5, 2.5};
+            auto r = comm.isend(1, 6, data);
+            r.wait();
+            return;
+        }
+
+        int first = 0;
+        int second = 0;
+        mpi::thread_status status;
+        auto r = comm.irecv(0, 5, first);
+        comm.recv(0, 5, second, status);
+        r.wait();
+        CHECK_EQ(first, 1);
+        CHECK_EQ(second, 2);
+
+        const auto envelope = comm.probe<double>(mpi::thread_communicator::any_source, mpi::thread_communicator::any_tag);
+        CHECK_EQ(envelope.source, 0);
+        CHECK_EQ(envelope.tag, 6);
+        CHECK_EQ(envelope.count, 3);
+
+        std::vector<double> data;
+        comm.recv(0, 6, data, status);
+        CHECK_EQ(data, std::vector<double>{0.5, 1.5, 2.5});
+        CHECK_FALSE(comm.iprobe<double>(0, 6).has_value());
+    });
+}
+
+TEST_CASE("ThreadsPersistentRequests")
+{
+    mpi::run_threads(2, [](mpi::thread_communicator comm) {
+        std::vector<int> data(3);
+        auto r = comm.rank() == 0 ? comm.send_init(1, 2, data) : comm.recv_init(0, 2, data);
+        for(int i=0; i < 3; ++i) {
+            if(comm.rank() == 0) {
+                data.assign(3, i);
+            }
+            r.start();
+            r.wait();
+            CHECK_EQ(data, std::vector<int>(3, i));
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("ThreadsCollectives", T, int, double)
+{
+    mpi::run_threads(thread_ranks, [](mpi::thread_communicator comm) {
+        const auto n = static_cast<std::size_t>(comm.size());
+        const auto r = static_cast<T>(comm.rank());
+
+        T value = comm.rank() == 2 ? T{42} : T{};
+        comm.broadcast(2, value);
+        CHECK_EQ(value, T{42});
+
+        T sum{};
+        comm.allreduce(r, sum, std::plus<T>{});
+        CHECK_EQ(sum, static_cast<T>(n * (n - 1) / 2));
+
+        T largest{};
+        comm.reduce(comm.size() - 1, r, largest, mpi::max<T>{});
+        if(comm.rank() == comm.size() - 1) {
+            CHECK_EQ(largest, static_cast<T>(n - 1));
+        }
+
+        std::vector<T> gathered;
+        comm.gather(1, r, gathered);
+        if(comm.rank() == 1) {
+            REQUIRE_EQ(gathered.size(), n);
+            for(std::size_t i=0; i < n; ++i) {
+                CHECK_EQ(gathered[i], static_cast<T>(i));
+            }
+        }
+
+        std::vector<T> all;
+        comm.allgather(std::vector<T>{r, r}, all);
+        REQUIRE_EQ(all.size(), 2 * n);
+        CHECK_EQ(all[2 * n - 1], static_cast<T>(n - 1));
+
+        std::vector<T> chunks(2 * n);
+        for(std::size_t i=0; i < 2 * n; ++i) {
+            chunks[i] = static_cast<T>(i);
+        }
+        std::vector<T> mine(2);
+        comm.scatter(0, chunks, mine);
+        CHECK_EQ(mine[1], static_cast<T>(2 * comm.rank() + 1));
+
+        std::vector<T> exchanged;
+        comm.alltoall(std::vector<T>(n, r), exchanged);
+        REQUIRE_EQ(exchanged.size(), n);
+        for(std::size_t i=0; i < n; ++i) {
+            CHECK_EQ(exchanged[i], static_cast<T>(i));
+        }
+
+        T inclusive{};
+        T exclusive{};
+        comm.scan(r, inclusive, std::plus<T>{});
+        comm.exscan(r, exclusive, std::plus<T>{});
+        CHECK_EQ(inclusive, static_cast<T>(comm.rank() * (comm.rank() + 1) / 2));
+        CHECK_EQ(exclusive, static_cast<T>(comm.rank() * (comm.rank() - 1) / 2));
+
+        comm.barrier();
+    });
+}
+
+TEST_CASE("ThreadsNonCommutativeReductions")
+{
+    // Products of 2x2 matrices in row-major order, which depend on the order of the factors
+    using matrix = std::array<long long, 4>;
+    const auto multiply = mpi::non_commutative{[](matrix const& a, matrix const& b) {
+        return matrix{a[0] * b[0] + a[1] * b[2], a[0] * b[1] + a[1] * b[3],
+                      a[2] * b[0] + a[3] * b[2], a[2] * b[1] + a[3] * b[3]};
+    }};
+    const auto factor = [](int rank) { return matrix{1, rank + 1, rank, 1}; };
+
+    mpi::run_threads(thread_ranks, [&](mpi::thread_communicator comm) {
+        const std::vector<matrix> data{factor(comm.rank()), factor(comm.rank() + 1)};
+        std::vector<matrix> product;
+        comm.allreduce(data, product, multiply);
+
+        std::vector<matrix> prefix;
+        comm.scan(data, prefix, multiply);
+
+        matrix expected{1, 0, 0, 1};
+        for(int r=0; r < comm.size(); ++r) {
+            expected = multiply(expected, factor(r));
+            if(r == comm.rank()) {
+                REQUIRE_EQ(prefix.size(), 2u);
+                CHECK_EQ(prefix[0], expected);
+            }
+        }
+        REQUIRE_EQ(product.size(), 2u);
+        CHECK_EQ(product[0], expected);
+
+        std::vector<matrix> nonblocking;
+        comm.iallreduce(data, nonblocking, multiply).wait();
+        REQUIRE_EQ(nonblocking.size(), 2u);
+        CHECK_EQ(nonblocking[0], expected);
+    });
+}
+
+TEST_CASE("ThreadsSplitAndDup")
+{
+    mpi::run_threads(thread_ranks, [](mpi::thread_communicator comm) {
+        // Even and odd ranks, each in reverse order
+        auto half = *comm.split(comm.rank() % 2, -comm.rank());
+        CHECK(half.owning());
+        const int evens = (comm.size() + 1) / 2;
+        CHECK_EQ(half.size(), comm.rank() % 2 == 0 ? evens : comm.size() - evens);
+        CHECK_EQ(half.rank(), half.size() - 1 - comm.rank() / 2);
+
+        int sum = 0;
+        half.allreduce(comm.rank(), sum, std::plus<int>{});
+        int expected = 0;
+        for(int r=comm.rank() % 2; r < comm.size(); r += 2) {
+            expected += r;
+        }
+        CHECK_EQ(sum, expected);
+
+        // Messages on a duplicate never match those on the original
+        auto copy = comm.dup();
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+        const mpi::id_type previous = (comm.rank() + comm.size() - 1) % comm.size();
+        copy.send(next, 0, 1);
+        comm.send(next, 0, 2);
+
+        int value = 0;
+        mpi::thread_status status;
+        comm.recv(previous, 0, value, status);
+        CHECK_EQ(value, 2);
+        copy.recv(previous, 0, value, status);
+        CHECK_EQ(value, 1);
+    });
+}
+
+TEST_CASE("ThreadsVariableCollectives")
+{
+    mpi::run_threads(thread_ranks, [](mpi::thread_communicator comm) {
+        const auto n = static_cast<std::size_t>(comm.size());
+        const auto rank = static_cast<std::size_t>(comm.rank());
+        const std::vector<int> data(rank + 1, comm.rank());
+        const std::size_t total = n * (n + 1) / 2;
+
+        std::vector<int> gathered;
+        comm.gatherv(0, data, gathered);
+        if(comm.rank() == 0) {
+            REQUIRE_EQ(gathered.size(), total);
+            CHECK_EQ(gathered.back(), comm.size() - 1);
+        }
+
+        std::vector<int> all;
+        comm.allgatherv(data, all);
+        REQUIRE_EQ(all.size(), total);
+        CHECK_EQ(all[1], 1);
+        CHECK_EQ(all[total - 1], comm.size() - 1);
+
+        std::vector<int> part;
+        comm.scatterv(0, std::vector<int>(2 * n + 1, 7), part);
+        CHECK_EQ(part, std::vector<int>(comm.rank() == 0 ? 3 : 2, 7));
+
+        // Rank r sends i + 1 elements to rank i, so it recieves r + 1 elements from every rank
+        std::vector<mpi::size_type> counts(n);
+        std::vector<int> outgoing;
+        for(std::size_t i=0; i < n; ++i) {
+            counts[i] = static_cast<mpi::size_type>(i + 1);
+            outgoing.insert(outgoing.end(), i + 1, comm.rank());
+        }
+        std::vector<int> incoming;
+        comm.alltoallv(outgoing, incoming, counts);
+        REQUIRE_EQ(incoming.size(), n * (rank + 1));
+        CHECK_EQ(incoming.front(), 0);
+        CHECK_EQ(incoming.back(), comm.size() - 1);
+    });
+}
+
+TEST_CASE("ThreadsNonblockingCollectives")
+{
+    mpi::run_threads(thread_ranks, [](mpi::thread_communicator comm) {
+        const auto n = static_cast<std::size_t>(comm.size());
+
+        std::vector<double> data(3, comm.rank() == 1 ? 2.5 : 0.0);
+        std::vector<int> gathered;
+        std::vector<int> gathered_v;
+        const std::vector<int> mine(static_cast<std::size_t>(comm.rank()), comm.rank());
+        // Like with MPI, the data must outlive the requests, as it is read in place by the other ranks
+        const int rank = comm.rank();
+        int sum = 0;
+
+        std::vector<mpi::thread_request> requests;
+        requests.push_back(comm.ibarrier());
+        requests.push_back(comm.ibroadcast(1, data));
+        requests.push_back(comm.igather(0, rank, gathered));
+        requests.push_back(comm.igatherv(0, mine, gathered_v));
+        requests.push_back(comm.iallreduce(rank, sum, std::plus<int>{}));
+        mpi::thread_request::wait_all(requests);
+
+        CHECK_EQ(data, std::vector<double>(3, 2.5));
+        CHECK_EQ(sum, static_cast<int>(n * (n - 1) / 2));
+        if(comm.rank() == 0) {
+            REQUIRE_EQ(gathered.size(), n);
+            CHECK_EQ(gathered.back(), comm.size() - 1);
+            CHECK_EQ(gathered_v.size(), n * (n - 1) / 2);
+        }
+    });
+}
+
+TEST_CASE("ThreadsAggregator")
+{
+    mpi::run_threads(thread_ranks, [](mpi::thread_communicator comm) {
+        const mpi::id_type next = (comm.rank() + 1) % comm.size();
+
+        mpi::basic_aggregator<mpi::Os::Threads, false> aggregator(comm);
+        std::vector<int> arrived;
+        aggregator.on<int>(3, [&](mpi::id_type, int const& hops) {
+            arrived.push_back(hops);
+            if(hops > 0) {
+                aggregator.send(next, 3, hops - 1);
+            }
+        });
+
+        aggregator.send(next, 3, 3);
+        aggregator.finish();
+
+        CHECK_EQ(arrived, std::vector<int>{3, 2, 1, 0});
+    });
+}
+
+TEST_CASE("ThreadsFailureWakesOtherRanks")
+{
+    std::string what;
+    try {
+        mpi::run_threads(thread_ranks, [](mpi::thread_communicator comm) {
+            if(comm.rank() == 0) {
+                throw std::runtime_error("Rank 0 failed");
+            }
+            // Never sent, as rank 0 failed
+            int value;
+            mpi::thread_status status;
+            comm.recv(0, 0, value, status);
+        });
+    } catch(std::runtime_error const& e) {
+        what = e.what();
+    }
+    CHECK_EQ(what, "Rank 0 failed");
+
+    // A send still pending when its rank fails does not wait for a receiver that waits for another message
+    what.clear();
+    try {
+        mpi::run_threads(2, [](mpi::thread_communicator comm) {
+            int value = 1;
+            if(comm.rank() == 1) {
+                auto r = comm.isend(0, 0, value);
+                throw std::runtime_error("Rank 1 failed");
+            }
+            mpi::thread_status status;
+            comm.recv(1, 1, value, status);
+        });
+    } catch(std::runtime_error const& e) {
+        what = e.what();
+    }
+    CHECK_EQ(what, "Rank 1 failed");
+}
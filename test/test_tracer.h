@@ -0,0 +1,151 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+// Without tracing, a region is an empty object that does nothing
+static_assert(mpi::tracer::enabled || std::is_empty_v<mpi::trace_region>);
+
+TEST_CASE("TracerRecordsInOrder")
+{
+    using namespace std::chrono_literals;
+    const auto now = mpi::tracer::clock::now();
+
+    mpi::tracer::clear();
+    mpi::tracer::record("first", "test", now, now + 1us);
+    mpi::tracer::record("second", "test", now + 2us, now + 5us);
+    {
+        mpi::tracer::timed_region region("third");
+    }
+
+    const auto events = mpi::tracer::events();
+    REQUIRE_EQ(events.size(), 3u);
+    CHECK_EQ(std::string(events[0].name), "first");
+    CHECK_EQ(std::string(events[1].name), "second");
+    CHECK_EQ(std::string(events[2].name), "third");
+    CHECK_EQ(std::string(events[2].category), "region");
+    CHECK_EQ(events[1].end - events[1].begin, 3000);
+    CHECK_EQ(events[0].thread, events[2].thread);
+    CHECK_EQ(mpi::tracer::dropped(), 0u);
+    mpi::tracer::clear();
+}
+
+TEST_CASE("TracerOverwritesOldest")
+{
+    const auto now = mpi::tracer::clock::now();
+
+    mpi::tracer::clear();
+    mpi::tracer::record("oldest", "test", now, now);
+    for(std::size_t i=0; i < mpi::tracer::capacity; ++i) {
+        mpi::tracer::record("filler", "test", now, now);
+    }
+
+    const auto events = mpi::tracer::events();
+    CHECK_EQ(events.size(), mpi::tracer::capacity);
+    CHECK_EQ(mpi::tracer::dropped(), 1u);
+    CHECK_EQ(std::string(events.front().name), "filler");
+    mpi::tracer::clear();
+}
+
+TEST_CASE("TracerConcurrentWritersDoNotTear")
+{
+    using namespace std::chrono_literals;
+    static constexpr char const* names[] = {"t0", "t1", "t2", "t3"};
+    const auto now = mpi::tracer::clock::now();
+
+    mpi::tracer::clear();
+    std::vector<std::thread> writers;
+    for(std::size_t t=0; t < std::size(names); ++t) {
+        writers.emplace_back([t, now] {
+            for(std::size_t i=0; i < 2 * mpi::tracer::capacity; ++i) {
+                mpi::tracer::record(names[t], names[t], now, now + (t + 1) * 1us);
+            }
+        });
+    }
+    for(auto& w: writers) {
+        w.join();
+    }
+
+    const auto events = mpi::tracer::events();
+    CHECK_EQ(events.size(), mpi::tracer::capacity);
+    std::size_t torn = 0;
+    for(auto const& e: events) {
+        const auto t = static_cast<std::int64_t>(e.name[1] - '0');
+        if(e.name != e.category || e.end - e.begin != (t + 1) * 1000) {
+            ++torn;
+        }
+    }
+    CHECK_EQ(torn, 0u);
+    mpi::tracer::clear();
+}
+
+TEST_CASE("TracerWritesTrace")
+{
+    using namespace std::chrono_literals;
+    auto comm = mpi::communicator::get_default();
+    const auto now = mpi::tracer::clock::now();
+
+    mpi::tracer::clear();
+    mpi::tracer::record("compute", "region", now, now + 10us);
+
+    const auto path = std::filesystem::temp_directory_path() / "mpicxx_trace_test.json";
+    mpi::tracer::write_trace(comm, path.string());
+    mpi::tracer::clear();
+
+    if(comm.rank() != 0) {
+        return;
+    }
+
+    std::ifstream file(path);
+    std::stringstream trace;
+    trace << file.rdbuf();
+    const std::string text = trace.str();
+    std::filesystem::remove(path);
+
+    CHECK_EQ(text.rfind("{\"traceEvents\":[", 0), 0u);
+    CHECK_NE(text.find("]}"), std::string::npos);
+    for(mpi::id_type rank=0; rank < comm.size(); ++rank) {
+        const auto pid = "\"pid\":" + std::to_string(rank);
+        CHECK_NE(text.find(R"("name":"rank )" + std::to_string(rank) + '"'), std::string::npos);
+        CHECK_NE(text.find(R"({"name":"compute","cat":"region","ph":"X",)" + pid), std::string::npos);
+    }
+    CHECK_NE(text.find(R"("dur":10.000)"), std::string::npos);
+    CHECK_EQ(text.find(",,"), std::string::npos);
+}
+
+TEST_CASE("TracerEscapesNames")
+{
+    auto comm = mpi::communicator::get_default();
+    const auto now = mpi::tracer::clock::now();
+
+    mpi::tracer::clear();
+    mpi::tracer::record(R"(say "hi")", R"(C:\phase)", now, now);
+    mpi::tracer::record("tab\tnewline\n", "region", now, now);
+
+    const auto path = std::filesystem::temp_directory_path() / "mpicxx_trace_escape_test.json";
+    mpi::tracer::write_trace(comm, path.string());
+    mpi::tracer::clear();
+
+    if(comm.rank() != 0) {
+        return;
+    }
+
+    std::ifstream file(path);
+    std::stringstream trace;
+    trace << file.rdbuf();
+    const std::string text = trace.str();
+    std::filesystem::remove(path);
+
+    CHECK_NE(text.find(R"({"name":"say \"hi\"","cat":"C:\\phase",)"), std::string::npos);
+    CHECK_NE(text.find(R"({"name":"tab\u0009newline\u000a","cat":"region",)"), std::string::npos);
+    CHECK_EQ(text.find('\t'), std::string::npos);
+}
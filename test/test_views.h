@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <numeric>
+#include <span>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+#include "testutils.h"
+
+TEST_CASE_TEMPLATE("SpanSendRecv", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type sender = 0;
+        const mpi::id_type reciever = comm.size() - 1;
+        const mpi::tag_type tag = 51;
+
+        std::vector<T> data(10);
+        std::iota(data.begin(), data.end(), T{});
+
+        if (comm.rank() == sender) {
+            auto slice = std::span<const T>(data).subspan(2, 5);
+            comm.send(reciever, tag, slice);
+        }
+        if (comm.rank() == reciever) {
+            std::vector<T> recieved(7, T{});
+            auto slice = std::span<T>(recieved).subspan(1, 5);
+            typename communicator::status status;
+            comm.recv(sender, tag, slice, status);
+
+            const std::vector<T> expected{T{}, T{2}, T{3}, T{4}, T{5}, T{6}, T{}};
+            CHECK_EQ(recieved, expected);
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("StaticSpanBroadcast", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        std::array<T, 6> data{};
+        if (comm.rank() == root) {
+            std::iota(data.begin(), data.end(), T{1});
+        }
+
+        std::span<T, 4> tail(data.data() + 2, 4);
+        comm.broadcast(root, tail);
+
+        const std::array<T, 4> expected{T{3}, T{4}, T{5}, T{6}};
+        CHECK(std::equal(tail.begin(), tail.end(), expected.begin()));
+    });
+}
+
+TEST_CASE_TEMPLATE("ConstVectorSend", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type sender = 0;
+        const mpi::id_type reciever = 1;
+        const mpi::tag_type tag = 52;
+        const std::vector<T> data{T{7}, T{8}, T{9}};
+
+        if (comm.rank() == sender) {
+            comm.send(reciever, tag, data);
+        }
+        if (comm.rank() == reciever) {
+            std::vector<T> recieved;
+            typename communicator::status status;
+            comm.recv(sender, tag, recieved, status);
+            CHECK_EQ(recieved, data);
+        }
+    });
+}
+
+TEST_CASE("StridedViewIndexing")
+{
+    std::vector<int> matrix(12);
+    std::iota(matrix.begin(), matrix.end(), 0);
+
+    // 3 rows of 4 columns
+    const auto column = mpi::strided_view<int>::column(matrix, 4, 1);
+    CHECK_EQ(column.size(), 3);
+    CHECK_EQ(column[0], 1);
+    CHECK_EQ(column[1], 5);
+    CHECK_EQ(column[2], 9);
+
+    // Pairs of elements, every 5 elements
+    const mpi::strided_view<int> pairs(matrix.data(), 3, 5, 2);
+    CHECK_EQ(pairs.size(), 6);
+    CHECK_EQ(pairs[3], 6);
+    CHECK_EQ(pairs[4], 10);
+}
+
+TEST_CASE_TEMPLATE("StridedColumnSendRecv", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        using communicator = decltype(comm);
+        if (comm.size() < 2) {
+            return; // Skipping
+        }
+
+        const mpi::id_type sender = comm.size() - 1;
+        const mpi::id_type reciever = 0;
+        const mpi::tag_type tag = 53;
+        constexpr std::size_t rows = 5;
+        constexpr std::size_t cols = 3;
+
+        std::vector<T> matrix(rows * cols);
+        std::iota(matrix.begin(), matrix.end(), T{});
+
+        if (comm.rank() == sender) {
+            comm.send(reciever, tag, mpi::strided_view<const T>::column(matrix, cols, 2));
+            comm.send(reciever, tag, mpi::strided_view<const T>::column(matrix, cols, 0));
+        }
+        if (comm.rank() == reciever) {
+            typename communicator::status status;
+
+            // Into a contiguous vector: only the sequence of elements has to match
+            std::vector<T> column(rows);
+            comm.recv(sender, tag, column, status);
+            const std::vector<T> expected{T{2}, T{5}, T{8}, T{11}, T{14}};
+            CHECK_EQ(column, expected);
+
+            // Into a column of another matrix
+            std::vector<T> target(rows * cols, T{});
+            auto r = comm.irecv(sender, tag, mpi::strided_view<T>::column(target, cols, 1));
+            r.wait();
+            for (std::size_t i=0; i<rows; ++i) {
+                CHECK_EQ(target[i * cols + 1], matrix[i * cols]);
+                CHECK_EQ(target[i * cols], T{});
+            }
+        }
+    });
+}
+
+TEST_CASE_TEMPLATE("StridedBroadcast", T, int, unsigned, char, long long, float, double)
+{
+    on_every_backend([](auto comm) {
+        const mpi::id_type root = 0;
+        std::vector<T> data(12, T{});
+        if (comm.rank() == root) {
+            std::iota(data.begin(), data.end(), T{1});
+        }
+
+        // Every third element
+        comm.broadcast(root, mpi::strided_view<T>(data.data(), 4, 3));
+
+        for (std::size_t i=0; i<data.size(); ++i) {
+            const T expected = (i % 3 == 0 || comm.rank() == root) ? static_cast<T>(i + 1) : T{};
+            CHECK_EQ(data[i], expected);
+        }
+    });
+}
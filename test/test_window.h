@@ -0,0 +1,156 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+TEST_CASE_TEMPLATE("WindowPutFence", T, int, unsigned, char, long long, float, double)
+{
+    auto comm = mpi::communicator::get_default();
+
+    mpi::window<T> window(comm, 1);
+    const int next = (comm.rank() + 1) % comm.size();
+    const int previous = (comm.rank() + comm.size() - 1) % comm.size();
+
+    {
+        auto epoch = window.fence_epoch();
+        window.put(static_cast<T>(comm.rank()), next, 0);
+    }
+
+    CHECK_EQ(window.local()[0], static_cast<T>(previous));
+}
+
+TEST_CASE("WindowGetContainer")
+{
+    auto comm = mpi::communicator::get_default();
+
+    std::vector<int> exposed(4);
+    std::iota(exposed.begin(), exposed.end(), 10 * comm.rank());
+    mpi::window<int> window(comm, std::span<int>{exposed});
+
+    const int next = (comm.rank() + 1) % comm.size();
+    std::array<int, 3> recieved{};
+    {
+        auto epoch = window.fence_epoch();
+        window.get(recieved, next, 1);
+    }
+
+    std::array<int, 3> expected{10 * next + 1, 10 * next + 2, 10 * next + 3};
+    CHECK_EQ(recieved, expected);
+}
+
+TEST_CASE("WindowAccumulate")
+{
+    auto comm = mpi::communicator::get_default();
+
+    mpi::window<long long> window(comm, 2);
+    window.local()[0] = 0;
+    window.local()[1] = 0;
+    window.fence();
+
+    // Every rank adds to the memory of rank 0
+    std::vector<long long> data{comm.rank() + 1, 1};
+    window.accumulate(data, 0, 0, std::plus<>{});
+    window.fence();
+
+    if(comm.rank() == 0) {
+        CHECK_EQ(window.local()[0], static_cast<long long>(comm.size() * (comm.size() + 1) / 2));
+        CHECK_EQ(window.local()[1], static_cast<long long>(comm.size()));
+    }
+}
+
+TEST_CASE("WindowFetchAndOpCounter")
+{
+    auto comm = mpi::communicator::get_default();
+
+    mpi::window<int> window(comm, 1);
+    window.local()[0] = 0;
+    comm.barrier();
+
+    // Shared counter handing out unique tickets
+    int ticket;
+    {
+        auto lock = window.lock(0);
+        window.fetch_and_op(1, ticket, 0, 0, std::plus<>{});
+    }
+    CHECK_GE(ticket, 0);
+    CHECK_LT(ticket, comm.size());
+
+    std::vector<int> tickets(static_cast<std::size_t>(comm.size()));
+    comm.allgather(ticket, tickets);
+    std::sort(tickets.begin(), tickets.end());
+    std::vector<int> expected(tickets.size());
+    std::iota(expected.begin(), expected.end(), 0);
+    CHECK_EQ(tickets, expected);
+
+    comm.barrier();
+    if(comm.rank() == 0) {
+        auto lock = window.lock(0);
+        CHECK_EQ(window.local()[0], comm.size());
+    }
+    comm.barrier();
+}
+
+TEST_CASE("WindowCompareAndSwap")
+{
+    auto comm = mpi::communicator::get_default();
+
+    mpi::window<int> window(comm, 1);
+    window.local()[0] = -1;
+    comm.barrier();
+
+    // Only one rank wins the slot
+    int previous;
+    {
+        auto epoch = window.lock_all();
+        window.compare_and_swap(comm.rank(), -1, previous, 0, 0);
+        window.flush(0);
+    }
+
+    int winners = 0;
+    comm.allreduce(previous == -1 ? 1 : 0, winners, std::plus<int>{});
+    CHECK_EQ(winners, 1);
+    comm.barrier();
+}
+
+TEST_CASE("WindowPostStartCompleteWait")
+{
+    auto comm = mpi::communicator::get_default();
+    if (comm.size() < 2) {
+        return; // Skipping
+    }
+
+    mpi::window<double> window(comm, 1);
+    window.local()[0] = 0.0;
+    comm.barrier();
+
+    // Rank 0 exposes its memory to rank 1 only
+    if(comm.rank() == 0) {
+        const std::array<int, 1> origins{1};
+        auto exposure = window.expose(origins);
+        exposure.close();
+        CHECK_EQ(window.local()[0], 3.5);
+    } else if(comm.rank() == 1) {
+        const std::array<int, 1> targets{0};
+        auto access = window.access(targets);
+        window.put(3.5, 0, 0);
+    }
+}
+
+TEST_CASE("WindowMove")
+{
+    auto comm = mpi::communicator::get_default();
+
+    mpi::window<int> window(comm, 3);
+    auto data = window.local().data();
+
+    auto moved = std::move(window);
+    CHECK_EQ(moved.local().data(), data);
+    CHECK_EQ(moved.local().size(), std::size_t{3});
+    CHECK(window.local().empty());
+}
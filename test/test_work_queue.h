@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "doctest/doctest.h"
+#include "mpicxx/mpicxx.h"
+
+// Number of times each index was claimed, summed over all ranks
+inline std::vector<int> count_claims(mpi::communicator const& comm, std::size_t total, std::size_t chunk, mpi::claim_order order) {
+    std::vector<int> claimed(total, 0);
+    {
+        mpi::distributed_work_queue queue(comm, total, chunk, order);
+        for(auto range = queue.claim(); !range.empty(); range = queue.claim()) {
+            CHECK_LE(range.size(), chunk);
+            for(auto i: range) {
+                claimed[i] += 1;
+            }
+        }
+    }
+
+    std::vector<int> total_claims(total);
+    comm.allreduce(claimed, total_claims, std::plus<int>{});
+    return total_claims;
+}
+
+TEST_CASE("WorkQueueGlobal")
+{
+    auto comm = mpi::communicator::get_default();
+
+    for(std::size_t chunk: {1u, 3u, 16u}) {
+        auto claims = count_claims(comm, 100, chunk, mpi::claim_order::global);
+        CHECK(std::all_of(claims.begin(), claims.end(), [](int c){ return c == 1; }));
+    }
+}
+
+TEST_CASE("WorkQueueLocalFirst")
+{
+    auto comm = mpi::communicator::get_default();
+
+    for(std::size_t chunk: {1u, 3u, 16u}) {
+        auto claims = count_claims(comm, 100, chunk, mpi::claim_order::local_first);
+        CHECK(std::all_of(claims.begin(), claims.end(), [](int c){ return c == 1; }));
+    }
+}
+
+TEST_CASE("WorkQueueFewerIndicesThanRanks")
+{
+    auto comm = mpi::communicator::get_default();
+
+    for(auto order: {mpi::claim_order::global, mpi::claim_order::local_first}) {
+        auto claims = count_claims(comm, 1, 4, order);
+        CHECK_EQ(claims.size(), std::size_t{1});
+        CHECK_EQ(claims[0], 1);
+    }
+}
+
+TEST_CASE("WorkQueueEmpty")
+{
+    auto comm = mpi::communicator::get_default();
+
+    for(auto order: {mpi::claim_order::global, mpi::claim_order::local_first}) {
+        mpi::distributed_work_queue queue(comm, 0, 8, order);
+        CHECK(queue.claim().empty());
+        CHECK(queue.claim().empty());
+    }
+}
+
+TEST_CASE("WorkQueueLocalFirstStartsWithOwnBlock")
+{
+    auto comm = mpi::communicator::get_default();
+
+    const std::size_t total = 40;
+    mpi::distributed_work_queue queue(comm, total, 2, mpi::claim_order::local_first);
+    auto first = queue.claim();
+
+    // Other ranks only steal from the back, so whatever the owner claims from its own block starts at the front
+    const auto rank = static_cast<std::size_t>(comm.rank());
+    const auto ranks = static_cast<std::size_t>(comm.size());
+    const auto begin = total * rank / ranks;
+    const auto end = total * (rank + 1) / ranks;
+    if(!first.empty() && first.front() >= begin && first.front() < end) {
+        CHECK_EQ(first.front(), begin);
+    }
+
+    // Drain the queue, so that every rank leaves the collective destructor together
+    while(!queue.claim().empty()) { }
+}
+
+TEST_CASE("WorkQueueRejectsInvalidArguments")
+{
+    auto comm = mpi::communicator::get_default();
+
+    // Both checks happen before the collective construction of the window, on every rank
+    CHECK_THROWS_AS(mpi::distributed_work_queue(comm, 100, 0), std::invalid_argument);
+
+    const std::size_t too_many = std::size_t{1} << 32;
+    CHECK_THROWS_AS(mpi::distributed_work_queue(comm, too_many, 8, mpi::claim_order::local_first), std::overflow_error);
+}
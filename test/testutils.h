@@ -41,3 +41,14 @@ void wait_until(Predicate condition, std::chrono::milliseconds sleepytime) {
         std::this_thread::sleep_for(sleepytime);
     }
 }
+
+// Ranks of the thread backend in the tests: enough for trees with more than one level, and not a power of two
+constexpr int thread_ranks = 5;
+
+// Runs the test on the default communicator, and then on every rank of the thread backend, so that even builds
+// without MPI cover several ranks. The test takes the communicator as an auto parameter.
+template<typename Test>
+void on_every_backend(Test test) {
+    test(mpi::communicator::get_default());
+    mpi::run_threads(thread_ranks, test);
+}